@@ -25,6 +25,10 @@
 #define SSD1306_MEMORYMODE			0x20
 #define SSD1306_COLUMNADDR			0x21
 #define SSD1306_PAGEADDR			0x22
+#define SSD1306_RIGHT_HORIZONTAL_SCROLL	0x26
+#define SSD1306_LEFT_HORIZONTAL_SCROLL	0x27
+#define SSD1306_DEACTIVATE_SCROLL	0x2E
+#define SSD1306_ACTIVATE_SCROLL		0x2F
 #define SSD1306_SETSTARTLINE		0x40
 #define SSD1306_DEFAULT_ADDRESS		0x78
 #define SSD1306_SETCONTRAST			0x81
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "adc_capture.h"
+
+#include <adc.h>
+#include <pdc.h>
+#include <pio.h>
+#include <pmc.h>
+#include <sysclk.h>
+#include <tc.h>
+
+/* Timer counter channel pacing the conversions
+ * (TC0 channel 0 is already taken by the LED blinking routines) */
+#define ADCC_TC             TC0
+#define ADCC_TC_CHANNEL     1
+#define ADCC_TC_ID          ID_TC1
+#define ADCC_TRIGGER        ADC_TRIG_TIO_CH_1
+
+/* Timer counter channel timestamping the trigger signal edges
+ * in the equivalent-time sampling mode */
+#define ADCC_ETS_CHANNEL    2
+#define ADCC_ETS_ID         ID_TC2
+
+/** Pointer to PDC register base. */
+static Pdc *p_pdc;
+
+static volatile int busy = 0;
+
+static int dummy_handler(int buf) { return 1; }
+
+static int (*finish_handler)(int) = dummy_handler;
+static uint32_t adcc_rate;
+
+static adcc_buffer_t *adcc_buffers;
+static int adcc_buffers_cnt;
+
+static volatile int adcc_buffer_idx;
+static volatile int adcc_buffer_current;
+
+static int ets_enabled;
+static uint32_t ets_period;
+
+
+static void adcc_setup_adc(uint32_t mck, const enum adc_channel_num_t *channels,
+        int count)
+{
+    adcc_stop();
+
+    pmc_enable_periph_clk(ID_ADC);
+    pmc_enable_periph_clk(ADCC_TC_ID);
+    pio_configure(PIOA, PIO_INPUT, (PIO_PA20X1_AD3 | PIO_PA22X1_AD9), PIO_DEFAULT);
+    p_pdc = adc_get_pdc_base(ADC);
+
+    adc_disable_interrupt(ADC, 0xFFFFFFFF);
+    adc_disable_all_channel(ADC);
+
+    adc_init(ADC, mck, ADCC_ADC_CLOCK, ADC_STARTUP_TIME_4);
+
+    /* Formula:
+     *     Transfer Time = (TRANSFER * 2 + 3) / ADCClock
+     *     Tracking Time = (TRACKTIM + 1) / ADCClock
+     *     Settling Time = settling value / ADCClock
+     */
+    adc_configure_timing(ADC, TRACKING_TIME, ADC_SETTLING_TIME_3, TRANSFER_PERIOD);
+
+#ifdef ADCC_TAGS
+    /* Enable channel number tag. */
+    adc_enable_tag(ADC);
+#else
+    adc_disable_tag(ADC);
+#endif
+
+    if (count == 1) {
+        adc_stop_sequencer(ADC);
+        adc_enable_channel(ADC, channels[0]);
+    } else {
+        /* The user sequence converts the channels in the requested order,
+         * channel enable bits select the sequence slots */
+        ADC->ADC_SEQR1 = 0;
+        adc_configure_sequence(ADC, channels, count);
+        adc_start_sequencer(ADC);
+
+        for (int i = 0; i < count; ++i) {
+            adc_enable_channel(ADC, (enum adc_channel_num_t) i);
+        }
+    }
+
+    /* Each rising edge of TIOA starts conversion of all enabled channels */
+    adc_configure_trigger(ADC, ADCC_TRIGGER, 0);
+}
+
+
+int adcc_configure(const enum adc_channel_num_t *channels, int count,
+        uint32_t freq)
+{
+    uint32_t mck = sysclk_get_peripheral_hz();
+    uint32_t div, tcclks, rc;
+
+    if (count < 1 || freq == 0 || freq * count > ADCC_MAX_RATE)
+        return 0;
+
+    if (!tc_find_mck_divisor(freq, mck, &div, &tcclks, mck))
+        return 0;
+
+    adcc_setup_adc(mck, channels, count);
+    ets_enabled = 0;
+
+    /* TIOA goes high on RC compare and low on RA compare */
+    rc = (mck / div) / freq;
+    tc_stop(ADCC_TC, ADCC_TC_CHANNEL);
+    tc_init(ADCC_TC, ADCC_TC_CHANNEL, tcclks | TC_CMR_WAVE | TC_CMR_WAVSEL_UP_RC
+            | TC_CMR_ACPA_CLEAR | TC_CMR_ACPC_SET);
+    tc_write_ra(ADCC_TC, ADCC_TC_CHANNEL, rc / 2);
+    tc_write_rc(ADCC_TC, ADCC_TC_CHANNEL, rc);
+    adcc_rate = (mck / div) / rc;
+
+    NVIC_EnableIRQ(ADC_IRQn);
+
+    return 1;
+}
+
+
+int adcc_configure_ets(enum adc_channel_num_t channel, uint32_t freq)
+{
+    uint32_t clock = adcc_get_ets_clock();
+
+    if (freq == 0 || freq > ADCC_MAX_RATE)
+        return 0;
+
+    /* the channel may be pacing the DAC waveform generator */
+    if (tc_get_status(ADCC_TC, ADCC_ETS_CHANNEL) & TC_SR_CLKSTA)
+        return 0;
+
+    adcc_setup_adc(sysclk_get_peripheral_hz(), &channel, 1);
+    ets_enabled = 1;
+
+    /* Both channels count TIMER_CLOCK1 ticks and are reset together by
+     * the SYNC command, so they share the time base */
+    ets_period = clock / freq;
+    tc_stop(ADCC_TC, ADCC_TC_CHANNEL);
+    tc_init(ADCC_TC, ADCC_TC_CHANNEL, TC_CMR_TCCLKS_TIMER_CLOCK1 | TC_CMR_WAVE
+            | TC_CMR_WAVSEL_UP_RC | TC_CMR_ACPA_SET | TC_CMR_ACPC_CLEAR);
+    tc_write_rc(ADCC_TC, ADCC_TC_CHANNEL, ets_period);
+    adcc_rate = clock / ets_period;
+
+    /* The trigger input latches two consecutive rising edges */
+    pmc_enable_periph_clk(ADCC_ETS_ID);
+    pio_configure(PIOA, PIO_PERIPH_B, PIO_PA26B_TIOA2, PIO_DEFAULT);
+    tc_stop(ADCC_TC, ADCC_ETS_CHANNEL);
+    tc_init(ADCC_TC, ADCC_ETS_CHANNEL, TC_CMR_TCCLKS_TIMER_CLOCK1
+            | TC_CMR_LDRA_RISING | TC_CMR_LDRB_RISING);
+
+    NVIC_EnableIRQ(ADC_IRQn);
+
+    return 1;
+}
+
+
+uint32_t adcc_get_ets_clock(void)
+{
+    return sysclk_get_peripheral_hz() / 2;
+}
+
+
+uint32_t adcc_get_ets_period(void)
+{
+    return ets_period;
+}
+
+
+uint32_t adcc_start_ets(adcc_buffer_t *buffer, uint32_t phase)
+{
+    /* TIOA rises on RA compare, it has to stay within the period */
+    phase = phase % (ets_period - 1) + 1;
+    tc_write_ra(ADCC_TC, ADCC_TC_CHANNEL, phase);
+
+    /* Clear the RA/RB loading flags */
+    tc_get_status(ADCC_TC, ADCC_ETS_CHANNEL);
+
+    adcc_start(buffer, 1);
+
+    return phase;
+}
+
+
+int adcc_get_ets_edges(uint32_t *edge, uint32_t *period)
+{
+    uint32_t status = tc_get_status(ADCC_TC, ADCC_ETS_CHANNEL);
+    uint32_t ra, rb;
+
+    if (!(status & TC_SR_LDRBS))
+        return 0;
+
+    ra = tc_read_ra(ADCC_TC, ADCC_ETS_CHANNEL);
+    rb = tc_read_rb(ADCC_TC, ADCC_ETS_CHANNEL);
+
+    /* the counter is 16-bit */
+    *edge = ra;
+    *period = (rb - ra) & 0xffff;
+
+    return *period != 0;
+}
+
+
+uint32_t adcc_get_rate(void)
+{
+    return adcc_rate;
+}
+
+
+static inline int adcc_set_next_buffer(void) {
+    /* save the index of the currently acquired buffer */
+    adcc_buffer_current = adcc_buffer_idx;
+
+    if (adcc_buffers[adcc_buffer_idx].last) {
+        /* the last buffer has already been requested, stop here */
+        return 0;
+    }
+
+    /* move to the next buffer, wrap the index if needed */
+    if (++adcc_buffer_idx >= adcc_buffers_cnt) {
+        adcc_buffer_idx = 0;
+    }
+
+    /* set the next buffer */
+    p_pdc->PERIPH_RNPR = (uint32_t) adcc_buffers[adcc_buffer_idx].addr;
+    p_pdc->PERIPH_RNCR = adcc_buffers[adcc_buffer_idx].size;
+
+    return 1;
+}
+
+
+void adcc_start(adcc_buffer_t *buffers, int count)
+{
+    uint32_t irqs = ADC_IER_RXBUFF;
+
+    busy = 1;
+    adcc_buffer_idx = 0;
+    adcc_buffers = buffers;
+    adcc_buffers_cnt = count;
+
+    /* Drop a stale conversion result, if any */
+    adc_get_latest_value(ADC);
+
+    /* Set up PDC receive buffer */
+    p_pdc->PERIPH_RPR = (uint32_t) adcc_buffers[0].addr;
+    p_pdc->PERIPH_RCR = adcc_buffers[0].size;
+
+    if (adcc_set_next_buffer()) {
+        irqs |= ADC_IER_ENDRX;
+    }
+
+    adc_enable_interrupt(ADC, irqs);
+
+    /* Enable PDC transfer. */
+    pdc_enable_transfer(p_pdc, PERIPH_PTCR_RXTEN);
+
+    /* Start the sampling clock */
+    if (ets_enabled) {
+        /* Reset the counters at once, so the sample and edge timestamps
+         * are counted from the same instant (it restarts the LED blinking
+         * period too, which is not noticeable) */
+        ADCC_TC->TC_CHANNEL[ADCC_TC_CHANNEL].TC_CCR = TC_CCR_CLKEN;
+        ADCC_TC->TC_CHANNEL[ADCC_ETS_CHANNEL].TC_CCR = TC_CCR_CLKEN;
+        tc_sync_trigger(ADCC_TC);
+    } else {
+        tc_start(ADCC_TC, ADCC_TC_CHANNEL);
+    }
+}
+
+
+void adcc_stop(void)
+{
+    tc_stop(ADCC_TC, ADCC_TC_CHANNEL);
+
+    if (ets_enabled) {
+        tc_stop(ADCC_TC, ADCC_ETS_CHANNEL);
+    }
+
+    adc_disable_interrupt(ADC, ADC_IDR_ENDRX | ADC_IDR_RXBUFF);
+
+    if (p_pdc) {
+        pdc_disable_transfer(p_pdc, PERIPH_PTCR_RXTDIS);
+    }
+
+    busy = 0;
+}
+
+
+int adcc_busy(void)
+{
+    return busy;
+}
+
+
+void adcc_set_handler(int (*func)(int))
+{
+    finish_handler = func;
+}
+
+
+/**
+ * \brief Interrupt handler for the ADC.
+ */
+void ADC_Handler(void)
+{
+    uint32_t status = adc_get_status(ADC) & adc_get_interrupt_mask(ADC);
+    int cur_buf = adcc_buffer_current;
+    int finished = 0;
+
+    if (status & ADC_ISR_ENDRX) {
+        /* PDC has switched to the next buffer, queue another one */
+        if (!adcc_set_next_buffer()) {
+            /* the last buffer is being filled, wait for RXBUFF */
+            adc_disable_interrupt(ADC, ADC_IDR_ENDRX);
+        }
+
+        finished = (*finish_handler)(cur_buf);
+
+    } else if (status & ADC_ISR_RXBUFF) {
+        /* RXBUFF is set when there are no more buffers configured */
+        (*finish_handler)(cur_buf);
+        finished = 1;
+    }
+
+    if (finished) {
+        adcc_stop();
+    }
+}
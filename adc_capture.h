@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef ADC_CAPTURE_H
+#define ADC_CAPTURE_H
+
+#include <stdint.h>
+#include <adc.h>
+
+/** Tracking Time*/
+#define TRACKING_TIME           1
+/** Transfer Period */
+#define TRANSFER_PERIOD         1
+
+/** ADC clock, one conversion takes 20 ADC clock periods */
+#define ADCC_ADC_CLOCK          20000000
+/** Maximum number of conversions per second (all channels together) */
+#define ADCC_MAX_RATE           (ADCC_ADC_CLOCK / 20)
+
+/* Samples are tagged with the channel number only in debug builds, otherwise
+ * the acquisition order is the only source of the channel information */
+#ifdef _ASSERT_ENABLE_
+#define ADCC_TAGS
+#endif
+
+#ifdef ADCC_TAGS
+/** Strips the channel tag from a sample */
+#define ADCC_DATA(sample)       ((sample) & ADC_LCDR_LDATA_Msk)
+/** Strips the channel tags from a pair of samples */
+#define ADCC_DATA2(word)        ((word) & 0x0fff0fff)
+#else
+#define ADCC_DATA(sample)       (sample)
+#define ADCC_DATA2(word)        (word)
+#endif
+
+/* Structure to define an acquisition buffer */
+typedef struct {
+    uint16_t *addr; ///< Buffer address
+    uint16_t size;  ///< Buffer size (samples)
+    int last;       ///< Will stop acquisition after this buffer when enabled
+} adcc_buffer_t;
+
+/**
+ * Configures the ADC channels and the timer pacing the conversions.
+ *
+ * Every timer tick converts all enabled channels in the order given by
+ * the channels array, so the acquired samples are interleaved.
+ * @param channels is an array of channels to be converted.
+ * @param count is the number of channels.
+ * @param freq is the requested sampling frequency (per channel) [Hz].
+ * @return 1 on success, 0 if the requested configuration is not achievable.
+ */
+int adcc_configure(const enum adc_channel_num_t *channels, int count,
+        uint32_t freq);
+
+/**
+ * Returns the actual sampling frequency (per channel) [Hz].
+ */
+uint32_t adcc_get_rate(void);
+
+/**
+ * Configures a single channel for equivalent-time sampling.
+ *
+ * Conversions are paced like in the regular mode, but their phase is
+ * adjustable in timer ticks (see adcc_start_ets()). Rising edges of the
+ * trigger signal connected to PA26 (TIOA2) are timestamped using the same
+ * time base, so every sample can be placed relative to the signal period.
+ * @param channel is the converted channel.
+ * @param freq is the requested sampling frequency [Hz].
+ * @return 1 on success, 0 if the requested configuration is not achievable.
+ */
+int adcc_configure_ets(enum adc_channel_num_t channel, uint32_t freq);
+
+/**
+ * Returns the frequency of the equivalent-time sampling time base [Hz].
+ */
+uint32_t adcc_get_ets_clock(void);
+
+/**
+ * Returns the sampling period in the equivalent-time sampling mode [ticks].
+ */
+uint32_t adcc_get_ets_period(void);
+
+/**
+ * Starts a single buffer equivalent-time acquisition.
+ *
+ * Sample n is converted at (phase + n * period) ticks.
+ * @param buffer is the acquisition buffer.
+ * @param phase is the requested delay of the first sample [ticks].
+ * @return the applied delay (1 to period - 1) [ticks].
+ */
+uint32_t adcc_start_ets(adcc_buffer_t *buffer, uint32_t phase);
+
+/**
+ * Reads the trigger signal timestamps after an equivalent-time acquisition.
+ * @param edge is the time of the first rising edge [ticks].
+ * @param period is the time between the first two rising edges [ticks].
+ * @return 1 if two edges have been captured, 0 otherwise.
+ */
+int adcc_get_ets_edges(uint32_t *edge, uint32_t *period);
+
+/**
+ * Starts the acquisition.
+ *
+ * Buffers will be switched in a circular mode (PDC ping-pong) until one of
+ * them has 'last' field set to 1.
+ * @param buffers is an array of acquisition buffers.
+ * @param count is the array size (number of acquisition buffers)
+ */
+void adcc_start(adcc_buffer_t *buffers, int count);
+
+/**
+ * Unconditionally stops the acquisition.
+ */
+void adcc_stop(void);
+
+/**
+ * Returns 1 when acquisition is in progress, 0 otherwise.
+ */
+int adcc_busy(void);
+
+/**
+ * Sets a handler which will be called (in the interrupt context) every time
+ * a buffer is acquired. The handler will be called with the acquired buffer
+ * index. It should return 1 when the acquisition is finished.
+ */
+void adcc_set_handler(int (*func)(int));
+
+#endif /* ADC_CAPTURE_H */
@@ -24,6 +24,8 @@
 void app_la_usb_func(void);
 void app_la_lcd_func(void);
 void app_scope_func(void);
+void app_mixed_func(void);
+void app_siggen_func(void);
 void app_command_func(void);
 void app_uart_func(void);
 
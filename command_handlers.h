@@ -32,6 +32,8 @@ void cmd_resp_init(cmd_resp_t status);
 /* Writes data to the response buffer */
 void cmd_resp_write(uint8_t data);
 void cmd_resp_writen(const uint8_t *data, unsigned int len);
+/* Writes a 32-bit value (big endian, as the command parameters) */
+void cmd_resp_write_u32(uint32_t data);
 
 /* Logic analyzer SUMP protocol handler */
 int cmd_sump(const uint8_t* cmd, unsigned int len);
@@ -42,7 +44,7 @@ void cmd_spi(const uint8_t* data_in, unsigned int input_len);
 void cmd_led(const uint8_t* data_in, unsigned int input_len);
 void cmd_lcd(const uint8_t* data_in, unsigned int input_len);
 void cmd_btn(const uint8_t* data_in, unsigned int input_len);
-/*void cmd_adc(const uint8_t* data_in, unsigned int input_len);*/
-/*void cmd_dac(const uint8_t* data_in, unsigned int input_len);*/
+void cmd_adc(const uint8_t* data_in, unsigned int input_len);
+void cmd_dac(const uint8_t* data_in, unsigned int input_len);
 
 #endif /* COMMAND_HANDLERS_H */
@@ -43,6 +43,9 @@ static uint8_t cmd_resp_buf[CMD_BUF_SIZE];
 static const uint8_t *cmd_resp = NULL;
 static uint8_t cmd_resp_len = 0;
 
+// Display mirroring updates
+static uint8_t cmd_lcd_span_buf[LCD_WIDTH + 6];
+
 void cmd_new_data(uint8_t data)
 {
     cmd_buf[cmd_buf_idx] = data;
@@ -83,6 +86,15 @@ void cmd_resp_writen(const uint8_t *data, unsigned int len)
 }
 
 
+void cmd_resp_write_u32(uint32_t data)
+{
+    cmd_resp_write(data >> 24);
+    cmd_resp_write(data >> 16);
+    cmd_resp_write(data >> 8);
+    cmd_resp_write(data);
+}
+
+
 static inline void cmd_buf_reset(void)
 {
     cmd_overflow = 0;
@@ -170,6 +182,14 @@ static int cmd_execute_normal(void)
                     cmd_lcd(&cmd_buf[2], cmd_len - 1);
                     break;
 
+                case CMD_TYPE_ADC:
+                    cmd_adc(&cmd_buf[2], cmd_len - 1);
+                    break;
+
+                case CMD_TYPE_DAC:
+                    cmd_dac(&cmd_buf[2], cmd_len - 1);
+                    break;
+
                 default:
                     cmd_resp_init(CMD_RESP_INVALID_CMD);
                     break;
@@ -234,6 +254,26 @@ cmd_mode_t cmd_get_mode(void)
 }
 
 
+/* Sends the display updates pending since the previous response
+ * (CMD_LCD_MIRROR), so they never interrupt streamed data */
+static void cmd_send_lcd_spans(void)
+{
+    const uint8_t *data;
+    uint8_t page, x;
+    int len;
+
+    while ((len = SSD1306_getMirrorSpan(&page, &x, &data)) > 0) {
+        cmd_lcd_span_buf[0] = len + 3;    /* response length */
+        cmd_lcd_span_buf[1] = CMD_RESP_LCD_SPAN;
+        cmd_lcd_span_buf[2] = page;
+        cmd_lcd_span_buf[3] = x;
+        memcpy(&cmd_lcd_span_buf[4], data, len);
+        cmd_lcd_span_buf[len + 4] = cmd_crc(&cmd_lcd_span_buf[1], len + 3);
+        udi_cdc_write_buf(cmd_lcd_span_buf, len + 5);
+    }
+}
+
+
 void app_command_func(void)
 {
     const uint8_t *resp;
@@ -242,7 +282,6 @@ void app_command_func(void)
 
     cmd_set_mode(CMD_MULTIPROTOCOL);
 
-    while(SSD1306_isBusy());
     SSD1306_clearBufferFull();
     SSD1306_setString(10, 3, "Command interface", 17, WHITE);
     SSD1306_drawBufferDMA();
@@ -256,6 +295,7 @@ void app_command_func(void)
                 cmd_get_resp(&resp, &resp_len);
 
                 if(resp && resp_len > 0) {
+                    cmd_send_lcd_spans();
                     udi_cdc_write_buf(resp, resp_len);
                     cmd_resp_processed();
                 }
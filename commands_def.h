@@ -30,6 +30,8 @@ DEF_ENUM(CMD_RESP_INVALID_CMD,  3)  /* invalid command */
 DEF_ENUM(CMD_RESP_OVERFLOW,     4)  /* command buffer overflown */
 DEF_ENUM(CMD_RESP_CRC_ERR,      5)  /* incorrect CRC */
 DEF_ENUM(CMD_RESP_EXEC_ERR,     6)  /* valid command, execution error */
+DEF_ENUM(CMD_RESP_LCD_SPAN,     7)  /* display mirroring update preceding a response,
+                                       data: page, x, span contents */
 END_ENUM(cmd_resp_t)
 
 START_ENUM(cmd_led_t)
@@ -53,4 +55,63 @@ DEF_ENUM(CMD_LCD_CLEAR,         0)
 DEF_ENUM(CMD_LCD_REFRESH,       1)
 DEF_ENUM(CMD_LCD_PIXEL,         2)  /* params: x, y, color */
 DEF_ENUM(CMD_LCD_TEXT,          3)  /* params: row, col, byte count, text */
+DEF_ENUM(CMD_LCD_BLIT,          4)  /* params: x, page, width, encoding flags, data (pages of
+                                       column bytes filling the area, top page first) */
+DEF_ENUM(CMD_LCD_READ,          5)  /* params: page; returns the page contents (128 bytes) */
+DEF_ENUM(CMD_LCD_MIRROR,        6)  /* params: mirroring mode; see CMD_RESP_LCD_SPAN */
+DEF_ENUM(CMD_LCD_STATS,         7)  /* params: flags; returns the frame statistics: transferred frames (4 bytes),
+                                       frame rate (4 bytes; [fps]), min/avg/max (4 bytes each) of the draw,
+                                       queue and transfer times [us] and transferred bytes */
 END_ENUM(cmd_lcd_t)
+
+START_ENUM(cmd_lcd_mirror_t)
+DEF_ENUM(CMD_LCD_MIRROR_OFF,    0)
+DEF_ENUM(CMD_LCD_MIRROR_SPANS,  1)  /* modified spans of the presented frames */
+DEF_ENUM(CMD_LCD_MIRROR_FRAMES, 2)  /* whole presented frames */
+END_ENUM(cmd_lcd_mirror_t)
+
+START_ENUM(cmd_lcd_stats_t)
+DEF_ENUM(CMD_LCD_STATS_RESET,   1)  /* clears the statistics after reading */
+DEF_ENUM(CMD_LCD_STATS_OVERLAY, 2)  /* shows the frame rate on the display, cleared hides it */
+END_ENUM(cmd_lcd_stats_t)
+
+START_ENUM(cmd_lcd_blit_t)
+DEF_ENUM(CMD_LCD_BLIT_RAW,      0)  /* plain data */
+DEF_ENUM(CMD_LCD_BLIT_RLE,      1)  /* RLE compressed data (see scripts/gfx_convert.py) */
+DEF_ENUM(CMD_LCD_BLIT_DELTA,    2)  /* data is XORed with the buffer contents */
+DEF_ENUM(CMD_LCD_BLIT_REFRESH,  4)  /* redraws the display afterwards */
+END_ENUM(cmd_lcd_blit_t)
+
+START_ENUM(cmd_adc_t)
+DEF_ENUM(CMD_ADC_STREAM,        0)  /* params: channel mask, sampling frequency (4 bytes; [Hz]) */
+DEF_ENUM(CMD_ADC_MEASURE,       1)  /* params: channel mask, sampling frequency (4 bytes; [Hz]) */
+DEF_ENUM(CMD_ADC_MIXED,         2)  /* params: channel mask, logic inputs sampling frequency (4 bytes; [Hz]),
+                                       trigger source, trigger mask, trigger value, trigger level (2 bytes), rising edge */
+DEF_ENUM(CMD_ADC_READ,          3)  /* params: channel mask, sampling frequency (4 bytes; [Hz]), samples per channel (4 bytes) */
+DEF_ENUM(CMD_ADC_OVERSAMPLE,    4)  /* params: channel mask, output sampling frequency (4 bytes; [Hz]),
+                                       extra resolution bits (1-4), samples per channel (4 bytes) */
+END_ENUM(cmd_adc_t)
+
+START_ENUM(cmd_adc_trig_t)
+DEF_ENUM(CMD_ADC_TRIG_NONE,     0)  /* free running */
+DEF_ENUM(CMD_ADC_TRIG_DIGITAL,  1)  /* logic inputs (mask & state == value) */
+DEF_ENUM(CMD_ADC_TRIG_ANALOG,   2)  /* the first ADC channel crossing the level */
+END_ENUM(cmd_adc_trig_t)
+
+START_ENUM(cmd_dac_t)
+DEF_ENUM(CMD_DAC_START,         0)  /* params: waveform, frequency (4 bytes; [Hz]), amplitude (2 bytes; peak-to-peak [DAC codes]),
+                                       offset (2 bytes; [DAC codes]), burst cycles (2 bytes; 0 = continuous),
+                                       idle cycles between bursts (2 bytes; 0 = single burst) */
+DEF_ENUM(CMD_DAC_SWEEP,         1)  /* params: waveform, start frequency (4 bytes; [Hz]), stop frequency (4 bytes; [Hz]),
+                                       duration (4 bytes; [ms]), amplitude (2 bytes), offset (2 bytes) */
+DEF_ENUM(CMD_DAC_STOP,          2)
+DEF_ENUM(CMD_DAC_LOAD,          3)  /* params: first sample index (2 bytes), waveform size (2 bytes),
+                                       samples (2 bytes each; signed, full scale = 32767) */
+END_ENUM(cmd_dac_t)
+
+START_ENUM(cmd_dac_wave_t)
+DEF_ENUM(CMD_DAC_SINE,          0)
+DEF_ENUM(CMD_DAC_SQUARE,        1)
+DEF_ENUM(CMD_DAC_TRIANGLE,      2)
+DEF_ENUM(CMD_DAC_ARBITRARY,     3)  /* uploaded with CMD_DAC_LOAD */
+END_ENUM(cmd_dac_wave_t)
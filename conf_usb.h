@@ -97,7 +97,8 @@
 
 //! Define it when the transfer CDC Device to Host is a low rate (<512000 bauds)
 //! to reduce CDC buffers size
-#define  UDI_CDC_LOW_RATE
+//! (disabled, ADC streaming needs the full USB bandwidth)
+// #define  UDI_CDC_LOW_RATE
 
 //! Default configuration of communication port
 #define  UDI_CDC_DEFAULT_RATE             115200
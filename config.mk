@@ -56,11 +56,20 @@ CSRCS = \
        buttons.c \
        commands.c \
        io_capture.c \
+       adc_capture.c \
        logic_analyzer.c \
+       mixed_signal.c \
+       dac_gen.c \
+       siggen.c \
        usb_handlers.c \
        lcd.c \
        led.c \
        scope.c \
+       scope_meas.c \
+       persistence.c \
+       filter.c \
+       oversample.c \
+       fft.c \
        spi_master.c \
        gfx.c \
        i2c.c \
@@ -83,6 +92,7 @@ CSRCS = \
        sam/drivers/wdt/wdt.c                              \
        sam/drivers/spi/spi.c                              \
        sam/drivers/adc/adc.c                              \
+       sam/drivers/dacc/dacc.c                            \
        sam/utils/cmsis/sam4s/source/templates/gcc/startup_sam4s.c \
        sam/utils/cmsis/sam4s/source/templates/system_sam4s.c \
        sam/utils/syscalls/gcc/syscalls.c                  \
@@ -111,6 +121,7 @@ INC_PATH = \
        sam/drivers/wdt                                    \
        sam/drivers/spi                                    \
        sam/drivers/adc                                    \
+       sam/drivers/dacc                                   \
        sam/utils                                          \
        sam/utils/cmsis/sam4s/include                      \
        sam/utils/cmsis/sam4s/source/templates             \
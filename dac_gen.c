@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "dac_gen.h"
+#include "fft.h"
+
+#include <dacc.h>
+#include <pdc.h>
+#include <pio.h>
+#include <pmc.h>
+#include <sysclk.h>
+#include <tc.h>
+#include <string.h>
+
+/* Timer counter channel pacing the conversions (channels 0 and 1 are taken
+ * by the LED blinking routines and the ADC) */
+#define DACG_TC             TC0
+#define DACG_TC_CHANNEL     2
+#define DACG_TC_ID          ID_TC2
+/* DACC trigger selection: TIOA output of TC0 channel 2 */
+#define DACG_TRIGGER        3
+
+/* Streamed buffer, holds as many complete periods as possible */
+#define DACG_BUFFER_SIZE    2048
+/* Constant level buffer streamed between bursts */
+#define DACG_IDLE_SIZE      256
+/* The DACC FIFO still holds a few samples when the PDC is done,
+ * a single burst is followed by enough idle samples to flush it */
+#define DACG_IDLE_TAIL      8
+
+#define DACG_MAX_RC         0xffff
+
+/** Pointer to PDC register base. */
+static Pdc *p_pdc;
+
+static volatile int busy = 0;
+
+static uint16_t dacg_buffer[DACG_BUFFER_SIZE];
+static uint16_t dacg_idle[DACG_IDLE_SIZE];
+
+static int16_t dacg_user[DACG_MAX_SAMPLES];
+static uint32_t dacg_user_size = DACG_MAX_SAMPLES;
+
+/* Timer clock [Hz] and its selection */
+static uint32_t dacg_clock;
+static uint32_t dacg_tcclks;
+/* Timer period [ticks], samples in a waveform period and periods in the buffer */
+static uint32_t dacg_rc;
+static uint32_t dacg_samples;
+static uint32_t dacg_periods;
+static uint32_t dacg_freq;
+
+static int sweep_enabled;
+static uint32_t sweep_start, sweep_stop;
+static uint64_t sweep_ticks, sweep_elapsed;
+
+static uint32_t burst_cycles, burst_idle;
+static uint32_t burst_cycles_left, burst_idle_left;
+
+
+void dacg_set_arbitrary(uint32_t idx, int16_t value)
+{
+    if (idx < DACG_MAX_SAMPLES)
+        dacg_user[idx] = value;
+}
+
+
+int dacg_set_arbitrary_size(uint32_t size)
+{
+    if (size < DACG_MIN_SAMPLES || size > DACG_MAX_SAMPLES)
+        return 0;
+
+    dacg_user_size = size;
+
+    return 1;
+}
+
+
+/* Selects the timer clock and the number of samples per period, so the
+ * highest frequency is generated with as many samples as the conversion rate
+ * allows and the lowest one still fits in the 16-bit timer period */
+static int dacg_timing(uint32_t f_lo, uint32_t f_hi, uint32_t samples_max)
+{
+    static const uint32_t clocks[][2] = {
+        { 2,   TC_CMR_TCCLKS_TIMER_CLOCK1 },
+        { 8,   TC_CMR_TCCLKS_TIMER_CLOCK2 },
+        { 32,  TC_CMR_TCCLKS_TIMER_CLOCK3 },
+        { 128, TC_CMR_TCCLKS_TIMER_CLOCK4 },
+    };
+    uint32_t mck = sysclk_get_peripheral_hz();
+
+    for (unsigned int i = 0; i < sizeof(clocks) / sizeof(clocks[0]); ++i) {
+        uint32_t clock = mck / clocks[i][0];
+        uint32_t rc_min = (clock + DACG_MAX_RATE - 1) / DACG_MAX_RATE;
+        uint32_t samples;
+
+        /* TIOA needs distinct RA and RC compares */
+        if (rc_min < 2)
+            rc_min = 2;
+
+        samples = (clock / f_hi) / rc_min;
+
+        if (samples > samples_max)
+            samples = samples_max;
+
+        /* slower clocks give even fewer samples */
+        if (samples < DACG_MIN_SAMPLES)
+            return 0;
+
+        if ((clock / f_lo) / samples <= DACG_MAX_RC) {
+            dacg_clock = clock;
+            dacg_tcclks = clocks[i][1];
+            dacg_samples = samples;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+static uint32_t dacg_get_rc(uint32_t freq)
+{
+    uint32_t rate = freq * dacg_samples;
+    uint32_t rc = (dacg_clock + rate / 2) / rate;
+
+    if (rc < 2)
+        rc = 2;
+    else if (rc > DACG_MAX_RC)
+        rc = DACG_MAX_RC;
+
+    return rc;
+}
+
+
+static uint32_t dacg_get_actual_freq(void)
+{
+    uint32_t ticks = dacg_rc * dacg_samples;
+
+    return (dacg_clock + ticks / 2) / ticks;
+}
+
+
+static void dacg_set_rc(uint32_t rc)
+{
+    dacg_rc = rc;
+    tc_write_ra(DACG_TC, DACG_TC_CHANNEL, rc / 2);
+    tc_write_rc(DACG_TC, DACG_TC_CHANNEL, rc);
+
+    /* the counter would run up to 0xffff if it is already past the new period */
+    if (busy && tc_read_cv(DACG_TC, DACG_TC_CHANNEL) >= rc)
+        DACG_TC->TC_CHANNEL[DACG_TC_CHANNEL].TC_CCR = TC_CCR_SWTRG;
+}
+
+
+/* Waveform value at a given phase (full circle is 2^32), Q15 */
+static int32_t dacg_shape(dacg_wave_t wave, uint32_t phase)
+{
+    /* triangle starts at zero and rises, like sine */
+    uint32_t t = (phase + 0x40000000) >> 16;
+
+    switch (wave) {
+        case DACG_SINE:
+            return fft_sin_q15(phase);
+
+        case DACG_SQUARE:
+            return (phase < 0x80000000) ? 32767 : -32767;
+
+        case DACG_TRIANGLE:
+            return (t < 32768) ? (int32_t) (2 * t) - 32767
+                               : 32767 - (int32_t) (2 * (t - 32768));
+
+        case DACG_ARBITRARY:
+            return dacg_user[((uint64_t) phase * dacg_user_size) >> 32];
+    }
+
+    return 0;
+}
+
+
+static uint16_t dacg_clip(int32_t value)
+{
+    if (value < 0)
+        return 0;
+    else if (value > DACG_MAX_CODE)
+        return DACG_MAX_CODE;
+
+    return value;
+}
+
+
+static void dacg_fill(dacg_wave_t wave, uint16_t amplitude, uint16_t offset)
+{
+    uint32_t step = (uint32_t) (((uint64_t) 1 << 32) / dacg_samples);
+    uint32_t phase = 0;
+
+    for (uint32_t i = 0; i < dacg_samples; ++i) {
+        dacg_buffer[i] = dacg_clip(offset + ((dacg_shape(wave, phase) * amplitude) >> 16));
+        phase += step;
+    }
+
+    /* complete periods only, so the buffer can be streamed in a loop */
+    dacg_periods = DACG_BUFFER_SIZE / dacg_samples;
+
+    for (uint32_t p = 1; p < dacg_periods; ++p) {
+        memcpy(&dacg_buffer[p * dacg_samples], dacg_buffer,
+                dacg_samples * sizeof(*dacg_buffer));
+    }
+
+    for (uint32_t i = 0; i < DACG_IDLE_SIZE; ++i) {
+        dacg_idle[i] = dacg_clip(offset);
+    }
+}
+
+
+static int dacg_setup(dacg_wave_t wave, uint32_t f_lo, uint32_t f_hi,
+        uint16_t amplitude, uint16_t offset)
+{
+    uint32_t samples_max = (wave == DACG_ARBITRARY) ? dacg_user_size : DACG_MAX_SAMPLES;
+
+    if (wave > DACG_ARBITRARY || f_lo == 0 || f_hi < f_lo)
+        return 0;
+
+    dacg_stop();
+
+    if (!dacg_timing(f_lo, f_hi, samples_max))
+        return 0;
+
+    dacg_fill(wave, amplitude, offset);
+
+    pmc_enable_periph_clk(ID_DACC);
+    pmc_enable_periph_clk(DACG_TC_ID);
+    pio_configure(PIOB, PIO_INPUT, PIO_PB13X1_DAC0, PIO_DEFAULT);
+    /* TIOA2 stays routed to PA26 after the equivalent-time sampling,
+     * it must not drive the pin */
+    pio_configure(PIOA, PIO_INPUT, PIO_PA26, PIO_DEFAULT);
+    p_pdc = dacc_get_pdc_base(DACC);
+
+    dacc_reset(DACC);
+    dacc_disable_interrupt(DACC, 0xFFFFFFFF);
+    dacc_set_transfer_mode(DACC, 0);    /* half-word transfers */
+    /* refresh every 1024 * 8 DACC clocks keeps the idle level */
+    dacc_set_timing(DACC, 0x08, 0, 0x10);
+    dacc_set_channel_selection(DACC, 0);
+    dacc_set_analog_control(DACC, DACC_ACR_IBCTLCH0(0x02)
+            | DACC_ACR_IBCTLCH1(0x02) | DACC_ACR_IBCTLDACCORE(0x01));
+    dacc_enable_channel(DACC, 0);
+
+    /* Each rising edge of TIOA converts a sample */
+    dacc_set_trigger(DACC, DACG_TRIGGER);
+
+    /* TIOA goes high on RC compare and low on RA compare */
+    tc_init(DACG_TC, DACG_TC_CHANNEL, dacg_tcclks | TC_CMR_WAVE
+            | TC_CMR_WAVSEL_UP_RC | TC_CMR_ACPA_CLEAR | TC_CMR_ACPC_SET);
+
+    NVIC_EnableIRQ(DACC_IRQn);
+
+    return 1;
+}
+
+
+int dacg_configure(dacg_wave_t wave, uint32_t freq, uint16_t amplitude,
+        uint16_t offset)
+{
+    if (!dacg_setup(wave, freq, freq, amplitude, offset))
+        return 0;
+
+    sweep_enabled = 0;
+    dacg_set_rc(dacg_get_rc(freq));
+    dacg_freq = dacg_get_actual_freq();
+
+    return 1;
+}
+
+
+int dacg_configure_sweep(dacg_wave_t wave, uint32_t f_start, uint32_t f_stop,
+        uint32_t duration, uint16_t amplitude, uint16_t offset)
+{
+    uint32_t f_lo = f_start < f_stop ? f_start : f_stop;
+    uint32_t f_hi = f_start < f_stop ? f_stop : f_start;
+
+    if (duration == 0 || !dacg_setup(wave, f_lo, f_hi, amplitude, offset))
+        return 0;
+
+    sweep_enabled = 1;
+    sweep_start = f_start;
+    sweep_stop = f_stop;
+    sweep_ticks = (uint64_t) duration * dacg_clock / 1000;
+    dacg_set_rc(dacg_get_rc(f_start));
+    dacg_freq = dacg_get_actual_freq();
+
+    return 1;
+}
+
+
+void dacg_set_burst(uint32_t cycles, uint32_t idle)
+{
+    burst_cycles = cycles;
+    burst_idle = idle;
+}
+
+
+uint32_t dacg_get_freq(void)
+{
+    return dacg_freq;
+}
+
+
+uint32_t dacg_get_samples(void)
+{
+    return dacg_samples;
+}
+
+
+/* Selects the next part of the output to be streamed,
+ * returns its size or 0 when a single burst is over */
+static uint32_t dacg_next_chunk(uint16_t **addr)
+{
+    uint32_t count;
+
+    if (!burst_cycles || sweep_enabled) {
+        *addr = dacg_buffer;
+        return dacg_periods * dacg_samples;
+    }
+
+    if (burst_cycles_left) {
+        count = burst_cycles_left < dacg_periods ? burst_cycles_left : dacg_periods;
+        burst_cycles_left -= count;
+
+        if (!burst_cycles_left)
+            burst_idle_left = burst_idle ? burst_idle * dacg_samples : DACG_IDLE_TAIL;
+
+        *addr = dacg_buffer;
+        return count * dacg_samples;
+    }
+
+    if (burst_idle_left) {
+        count = burst_idle_left < DACG_IDLE_SIZE ? burst_idle_left : DACG_IDLE_SIZE;
+        burst_idle_left -= count;
+
+        if (!burst_idle_left && burst_idle)
+            burst_cycles_left = burst_cycles;
+
+        *addr = dacg_idle;
+        return count;
+    }
+
+    return 0;
+}
+
+
+/* Moves the sweep forward by the time of a streamed buffer */
+static void dacg_sweep_step(void)
+{
+    int64_t delta = (int64_t) sweep_stop - sweep_start;
+
+    sweep_elapsed += (uint64_t) dacg_periods * dacg_samples * dacg_rc;
+
+    if (sweep_elapsed >= sweep_ticks)
+        sweep_elapsed = 0;
+
+    dacg_set_rc(dacg_get_rc(sweep_start
+                + delta * (int64_t) sweep_elapsed / (int64_t) sweep_ticks));
+}
+
+
+void dacg_start(void)
+{
+    uint16_t *addr;
+    uint32_t count;
+
+    dacg_stop();
+
+    busy = 1;
+    sweep_elapsed = 0;
+    burst_cycles_left = burst_cycles;
+    burst_idle_left = 0;
+
+    if (sweep_enabled)
+        dacg_set_rc(dacg_get_rc(sweep_start));
+
+    /* Set up PDC transmit buffers */
+    count = dacg_next_chunk(&addr);
+    p_pdc->PERIPH_TPR = (uint32_t) addr;
+    p_pdc->PERIPH_TCR = count;
+
+    count = dacg_next_chunk(&addr);
+
+    if (count) {
+        p_pdc->PERIPH_TNPR = (uint32_t) addr;
+        p_pdc->PERIPH_TNCR = count;
+        dacc_enable_interrupt(DACC, DACC_IER_ENDTX);
+    } else {
+        dacc_enable_interrupt(DACC, DACC_IER_TXBUFE);
+    }
+
+    pdc_enable_transfer(p_pdc, PERIPH_PTCR_TXTEN);
+
+    /* Start the conversion clock */
+    tc_start(DACG_TC, DACG_TC_CHANNEL);
+}
+
+
+void dacg_stop(void)
+{
+    tc_stop(DACG_TC, DACG_TC_CHANNEL);
+
+    if (p_pdc) {
+        dacc_disable_interrupt(DACC, DACC_IDR_ENDTX | DACC_IDR_TXBUFE);
+        pdc_disable_transfer(p_pdc, PERIPH_PTCR_TXTDIS);
+    }
+
+    busy = 0;
+}
+
+
+int dacg_busy(void)
+{
+    return busy;
+}
+
+
+/**
+ * \brief Interrupt handler for the DACC.
+ */
+void DACC_Handler(void)
+{
+    uint32_t status = dacc_get_interrupt_status(DACC) & dacc_get_interrupt_mask(DACC);
+
+    if (status & DACC_ISR_ENDTX) {
+        /* PDC has switched to the next buffer, queue another one */
+        uint16_t *addr;
+        uint32_t count = dacg_next_chunk(&addr);
+
+        if (count) {
+            p_pdc->PERIPH_TNPR = (uint32_t) addr;
+            p_pdc->PERIPH_TNCR = count;
+        } else {
+            /* the last buffer is being streamed, wait until it is done */
+            dacc_disable_interrupt(DACC, DACC_IDR_ENDTX);
+            dacc_enable_interrupt(DACC, DACC_IER_TXBUFE);
+        }
+
+        if (sweep_enabled)
+            dacg_sweep_step();
+
+    } else if (status & DACC_ISR_TXBUFE) {
+        dacg_stop();
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef DAC_GEN_H
+#define DAC_GEN_H
+
+#include <stdint.h>
+
+/** Maximum number of conversions per second */
+#define DACG_MAX_RATE           1000000
+/** Shortest waveform period [samples] */
+#define DACG_MIN_SAMPLES        4
+/** Longest waveform period [samples], also the arbitrary waveform size limit */
+#define DACG_MAX_SAMPLES        1024
+
+/** Largest DAC code */
+#define DACG_MAX_CODE           4095
+
+typedef enum {
+    DACG_SINE,
+    DACG_SQUARE,
+    DACG_TRIANGLE,
+    DACG_ARBITRARY
+} dacg_wave_t;
+
+/**
+ * Sets a sample of the arbitrary waveform.
+ * @param idx is the sample index (0 to DACG_MAX_SAMPLES - 1).
+ * @param value is the normalized sample value (Q15, -1.0 to 1.0).
+ */
+void dacg_set_arbitrary(uint32_t idx, int16_t value);
+
+/**
+ * Sets the number of samples forming one period of the arbitrary waveform.
+ * @return 1 on success, 0 if the size is out of range.
+ */
+int dacg_set_arbitrary_size(uint32_t size);
+
+/**
+ * Generates the waveform table and configures the timer pacing the conversions.
+ *
+ * The output swings between offset - amplitude / 2 and offset + amplitude / 2
+ * (clipped to the DAC range).
+ * @param wave is the waveform shape.
+ * @param freq is the requested waveform frequency [Hz].
+ * @param amplitude is the peak-to-peak amplitude [DAC codes].
+ * @param offset is the center level [DAC codes].
+ * @return 1 on success, 0 if the requested configuration is not achievable.
+ */
+int dacg_configure(dacg_wave_t wave, uint32_t freq, uint16_t amplitude,
+        uint16_t offset);
+
+/**
+ * Configures a repeated linear frequency sweep.
+ *
+ * The waveform table is shared by the whole range, so wide sweeps have
+ * fewer samples per period and coarser frequency steps at the upper end.
+ * @param f_start is the initial frequency [Hz].
+ * @param f_stop is the final frequency [Hz].
+ * @param duration is the sweep duration [ms].
+ * @return 1 on success, 0 if the requested configuration is not achievable.
+ */
+int dacg_configure_sweep(dacg_wave_t wave, uint32_t f_start, uint32_t f_stop,
+        uint32_t duration, uint16_t amplitude, uint16_t offset);
+
+/**
+ * Enables the burst mode: the generator outputs a number of waveform periods
+ * followed by an idle time at the offset level.
+ * @param cycles is the number of periods in a burst, 0 for continuous output.
+ * @param idle is the idle time between bursts [periods], 0 for a single burst.
+ */
+void dacg_set_burst(uint32_t cycles, uint32_t idle);
+
+/**
+ * Returns the actual waveform frequency (the initial one for sweeps) [Hz].
+ */
+uint32_t dacg_get_freq(void);
+
+/**
+ * Returns the number of samples in a waveform period.
+ */
+uint32_t dacg_get_samples(void);
+
+/**
+ * Starts the output on DAC0 (PB13). The samples are streamed by the PDC,
+ * the CPU is involved only once per buffer.
+ */
+void dacg_start(void);
+
+/**
+ * Unconditionally stops the output, the DAC holds the last sample.
+ */
+void dacg_stop(void);
+
+/**
+ * Returns 1 when the generator is running, 0 otherwise.
+ */
+int dacg_busy(void);
+
+#endif /* DAC_GEN_H */
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "fft.h"
+
+#include <compiler.h>
+
+/* Complex numbers are stored as 32-bit words: real part in the lower half,
+ * imaginary part in the upper half, so a single SIMD instruction processes
+ * both parts. Every butterfly stage scales the data by 1/2 to avoid
+ * overflows. */
+
+/* sin(2 * pi * i / FFT_MAX_SIZE), i = 0..FFT_MAX_SIZE/4 (Q15) */
+static const int16_t fft_sin_table[FFT_MAX_SIZE / 4 + 1] = {
+        0,   201,   402,   603,   804,  1005,  1206,  1407,
+     1608,  1809,  2009,  2210,  2410,  2611,  2811,  3012,
+     3212,  3412,  3612,  3811,  4011,  4210,  4410,  4609,
+     4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,
+     6393,  6590,  6786,  6983,  7179,  7375,  7571,  7767,
+     7962,  8157,  8351,  8545,  8739,  8933,  9126,  9319,
+     9512,  9704,  9896, 10087, 10278, 10469, 10659, 10849,
+    11039, 11228, 11417, 11605, 11793, 11980, 12167, 12353,
+    12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+    14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269,
+    15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673,
+    16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+    18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357,
+    19519, 19680, 19841, 20000, 20159, 20317, 20475, 20631,
+    20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027,
+    23170, 23311, 23452, 23592, 23731, 23870, 24007, 24143,
+    24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+    25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198,
+    26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133,
+    27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+    28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803,
+    28898, 28992, 29085, 29177, 29268, 29358, 29447, 29534,
+    29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+    30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783,
+    30852, 30919, 30985, 31050, 31113, 31176, 31237, 31297,
+    31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+    31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098,
+    32137, 32176, 32213, 32250, 32285, 32318, 32351, 32382,
+    32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717,
+    32728, 32737, 32745, 32752, 32757, 32761, 32765, 32766,
+    32767,
+};
+
+/* Window gain compensation (dB * FFT_DB_SCALE) */
+static const int16_t fft_window_gain[] = {
+    [FFT_WINDOW_RECT]       = 0,
+    [FFT_WINDOW_HANN]       = 96,   /* 6.02 dB */
+    [FFT_WINDOW_BLACKMAN]   = 121,  /* 7.54 dB */
+};
+
+#define QUARTER     (FFT_MAX_SIZE / 4)
+
+/* sin(2 * pi * idx / FFT_MAX_SIZE) */
+static inline int32_t fft_sin(unsigned int idx)
+{
+    idx &= FFT_MAX_SIZE - 1;
+
+    if (idx <= QUARTER)
+        return fft_sin_table[idx];
+    else if (idx <= 2 * QUARTER)
+        return fft_sin_table[2 * QUARTER - idx];
+    else if (idx <= 3 * QUARTER)
+        return -fft_sin_table[idx - 2 * QUARTER];
+    else
+        return -fft_sin_table[4 * QUARTER - idx];
+}
+
+
+static inline int32_t fft_cos(unsigned int idx)
+{
+    return fft_sin(idx + QUARTER);
+}
+
+
+/* Multiplies x by (w.re - j * w.im), result is saturated to Q15 */
+static inline uint32_t fft_cmul(uint32_t x, uint32_t w)
+{
+    int32_t re = (int32_t) __SMUAD(x, w) >> 15;
+    int32_t im = (int32_t) __SMUSDX(w, x) >> 15;
+
+    return __PKHBT(__SSAT(re, 16), __SSAT(im, 16), 16);
+}
+
+
+/* Computes X[k] from the complex FFT bins Z[k] (a) and Z[N/2 - k] (b) */
+static inline uint32_t fft_split(uint32_t a, uint32_t b, unsigned int k,
+        unsigned int size)
+{
+    uint32_t b_conj = __PKHBT(b, __QSUB16(0, b), 0);
+    uint32_t even = __SHADD16(a, b_conj);
+    uint32_t odd = __SHSUB16(a, b_conj);
+    unsigned int idx = k * (FFT_MAX_SIZE / size);
+    /* -j * exp(-j * 2 * pi * k / size), stored as a twiddle factor */
+    uint32_t w = __PKHBT(-fft_sin(idx), fft_cos(idx), 16);
+
+    return __SHADD16(even, fft_cmul(odd, w));
+}
+
+
+void fft_window(int16_t *data, unsigned int size, fft_window_t window)
+{
+    unsigned int step = FFT_MAX_SIZE / size;
+    int32_t w = 0x7fff;
+
+    if (window == FFT_WINDOW_RECT)
+        return;
+
+    for (unsigned int i = 0; i < size; ++i) {
+        int32_t c = fft_cos(i * step);
+
+        switch (window) {
+            case FFT_WINDOW_RECT:
+                break;
+
+            case FFT_WINDOW_HANN:       /* 0.5 - 0.5 cos(x) */
+                w = (0x7fff - c) >> 1;
+                break;
+
+            case FFT_WINDOW_BLACKMAN:   /* 0.42 - 0.5 cos(x) + 0.08 cos(2x) */
+                w = 13763 - (c >> 1) + ((2621 * fft_cos(2 * i * step)) >> 15);
+                break;
+        }
+
+        data[i] = (data[i] * w) >> 15;
+    }
+}
+
+
+void fft_real(int16_t *data, unsigned int size)
+{
+    /* real samples are treated as complex ones: z[n] = x[2n] + j x[2n+1],
+     * the caller provides word aligned data */
+    uint32_t *z = (void*) data;
+    unsigned int m = size / 2;
+    unsigned int rev_shift = __CLZ(m) + 1;
+
+    /* bit-reversed order */
+    for (unsigned int i = 1; i < m; ++i) {
+        unsigned int j = __RBIT(i) >> rev_shift;
+
+        if (i < j) {
+            uint32_t tmp = z[i];
+            z[i] = z[j];
+            z[j] = tmp;
+        }
+    }
+
+    /* radix-2 butterflies */
+    for (unsigned int half = 1; half < m; half <<= 1) {
+        unsigned int step = FFT_MAX_SIZE / (2 * half);
+
+        for (unsigned int k = 0; k < half; ++k) {
+            uint32_t w = __PKHBT(fft_cos(k * step), fft_sin(k * step), 16);
+
+            for (unsigned int i = k; i < m; i += 2 * half) {
+                uint32_t a = z[i];
+                uint32_t t = fft_cmul(z[i + half], w);
+
+                z[i] = __SHADD16(a, t);
+                z[i + half] = __SHSUB16(a, t);
+            }
+        }
+    }
+
+    /* split the complex spectrum into the real signal spectrum */
+    for (unsigned int k = 0; k <= m / 2; ++k) {
+        unsigned int k_mirror = (m - k) & (m - 1);
+        uint32_t z_k = z[k];
+        uint32_t z_mirror = z[k_mirror];
+
+        z[k] = fft_split(z_k, z_mirror, k, size);
+
+        if (k_mirror != k)
+            z[k_mirror] = fft_split(z_mirror, z_k, k_mirror, size);
+    }
+}
+
+
+void fft_power(const int16_t *spectrum, uint32_t *power, unsigned int bins,
+        unsigned int avg_shift)
+{
+    /* complex bins packed as re/im pairs, word aligned as in fft_real() */
+    const uint32_t *bin = (const void*) spectrum;
+
+    for (unsigned int k = 0; k < bins; ++k) {
+        uint32_t p = __SMUAD(*bin, *bin);  /* re^2 + im^2 */
+        ++bin;
+
+        if (avg_shift)
+            power[k] = power[k] - (power[k] >> avg_shift) + (p >> avg_shift);
+        else
+            power[k] = p;
+    }
+}
+
+
+int fft_power_db(uint32_t power, fft_window_t window)
+{
+    if (power == 0)
+        return FFT_DB_MIN * FFT_DB_SCALE;
+
+    /* log2 with 4 fractional bits (linear interpolation of the mantissa) */
+    unsigned int lz = __CLZ(power);
+    int log2 = ((31 - lz) << 4) | (((power << lz) >> 27) & 0x0f);
+
+    /* a full scale sine gives power 0.25 (2^28); 10 * log10(2) ~= 771 / 256 */
+    int db = (log2 - (28 << 4)) * 771 / 256;
+
+    return db + fft_window_gain[window];
+}
+
+
+int fft_sin_q15(uint32_t phase)
+{
+    /* FFT_MAX_SIZE is 2^10: the table index is in the upper 10 bits,
+     * the rest is interpolated */
+    unsigned int idx = phase >> 22;
+    int32_t frac = (phase >> 6) & 0xffff;
+    int32_t a = fft_sin(idx);
+    int32_t b = fft_sin(idx + 1);
+
+    return a + (((b - a) * frac) >> 16);
+}
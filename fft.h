@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * Fixed-point (Q15) real FFT using the Cortex-M4 SIMD instructions.
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <stdint.h>
+
+/** Largest supported transform size (real samples) */
+#define FFT_MAX_SIZE        1024
+
+/** Power levels returned by fft_power_db() are scaled by this factor */
+#define FFT_DB_SCALE        16
+
+/** Level returned for zero power (dB) */
+#define FFT_DB_MIN          -120
+
+typedef enum {
+    FFT_WINDOW_RECT,
+    FFT_WINDOW_HANN,
+    FFT_WINDOW_BLACKMAN
+} fft_window_t;
+
+/**
+ * Multiplies samples by a window function (in place).
+ *
+ * @param data are the Q15 samples.
+ * @param size is the number of samples (power of 2, up to FFT_MAX_SIZE).
+ * @param window is the window function.
+ */
+void fft_window(int16_t *data, unsigned int size, fft_window_t window);
+
+/**
+ * Computes the FFT of real samples (in place).
+ *
+ * The result is size/2 complex bins (real and imaginary parts interleaved)
+ * covering frequencies from 0 to fs/2 (exclusive), scaled by 1/size.
+ * @param data are the Q15 samples (word aligned), overwritten with the spectrum.
+ * @param size is the number of samples (power of 2, 4 - FFT_MAX_SIZE).
+ */
+void fft_real(int16_t *data, unsigned int size);
+
+/**
+ * Converts complex bins to power and accumulates it using an exponential
+ * moving average.
+ *
+ * @param spectrum are the complex bins returned by fft_real().
+ * @param power is the averaged power (Q30, 1.0 = full scale).
+ * @param bins is the number of bins.
+ * @param avg_shift is the averaging factor (new = old + (cur - old) / 2^avg_shift),
+ * 0 disables averaging.
+ */
+void fft_power(const int16_t *spectrum, uint32_t *power, unsigned int bins,
+        unsigned int avg_shift);
+
+/**
+ * Converts power to decibels relative to a full scale sine wave.
+ *
+ * @param power is the power computed by fft_power().
+ * @param window is the window function used, to compensate its gain.
+ * @return Power level in dB multiplied by FFT_DB_SCALE.
+ */
+int fft_power_db(uint32_t power, fft_window_t window);
+
+/**
+ * Computes sine using the FFT twiddle factor table (linear interpolation).
+ *
+ * @param phase is the angle, full circle is 2^32.
+ * @return sin(2 * pi * phase / 2^32) in Q15.
+ */
+int fft_sin_q15(uint32_t phase);
+
+#endif /* FFT_H */
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "filter.h"
+
+#include <compiler.h>
+#include <string.h>
+
+/* Low-pass FIR (Hamming windowed sinc, cut-off at 0.1 fs), Q15.
+ * Coefficients are stored in the reversed order (oldest sample first). */
+static const int16_t filter_fir_lowpass[FILTER_FIR_TAPS] __attribute__((aligned(4))) = {
+     -17,    20,    73,   135,   164,    91,  -129,  -466,
+    -783,  -850,  -435,   588,  2141,  3927,  5501,  6424,
+    6424,  5501,  3927,  2141,   588,  -435,  -850,  -783,
+    -466,  -129,    91,   164,   135,    73,    20,   -17,
+};
+
+/* 2nd order Butterworth high-pass (cut-off at 0.01 fs), Q14 */
+#define HP_B0       15672
+#define HP_B1       -31344
+#define HP_B2       15672
+#define HP_A1       -31313
+#define HP_A2       14991
+
+/* Constants in Q30 */
+#define Q30_ONE     ((int64_t) 1 << 30)
+#define Q30_PI      ((int64_t) 3373259426UL)
+#define Q30_2PI     (2 * Q30_PI)
+
+
+/* cos(x), x in Q30 and |x| < 0.5 (Taylor series) */
+static int64_t filter_cos_q30(int64_t x)
+{
+    int64_t x2 = (x * x) >> 30;
+    int64_t x4 = (x2 * x2) >> 30;
+    int64_t x6 = (x4 * x2) >> 30;
+
+    return Q30_ONE - x2 / 2 + x4 / 24 - x6 / 720;
+}
+
+
+static inline int32_t filter_q30_to_q14(int64_t val)
+{
+    return (val + (1 << 15)) >> 16;
+}
+
+
+static void filter_set_biquad(filter_t *filter, int32_t b0, int32_t b1,
+        int32_t b2, int32_t a1, int32_t a2)
+{
+    filter->b0_b1 = __PKHBT(b0, b1, 16);
+    filter->b2_na1 = __PKHBT(b2, -a1, 16);
+    filter->a2 = a2;
+    filter->x1 = filter->x2 = filter->y1 = filter->y2 = 0;
+    filter->err = 0;
+}
+
+
+/* Notch: zeros on the unit circle at f0, poles at the same angle with
+ * radius depending on the bandwidth; normalized to unity gain at DC */
+static void filter_set_notch(filter_t *filter, uint32_t f0, uint32_t fsampling)
+{
+    int64_t c = filter_cos_q30(Q30_2PI * f0 / fsampling);
+    int64_t r = Q30_ONE - Q30_PI * FILTER_NOTCH_BANDWIDTH / fsampling;
+    int64_t a1 = -2 * ((r * c) >> 30);
+    int64_t a2 = (r * r) >> 30;
+    int64_t g = ((Q30_ONE + a1 + a2) << 30) / (2 * (Q30_ONE - c));
+    int64_t b1 = -2 * ((g * c) >> 30);
+
+    filter_set_biquad(filter, filter_q30_to_q14(g), filter_q30_to_q14(b1),
+            filter_q30_to_q14(g), filter_q30_to_q14(a1), filter_q30_to_q14(a2));
+}
+
+
+int filter_init(filter_t *filter, filter_type_t type, uint32_t fsampling)
+{
+    filter->type = type;
+
+    switch (type) {
+        case FILTER_NONE:
+            break;
+
+        case FILTER_LOWPASS:
+            memset(filter->fir_state, 0, sizeof(filter->fir_state));
+            break;
+
+        case FILTER_HIGHPASS:
+            filter_set_biquad(filter, HP_B0, HP_B1, HP_B2, HP_A1, HP_A2);
+            break;
+
+        case FILTER_NOTCH_50HZ:
+        case FILTER_NOTCH_60HZ:
+            /* coefficient precision is not sufficient at higher rates */
+            if (fsampling == 0 || fsampling > FILTER_NOTCH_MAX_RATE) {
+                filter->type = FILTER_NONE;
+                return 0;
+            }
+
+            filter_set_notch(filter, type == FILTER_NOTCH_50HZ ? 50 : 60, fsampling);
+            break;
+    }
+
+    return 1;
+}
+
+
+/* Computes two outputs per iteration, so every sample word is loaded once */
+static void filter_fir(filter_t *filter, int16_t *data, unsigned int count)
+{
+    const unsigned int hist = FILTER_FIR_TAPS - 1;
+    /* coefficients and state are word aligned, read in pairs */
+    const uint32_t *coefs = (const void*) filter_fir_lowpass;
+    int16_t *state = filter->fir_state;
+
+    memcpy(&state[hist], data, count * sizeof(*data));
+
+    for (unsigned int n = 0; n < count; n += 2) {
+        const uint32_t *x = (const void*) &state[n];
+        uint32_t cur = *x++;
+        int32_t acc0 = 0, acc1 = 0;
+
+        for (unsigned int j = 0; j < FILTER_FIR_TAPS / 2; j++) {
+            uint32_t next = *x++;
+            uint32_t h = coefs[j];
+
+            acc0 = __SMLAD(cur, h, acc0);
+            /* samples shifted by one: upper half of cur, lower half of next */
+            acc1 = __SMLAD(__PKHBT(cur >> 16, next, 16), h, acc1);
+            cur = next;
+        }
+
+        data[n] = __SSAT(acc0 >> 15, 16);
+        data[n + 1] = __SSAT(acc1 >> 15, 16);
+    }
+
+    memmove(state, &state[count], hist * sizeof(*state));
+}
+
+
+/* Direct form I. Poles close to the unit circle amplify the output
+ * truncation error, so it is fed back to the next sample (error shaping). */
+static void filter_biquad(filter_t *filter, int16_t *data, unsigned int count)
+{
+    int32_t x1 = filter->x1, x2 = filter->x2;
+    int32_t y1 = filter->y1, y2 = filter->y2;
+    int32_t err = filter->err;
+
+    for (unsigned int i = 0; i < count; i++) {
+        int32_t x0 = data[i];
+        int32_t acc = __SMLAD(__PKHBT(x0, x1, 16), filter->b0_b1, err);
+
+        acc = __SMLAD(__PKHBT(x2, y1, 16), filter->b2_na1, acc);
+        acc -= filter->a2 * y2;
+
+        err = acc & 0x3fff;
+        x2 = x1;
+        x1 = x0;
+        y2 = y1;
+        y1 = __SSAT(acc >> 14, 16);
+        data[i] = y1;
+    }
+
+    filter->err = err;
+
+    filter->x1 = x1;
+    filter->x2 = x2;
+    filter->y1 = y1;
+    filter->y2 = y2;
+}
+
+
+void filter_process(filter_t *filter, int16_t *data, unsigned int count)
+{
+    switch (filter->type) {
+        case FILTER_NONE:
+            break;
+
+        case FILTER_LOWPASS:
+            filter_fir(filter, data, count);
+            break;
+
+        case FILTER_HIGHPASS:
+        case FILTER_NOTCH_50HZ:
+        case FILTER_NOTCH_60HZ:
+            filter_biquad(filter, data, count);
+            break;
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * Streaming Q15 filters (FIR and biquad IIR) using the Cortex-M4 dual MAC
+ * instructions.
+ */
+
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdint.h>
+
+/** Number of low-pass FIR filter taps */
+#define FILTER_FIR_TAPS         32
+/** Largest block processed at once (samples) */
+#define FILTER_MAX_BLOCK        512
+/** Notch filters are available up to this sampling frequency [Hz] */
+#define FILTER_NOTCH_MAX_RATE   2000
+/** Notch filter bandwidth [Hz] */
+#define FILTER_NOTCH_BANDWIDTH  5
+
+typedef enum {
+    FILTER_NONE,
+    FILTER_LOWPASS,     ///< FIR, cut-off at 0.1 fs
+    FILTER_HIGHPASS,    ///< 2nd order Butterworth, cut-off at 0.01 fs
+    FILTER_NOTCH_50HZ,
+    FILTER_NOTCH_60HZ
+} filter_type_t;
+
+typedef struct {
+    filter_type_t type;
+
+    /* FIR: samples of the previous block followed by the current block
+     * (+1 as the last pair is read as a word) */
+    int16_t fir_state[FILTER_FIR_TAPS - 1 + FILTER_MAX_BLOCK + 1] __attribute__((aligned(4)));
+
+    /* biquad: coefficients (Q14) packed for SMLAD and the state */
+    uint32_t b0_b1;
+    uint32_t b2_na1;
+    int32_t a2;
+    int32_t x1, x2, y1, y2;
+    int32_t err;
+} filter_t;
+
+/**
+ * Initializes a filter.
+ *
+ * @param filter is the filter to be initialized.
+ * @param type is the filter type.
+ * @param fsampling is the sampling frequency [Hz].
+ * @return 1 on success, 0 if the filter cannot work at the given sampling
+ * frequency (the filter is set to FILTER_NONE then).
+ */
+int filter_init(filter_t *filter, filter_type_t type, uint32_t fsampling);
+
+/**
+ * Filters a block of samples (in place). Consecutive calls process
+ * a continuous stream.
+ *
+ * @param filter is the filter to be applied.
+ * @param data are the Q15 samples (word aligned). For the biquad filters,
+ * signals should not exceed half of the full scale.
+ * @param count is the number of samples (even, up to FILTER_MAX_BLOCK).
+ */
+void filter_process(filter_t *filter, int16_t *data, unsigned int count);
+
+#endif /* FILTER_H */
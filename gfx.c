@@ -1,123 +1,396 @@
 /*
- * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
- *
- * This source code is free software; you can redistribute it
- * and/or modify it in source code form under the terms of the GNU
- * General Public License as published by the Free Software
- * Foundation; either version 2 of the License, or (at your option)
- * any later version.
- *
- * This program is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- * GNU General Public License for more details.
- *
- * You should have received a copy of the GNU General Public License
- * along with this program; if not, write to the Free Software
- * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ * Generated by scripts/gfx_convert.py from the images and fonts
+ * directories, do not edit.
  */
+#include "gfx.h"
 
-#include <stdint.h>
-
-const uint8_t kicon_logo[128*32/8] = {
-    0xff,0xff,0xff,0xff,0xfc,0x1f,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xff,0xff,0xff,0xf8,0x0f,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0x80,0x1f,0x80,0x10,0x07,0xff,0xc0,0x3f,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0x80,0x1f,0x80,0x10,0x07,0xff,0x00,0x07,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xc0,0x3f,0x00,0x30,0x07,0xfc,0x00,0x01,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xc0,0x3f,0x00,0x70,0x07,0xf8,0x00,0x01,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xc0,0x3e,0x00,0xf0,0x07,0xf0,0x00,0x03,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xc0,0x3c,0x01,0xf8,0x0f,0xe0,0x00,0x03,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xc0,0x38,0x03,0xfe,0x3f,0xe0,0x02,0x07,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xc0,0x30,0x03,0xff,0xff,0xc0,0x0f,0xcf,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xc0,0x30,0x07,0xe0,0x07,0xc0,0x1f,0xef,0xfe,0x00,0xff,0x80,0x60,0x1f,0xff
-    ,0xff,0xc0,0x20,0x0f,0xf0,0x0f,0x80,0x3f,0xff,0xf8,0x00,0x3f,0x80,0x00,0x0f,0xff
-    ,0xff,0xc0,0x00,0x1f,0xf0,0x0f,0x80,0x3f,0xff,0xe0,0x00,0x1f,0x80,0x00,0x07,0xff
-    ,0xff,0xc0,0x00,0x3f,0xf0,0x0f,0x80,0x7f,0xff,0xe0,0x00,0x0f,0xc0,0x00,0x03,0xff
-    ,0xff,0xc0,0x00,0x3f,0xf0,0x0f,0x80,0x7f,0xff,0xc0,0x00,0x07,0xc0,0x00,0x03,0xff
-    ,0xff,0xc0,0x00,0x7f,0xf0,0x0f,0x80,0x7f,0xff,0x80,0x00,0x07,0xc0,0x00,0x03,0xff
-    ,0xff,0xc0,0x00,0xff,0xf0,0x0f,0x00,0x7f,0xff,0x80,0x38,0x07,0xc0,0x18,0x03,0xff
-    ,0xff,0xc0,0x00,0x7f,0xf0,0x0f,0x00,0x7f,0xff,0x80,0x7c,0x03,0xc0,0x7c,0x03,0xff
-    ,0xff,0xc0,0x00,0x7f,0xf0,0x0f,0x00,0x7f,0xff,0x00,0xfe,0x03,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x00,0x3f,0xf0,0x0f,0x00,0x7f,0xff,0x00,0xfe,0x03,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x00,0x1f,0xf0,0x0f,0x80,0x7f,0xff,0x00,0xfe,0x03,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x00,0x1f,0xf0,0x0f,0x80,0x7f,0xff,0x00,0xfe,0x03,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x20,0x0f,0xf0,0x0f,0x80,0x3f,0xff,0x00,0xfe,0x03,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x20,0x07,0xf0,0x0f,0x80,0x3f,0xff,0x00,0xfe,0x03,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x30,0x03,0xf0,0x0f,0xc0,0x1f,0xe7,0x00,0xfe,0x03,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x38,0x03,0xf0,0x0f,0xc0,0x0f,0xc7,0x80,0x7c,0x03,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x3c,0x01,0xf0,0x0f,0xe0,0x00,0x03,0x80,0x38,0x07,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x3c,0x00,0xf0,0x0f,0xe0,0x00,0x03,0xc0,0x00,0x07,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x3e,0x00,0x70,0x0f,0xf0,0x00,0x01,0xc0,0x00,0x0f,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x3f,0x00,0x70,0x0f,0xf8,0x00,0x01,0xe0,0x00,0x0f,0xc0,0x7e,0x03,0xff
-    ,0xff,0xc0,0x1f,0x00,0x30,0x0f,0xfc,0x00,0x01,0xf0,0x00,0x3f,0x80,0x3c,0x03,0xff
-    ,0xff,0x80,0x1f,0x00,0x20,0x07,0xff,0x00,0x07,0xf8,0x00,0x7f,0x80,0x38,0x01,0xff
+static const uint16_t digits24_offsets[28] = {
+    0, 27, 27, 27, 27, 27, 72, 72, 72, 72, 72, 72, 117, 117, 162, 180,
+    180, 225, 270, 315, 360, 405, 450, 495, 540, 585, 630, 648,
 };
 
+static const uint8_t digits24_glyphs[648] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x3f, 0x3f, 0x3f, 0x3f,
+    0x3f, 0x00, 0x00, 0x00, 0xc0, 0xc0, 0xc0, 0x38, 0x38, 0x38, 0x80, 0x80, 0x80, 0x70, 0x70, 0x70,
+    0x0e, 0x0e, 0x0e, 0x81, 0x81, 0x81, 0x80, 0x80, 0x80, 0x03, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0xf8,
+    0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0xff, 0xff, 0xff,
+    0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x03, 0x03, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e,
+    0x0e, 0x0e, 0x0e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x1f, 0x1f,
+    0x1f, 0x1f, 0x1f, 0x1f, 0xf8, 0xf8, 0xf8, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0xc7, 0xc7, 0xc7,
+    0xf8, 0xf8, 0xf8, 0xff, 0xff, 0xff, 0x70, 0x70, 0x70, 0x0e, 0x0e, 0x0e, 0x01, 0x01, 0x01, 0xff,
+    0xff, 0xff, 0x03, 0x03, 0x03, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x03, 0x03,
+    0x03, 0x00, 0x00, 0x00, 0x38, 0x38, 0x38, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x1c, 0x1c, 0x1c, 0x1f, 0x1f, 0x1f, 0x1c, 0x1c, 0x1c, 0x00, 0x00, 0x00, 0x38, 0x38,
+    0x38, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0xf8, 0xf8, 0xf8, 0x00, 0x00, 0x00,
+    0x80, 0x80, 0x80, 0x70, 0x70, 0x70, 0x0e, 0x0e, 0x0e, 0x01, 0x01, 0x01, 0x1c, 0x1c, 0x1c, 0x1f,
+    0x1f, 0x1f, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x07, 0x07, 0x07, 0x07, 0x07,
+    0x07, 0xc7, 0xc7, 0xc7, 0x3f, 0x3f, 0x3f, 0x07, 0x07, 0x07, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00,
+    0x01, 0x01, 0x01, 0x0e, 0x0e, 0x0e, 0xf0, 0xf0, 0xf0, 0x03, 0x03, 0x03, 0x1c, 0x1c, 0x1c, 0x1c,
+    0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x03, 0x03, 0x03, 0x00, 0x00, 0x00, 0xc0, 0xc0, 0xc0, 0x38, 0x38,
+    0x38, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x7e, 0x7e, 0x7e, 0x71, 0x71, 0x71, 0x70, 0x70, 0x70,
+    0xff, 0xff, 0xff, 0x70, 0x70, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f,
+    0x1f, 0x1f, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xc7, 0xc7, 0xc7, 0xc7, 0xc7, 0xc7, 0xc7, 0xc7,
+    0xc7, 0x07, 0x07, 0x07, 0x81, 0x81, 0x81, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0xfe, 0xfe, 0xfe, 0x03, 0x03, 0x03, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x03,
+    0x03, 0x03, 0xc0, 0xc0, 0xc0, 0x38, 0x38, 0x38, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x00, 0x00,
+    0x00, 0xff, 0xff, 0xff, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0xf0, 0xf0, 0xf0,
+    0x03, 0x03, 0x03, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x03, 0x03, 0x03, 0x07,
+    0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0xc7, 0xc7, 0xc7, 0x3f, 0x3f, 0x3f, 0x00, 0x00,
+    0x00, 0xf0, 0xf0, 0xf0, 0x0e, 0x0e, 0x0e, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0xf8, 0xf8, 0x07,
+    0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0xf8, 0xf8, 0xf8, 0xf1, 0xf1, 0xf1, 0x0e, 0x0e,
+    0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0xf1, 0xf1, 0xf1, 0x03, 0x03, 0x03, 0x1c, 0x1c, 0x1c,
+    0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x03, 0x03, 0x03, 0xf8, 0xf8, 0xf8, 0x07, 0x07, 0x07, 0x07,
+    0x07, 0x07, 0x07, 0x07, 0x07, 0xf8, 0xf8, 0xf8, 0x01, 0x01, 0x01, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e,
+    0x0e, 0x8e, 0x8e, 0x8e, 0x7f, 0x7f, 0x7f, 0x00, 0x00, 0x00, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c,
+    0x03, 0x03, 0x03, 0x00, 0x00, 0x00, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf1, 0xf1, 0xf1, 0xf1,
+    0xf1, 0xf1, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+};
+
+const font_t digits24 = {
+    24, 3, 32, 58,
+    digits24_offsets, digits24_glyphs, NULL,
+    NULL, 0
+};
+
+static const uint16_t sans16_offsets[96] = {
+    0, 12, 16, 28, 48, 68, 88, 108, 116, 128, 140, 160, 180, 188, 208, 216,
+    236, 256, 276, 296, 316, 336, 356, 376, 396, 416, 436, 444, 452, 468, 488, 504,
+    524, 544, 564, 584, 604, 624, 644, 664, 684, 704, 716, 736, 756, 776, 796, 816,
+    836, 856, 876, 896, 916, 936, 956, 976, 996, 1016, 1036, 1056, 1068, 1088, 1100, 1120,
+    1140, 1152, 1172, 1192, 1212, 1232, 1252, 1272, 1292, 1312, 1324, 1340, 1356, 1368, 1388, 1408,
+    1428, 1448, 1468, 1488, 1508, 1528, 1548, 1568, 1588, 1608, 1628, 1648, 1656, 1660, 1668, 1684,
+};
+
+static const uint8_t sans16_glyphs[1684] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x0c, 0x0c,
+    0x3f, 0x3f, 0x00, 0x00, 0x3f, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x38, 0xff, 0xff,
+    0x30, 0x30, 0xff, 0xff, 0x38, 0x30, 0x03, 0x07, 0x3f, 0x3f, 0x03, 0x03, 0x3f, 0x3f, 0x07, 0x03,
+    0x30, 0x78, 0xcc, 0xce, 0xff, 0xff, 0xce, 0xcc, 0x8c, 0x0c, 0x0c, 0x0c, 0x0c, 0x1c, 0x3f, 0x3f,
+    0x1c, 0x0c, 0x07, 0x03, 0x06, 0x0f, 0x0f, 0x86, 0xc0, 0xe0, 0x70, 0x38, 0x1c, 0x0c, 0x0c, 0x0e,
+    0x07, 0x03, 0x01, 0x00, 0x18, 0x3c, 0x3c, 0x18, 0x3c, 0x3e, 0xc7, 0xc3, 0x33, 0x33, 0x1e, 0x0c,
+    0x00, 0x00, 0x0f, 0x1f, 0x38, 0x30, 0x33, 0x33, 0x0c, 0x0c, 0x33, 0x33, 0x33, 0x33, 0x1f, 0x0e,
+    0x00, 0x00, 0x00, 0x00, 0xf0, 0xf8, 0x1c, 0x0e, 0x07, 0x03, 0x03, 0x07, 0x0e, 0x1c, 0x38, 0x30,
+    0x03, 0x07, 0x0e, 0x1c, 0xf8, 0xf0, 0x30, 0x38, 0x1c, 0x0e, 0x07, 0x03, 0x30, 0x30, 0xc0, 0xc0,
+    0xfc, 0xfc, 0xc0, 0xc0, 0x30, 0x30, 0x03, 0x03, 0x00, 0x00, 0x0f, 0x0f, 0x00, 0x00, 0x03, 0x03,
+    0xc0, 0xc0, 0xc0, 0xe0, 0xfc, 0xfc, 0xe0, 0xc0, 0xc0, 0xc0, 0x00, 0x00, 0x00, 0x01, 0x0f, 0x0f,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcc, 0xcc, 0x7c, 0x38, 0xc0, 0xc0, 0xc0, 0xc0,
+    0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x18, 0x3c, 0x3c, 0x18, 0x00, 0x00, 0x00, 0x80, 0xc0, 0xe0, 0x70, 0x38,
+    0x1c, 0x0c, 0x0c, 0x0e, 0x07, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0xfe, 0x07, 0x03,
+    0xc3, 0xe3, 0x33, 0x33, 0xfe, 0xfc, 0x0f, 0x1f, 0x33, 0x33, 0x31, 0x30, 0x30, 0x38, 0x1f, 0x0f,
+    0x00, 0x00, 0x0c, 0x1e, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x38, 0x3f, 0x3f,
+    0x38, 0x30, 0x00, 0x00, 0x0c, 0x0e, 0x07, 0x03, 0x03, 0x83, 0xc3, 0xe7, 0x7e, 0x3c, 0x30, 0x38,
+    0x3c, 0x3e, 0x33, 0x33, 0x31, 0x30, 0x30, 0x30, 0x03, 0x03, 0x03, 0x03, 0x33, 0x73, 0xcf, 0xcf,
+    0x87, 0x03, 0x0c, 0x1c, 0x38, 0x30, 0x30, 0x30, 0x30, 0x39, 0x1f, 0x0f, 0xc0, 0xe0, 0x30, 0x38,
+    0x0c, 0x8e, 0xff, 0xff, 0x80, 0x00, 0x01, 0x03, 0x03, 0x03, 0x03, 0x07, 0x3f, 0x3f, 0x07, 0x03,
+    0x1e, 0x3f, 0x33, 0x33, 0x33, 0x33, 0x33, 0x73, 0xe3, 0xc3, 0x0c, 0x1c, 0x38, 0x30, 0x30, 0x30,
+    0x30, 0x38, 0x1f, 0x0f, 0xf0, 0xf8, 0xcc, 0xce, 0xc7, 0xc3, 0xc3, 0xc3, 0x80, 0x00, 0x0f, 0x1f,
+    0x39, 0x30, 0x30, 0x30, 0x30, 0x39, 0x1f, 0x0f, 0x03, 0x03, 0x03, 0x83, 0xc3, 0xe3, 0x73, 0x33,
+    0x1f, 0x0e, 0x00, 0x00, 0x3f, 0x3f, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x3e, 0xe7, 0xc3,
+    0xc3, 0xc3, 0xc3, 0xe7, 0x3e, 0x3c, 0x0f, 0x1f, 0x39, 0x30, 0x30, 0x30, 0x30, 0x39, 0x1f, 0x0f,
+    0x3c, 0x7e, 0xe7, 0xc3, 0xc3, 0xc3, 0xc3, 0xe7, 0xfe, 0xfc, 0x00, 0x00, 0x30, 0x30, 0x30, 0x38,
+    0x1c, 0x0c, 0x07, 0x03, 0x18, 0x3c, 0x3c, 0x18, 0x06, 0x0f, 0x0f, 0x06, 0x18, 0x3c, 0x3c, 0x18,
+    0x33, 0x33, 0x1f, 0x0e, 0xc0, 0xe0, 0x30, 0x38, 0x1c, 0x0e, 0x07, 0x03, 0x00, 0x01, 0x03, 0x07,
+    0x0e, 0x1c, 0x38, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x03, 0x03,
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x07, 0x0e, 0x1c, 0x38, 0x30, 0xe0, 0xc0,
+    0x30, 0x38, 0x1c, 0x0e, 0x07, 0x03, 0x01, 0x00, 0x0c, 0x0e, 0x07, 0x03, 0x03, 0x83, 0xc3, 0xe7,
+    0x7e, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x33, 0x33, 0x01, 0x00, 0x00, 0x00, 0x0c, 0x8e, 0xc7, 0xc3,
+    0xc3, 0x83, 0x03, 0x07, 0xfe, 0xfc, 0x0f, 0x1f, 0x38, 0x30, 0x31, 0x33, 0x33, 0x33, 0x1f, 0x0f,
+    0xf0, 0xf8, 0x9c, 0x0e, 0x03, 0x03, 0x0e, 0x9c, 0xf8, 0xf0, 0x3f, 0x3f, 0x07, 0x03, 0x03, 0x03,
+    0x03, 0x07, 0x3f, 0x3f, 0xfe, 0xff, 0xe7, 0xc3, 0xc3, 0xc3, 0xc3, 0xe7, 0x3e, 0x3c, 0x1f, 0x3f,
+    0x39, 0x30, 0x30, 0x30, 0x30, 0x39, 0x1f, 0x0f, 0xfc, 0xfe, 0x07, 0x03, 0x03, 0x03, 0x03, 0x07,
+    0x0e, 0x0c, 0x0f, 0x1f, 0x38, 0x30, 0x30, 0x30, 0x30, 0x38, 0x1c, 0x0c, 0xfe, 0xff, 0x07, 0x03,
+    0x03, 0x07, 0x0e, 0x1c, 0xf8, 0xf0, 0x1f, 0x3f, 0x38, 0x30, 0x30, 0x38, 0x1c, 0x0e, 0x07, 0x03,
+    0xfe, 0xff, 0xe7, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0x03, 0x03, 0x1f, 0x3f, 0x39, 0x30, 0x30, 0x30,
+    0x30, 0x30, 0x30, 0x30, 0xfe, 0xff, 0xe7, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0x03, 0x03, 0x3f, 0x3f,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0xfe, 0x07, 0x03, 0xc3, 0xc3, 0xc3, 0xc7,
+    0xce, 0x8c, 0x0f, 0x1f, 0x38, 0x30, 0x30, 0x30, 0x30, 0x39, 0x3f, 0x1f, 0xff, 0xff, 0xe0, 0xc0,
+    0xc0, 0xc0, 0xc0, 0xe0, 0xff, 0xff, 0x3f, 0x3f, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x3f, 0x3f,
+    0x03, 0x07, 0xff, 0xff, 0x07, 0x03, 0x30, 0x38, 0x3f, 0x3f, 0x38, 0x30, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x07, 0xff, 0xff, 0x07, 0x03, 0x0c, 0x1c, 0x38, 0x30, 0x30, 0x38, 0x1f, 0x0f, 0x00, 0x00,
+    0xff, 0xff, 0xc0, 0xc0, 0x30, 0x38, 0x1c, 0x0e, 0x07, 0x03, 0x3f, 0x3f, 0x00, 0x00, 0x03, 0x07,
+    0x0e, 0x1c, 0x38, 0x30, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x3f,
+    0x38, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0xff, 0xff, 0x0e, 0x0c, 0xf0, 0xf0, 0x0c, 0x0e,
+    0xff, 0xff, 0x3f, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x3f, 0xff, 0xff, 0x38, 0x30,
+    0xe0, 0xc0, 0x00, 0x00, 0xff, 0xff, 0x3f, 0x3f, 0x00, 0x00, 0x00, 0x01, 0x03, 0x07, 0x3f, 0x3f,
+    0xfc, 0xfe, 0x07, 0x03, 0x03, 0x03, 0x03, 0x07, 0xfe, 0xfc, 0x0f, 0x1f, 0x38, 0x30, 0x30, 0x30,
+    0x30, 0x38, 0x1f, 0x0f, 0xfe, 0xff, 0xe7, 0xc3, 0xc3, 0xc3, 0xc3, 0xe7, 0x7e, 0x3c, 0x3f, 0x3f,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0xfe, 0x07, 0x03, 0x03, 0x03, 0x03, 0x07,
+    0xfe, 0xfc, 0x0f, 0x1f, 0x38, 0x30, 0x33, 0x33, 0x0c, 0x0c, 0x33, 0x33, 0xfe, 0xff, 0xe7, 0xc3,
+    0xc3, 0xc3, 0xc3, 0xe7, 0x7e, 0x3c, 0x3f, 0x3f, 0x00, 0x00, 0x03, 0x07, 0x0c, 0x1c, 0x38, 0x30,
+    0x3c, 0x7e, 0xe7, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0x83, 0x03, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x30, 0x39, 0x1f, 0x0f, 0x03, 0x03, 0x03, 0x07, 0xff, 0xff, 0x07, 0x03, 0x03, 0x03, 0x00, 0x00,
+    0x00, 0x00, 0x3f, 0x3f, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xff, 0x0f, 0x1f, 0x38, 0x30, 0x30, 0x30, 0x30, 0x38, 0x1f, 0x0f, 0xff, 0xff, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x03, 0x07, 0x0e, 0x1c, 0x30, 0x30, 0x1c, 0x0e, 0x07, 0x03,
+    0xff, 0xff, 0x00, 0x00, 0xc0, 0xc0, 0x00, 0x00, 0xff, 0xff, 0x0f, 0x1f, 0x30, 0x30, 0x0f, 0x0f,
+    0x30, 0x30, 0x1f, 0x0f, 0x0f, 0x1f, 0x38, 0x30, 0xc0, 0xc0, 0x30, 0x38, 0x1f, 0x0f, 0x3c, 0x3e,
+    0x07, 0x03, 0x00, 0x00, 0x03, 0x07, 0x3e, 0x3c, 0x3f, 0x7f, 0xe0, 0xc0, 0x00, 0x00, 0xc0, 0xe0,
+    0x7f, 0x3f, 0x00, 0x00, 0x00, 0x01, 0x3f, 0x3f, 0x01, 0x00, 0x00, 0x00, 0x03, 0x03, 0x03, 0x83,
+    0xc3, 0xe3, 0x73, 0x33, 0x1f, 0x0e, 0x1c, 0x3e, 0x33, 0x33, 0x31, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0xfe, 0xff, 0x07, 0x03, 0x03, 0x03, 0x1f, 0x3f, 0x38, 0x30, 0x30, 0x30, 0x33, 0x33, 0xcc, 0xcc,
+    0x33, 0x33, 0xcc, 0xcc, 0x33, 0x33, 0x33, 0x33, 0x0c, 0x0c, 0x33, 0x33, 0x0c, 0x0c, 0x33, 0x33,
+    0x03, 0x03, 0x03, 0x07, 0xff, 0xfe, 0x30, 0x30, 0x30, 0x38, 0x3f, 0x1f, 0x30, 0x38, 0x1c, 0x0e,
+    0x03, 0x03, 0x0e, 0x1c, 0x38, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x30, 0x30, 0x30, 0x30, 0x03, 0x07, 0x0e, 0x1c, 0x38, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0xe0, 0xc0, 0x0c, 0x1e, 0x33, 0x33, 0x33, 0x33,
+    0x33, 0x33, 0x3f, 0x1f, 0xff, 0xff, 0xc0, 0xc0, 0x70, 0x30, 0x30, 0x70, 0xe0, 0xc0, 0x1f, 0x3f,
+    0x39, 0x30, 0x30, 0x30, 0x30, 0x38, 0x1f, 0x0f, 0xc0, 0xe0, 0x70, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x00, 0x00, 0x0f, 0x1f, 0x38, 0x30, 0x30, 0x30, 0x30, 0x38, 0x1c, 0x0c, 0xc0, 0xe0, 0x70, 0x30,
+    0x30, 0x70, 0xc0, 0xc0, 0xff, 0xff, 0x0f, 0x1f, 0x38, 0x30, 0x30, 0x30, 0x30, 0x39, 0x3f, 0x1f,
+    0xc0, 0xe0, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0xe0, 0xc0, 0x0f, 0x1f, 0x33, 0x33, 0x33, 0x33,
+    0x33, 0x33, 0x03, 0x01, 0xc0, 0xe0, 0xfc, 0xfe, 0xe7, 0xc3, 0x03, 0x07, 0x0e, 0x0c, 0x00, 0x01,
+    0x3f, 0x3f, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0, 0xe0, 0x70, 0x30, 0x30, 0x30, 0x30, 0x70,
+    0xf0, 0xe0, 0x03, 0x07, 0xce, 0xcc, 0xcc, 0xcc, 0xcc, 0xce, 0x7f, 0x3f, 0xff, 0xff, 0xc0, 0xc0,
+    0x70, 0x30, 0x30, 0x70, 0xe0, 0xc0, 0x3f, 0x3f, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x3f,
+    0x30, 0x70, 0xf3, 0xe3, 0x00, 0x00, 0x30, 0x38, 0x3f, 0x3f, 0x38, 0x30, 0x00, 0x00, 0x00, 0x00,
+    0x30, 0x70, 0xf3, 0xe3, 0x30, 0x70, 0xe0, 0xc0, 0xc0, 0xe0, 0x7f, 0x3f, 0xff, 0xff, 0x00, 0x00,
+    0xc0, 0xe0, 0x70, 0x30, 0x3f, 0x3f, 0x03, 0x03, 0x0c, 0x1c, 0x38, 0x30, 0x03, 0x07, 0xff, 0xfe,
+    0x00, 0x00, 0x30, 0x38, 0x3f, 0x3f, 0x38, 0x30, 0xe0, 0xf0, 0x30, 0x30, 0xc0, 0xc0, 0x30, 0x30,
+    0xe0, 0xc0, 0x3f, 0x3f, 0x00, 0x00, 0x03, 0x03, 0x00, 0x00, 0x3f, 0x3f, 0xf0, 0xf0, 0xc0, 0xc0,
+    0x70, 0x30, 0x30, 0x70, 0xe0, 0xc0, 0x3f, 0x3f, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x3f,
+    0xc0, 0xe0, 0x70, 0x30, 0x30, 0x30, 0x30, 0x70, 0xe0, 0xc0, 0x0f, 0x1f, 0x38, 0x30, 0x30, 0x30,
+    0x30, 0x38, 0x1f, 0x0f, 0xe0, 0xf0, 0x70, 0x30, 0x30, 0x30, 0x30, 0x70, 0xe0, 0xc0, 0xff, 0xff,
+    0x1e, 0x0c, 0x0c, 0x0c, 0x0c, 0x0e, 0x07, 0x03, 0xc0, 0xe0, 0x70, 0x30, 0x30, 0x70, 0x80, 0xc0,
+    0xf0, 0xf0, 0x03, 0x07, 0x0e, 0x0c, 0x0c, 0x0e, 0x01, 0x03, 0xff, 0xff, 0xf0, 0xf0, 0xc0, 0xc0,
+    0x70, 0x30, 0x30, 0x70, 0xe0, 0xc0, 0x3f, 0x3f, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xc0, 0xe0, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x00, 0x00, 0x30, 0x31, 0x33, 0x33, 0x33, 0x33,
+    0x33, 0x33, 0x1e, 0x0c, 0x30, 0x78, 0xff, 0xff, 0x78, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x0f, 0x1f, 0x38, 0x30, 0x30, 0x38, 0x1c, 0x0c, 0xf0, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xf0, 0xf0, 0x0f, 0x1f, 0x38, 0x30, 0x30, 0x38, 0x0c, 0x0e, 0x3f, 0x3f, 0xf0, 0xf0, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xf0, 0xf0, 0x03, 0x07, 0x0e, 0x1c, 0x30, 0x30, 0x1c, 0x0e, 0x07, 0x03,
+    0xf0, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0xf0, 0x0f, 0x1f, 0x30, 0x30, 0x0f, 0x0f,
+    0x30, 0x30, 0x1f, 0x0f, 0x30, 0x70, 0xe0, 0xc0, 0x00, 0x00, 0xc0, 0xe0, 0x70, 0x30, 0x30, 0x38,
+    0x1c, 0x0c, 0x03, 0x03, 0x0c, 0x1c, 0x38, 0x30, 0xf0, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xf0, 0xf0, 0x03, 0x07, 0xce, 0xcc, 0xcc, 0xcc, 0xcc, 0xce, 0x7f, 0x3f, 0x30, 0x30, 0x30, 0x30,
+    0x30, 0x30, 0xf0, 0xf0, 0x70, 0x30, 0x30, 0x38, 0x3c, 0x3e, 0x33, 0x33, 0x31, 0x30, 0x30, 0x30,
+    0xc0, 0xe0, 0x3f, 0x3f, 0x00, 0x01, 0x3f, 0x3f, 0xff, 0xff, 0x3f, 0x3f, 0x3f, 0x3f, 0xe0, 0xc0,
+    0x3f, 0x3f, 0x01, 0x00, 0x00, 0x80, 0xc0, 0xc0, 0x00, 0x00, 0xc0, 0xc0, 0x03, 0x03, 0x00, 0x00,
+    0x03, 0x03, 0x01, 0x00,
+};
+
+static const font_kern_t sans16_kerning[236] = {
+    { ',', 'T', -2 }, { ',', 'V', -1 }, { ',', 'Y', -2 }, { ',', 'f', -2 }, { ',', 'g', -1 }, { ',', 'q', -1 },
+    { ',', 't', -2 }, { ',', 'v', -1 }, { ',', 'y', -1 }, { '.', 'T', -2 }, { '.', 'V', -1 }, { '.', 'Y', -2 },
+    { '.', 'f', -2 }, { '.', 'g', -1 }, { '.', 'q', -1 }, { '.', 't', -2 }, { '.', 'v', -1 }, { '.', 'y', -1 },
+    { 'A', 'T', -2 }, { 'C', 'f', -2 }, { 'D', '.', -1 }, { 'D', 'I', -2 }, { 'D', 'T', -2 }, { 'D', 'j', -2 },
+    { 'D', 'l', -2 }, { 'E', 'f', -2 }, { 'E', 'g', -2 }, { 'E', 'q', -2 }, { 'E', 't', -2 }, { 'E', 'v', -2 },
+    { 'E', 'y', -2 }, { 'F', ',', -2 }, { 'F', '.', -2 }, { 'F', 'A', -2 }, { 'F', 'J', -2 }, { 'F', 'a', -2 },
+    { 'F', 'c', -2 }, { 'F', 'd', -2 }, { 'F', 'e', -2 }, { 'F', 'f', -2 }, { 'F', 'g', -2 }, { 'F', 'i', -2 },
+    { 'F', 'j', -2 }, { 'F', 'm', -2 }, { 'F', 'n', -2 }, { 'F', 'o', -2 }, { 'F', 'p', -2 }, { 'F', 'q', -2 },
+    { 'F', 'r', -2 }, { 'F', 's', -2 }, { 'F', 't', -2 }, { 'F', 'u', -2 }, { 'F', 'v', -2 }, { 'F', 'w', -2 },
+    { 'F', 'x', -2 }, { 'F', 'y', -2 }, { 'F', 'z', -2 }, { 'I', 'f', -2 }, { 'I', 'g', -2 }, { 'I', 'q', -2 },
+    { 'I', 't', -2 }, { 'I', 'v', -2 }, { 'I', 'y', -2 }, { 'J', ',', -2 }, { 'J', '.', -2 }, { 'J', 'A', -2 },
+    { 'J', 'J', -2 }, { 'J', 'a', -2 }, { 'J', 'c', -2 }, { 'J', 'd', -2 }, { 'J', 'e', -2 }, { 'J', 'f', -2 },
+    { 'J', 'g', -2 }, { 'J', 'i', -2 }, { 'J', 'j', -2 }, { 'J', 'm', -2 }, { 'J', 'n', -2 }, { 'J', 'o', -2 },
+    { 'J', 'p', -2 }, { 'J', 'q', -2 }, { 'J', 'r', -2 }, { 'J', 's', -2 }, { 'J', 't', -2 }, { 'J', 'u', -2 },
+    { 'J', 'v', -2 }, { 'J', 'w', -2 }, { 'J', 'x', -2 }, { 'J', 'y', -2 }, { 'J', 'z', -2 }, { 'K', 'f', -2 },
+    { 'K', 'g', -2 }, { 'K', 'q', -2 }, { 'K', 't', -2 }, { 'K', 'v', -2 }, { 'K', 'y', -2 }, { 'L', 'T', -2 },
+    { 'L', 'V', -2 }, { 'L', 'Y', -2 }, { 'L', 'f', -2 }, { 'L', 'g', -2 }, { 'L', 'q', -2 }, { 'L', 't', -2 },
+    { 'L', 'v', -2 }, { 'L', 'y', -2 }, { 'P', ',', -2 }, { 'P', '.', -2 }, { 'P', 'J', -2 }, { 'P', 'a', -2 },
+    { 'P', 'j', -2 }, { 'S', 't', -2 }, { 'T', ',', -2 }, { 'T', '.', -2 }, { 'T', 'A', -2 }, { 'T', 'J', -2 },
+    { 'T', 'a', -2 }, { 'T', 'c', -2 }, { 'T', 'd', -2 }, { 'T', 'e', -2 }, { 'T', 'f', -2 }, { 'T', 'g', -2 },
+    { 'T', 'i', -2 }, { 'T', 'j', -2 }, { 'T', 'm', -2 }, { 'T', 'n', -2 }, { 'T', 'o', -2 }, { 'T', 'p', -2 },
+    { 'T', 'q', -2 }, { 'T', 'r', -2 }, { 'T', 's', -2 }, { 'T', 't', -2 }, { 'T', 'u', -2 }, { 'T', 'v', -2 },
+    { 'T', 'w', -2 }, { 'T', 'x', -2 }, { 'T', 'y', -2 }, { 'T', 'z', -2 }, { 'V', '.', -1 }, { 'V', 'j', -2 },
+    { 'X', 'f', -2 }, { 'Y', ',', -2 }, { 'Y', '.', -2 }, { 'Y', 'J', -2 }, { 'Y', 'a', -2 }, { 'Y', 'j', -2 },
+    { 'Z', 'f', -2 }, { 'Z', 'g', -2 }, { 'Z', 'q', -2 }, { 'a', 'T', -2 }, { 'b', 'T', -2 }, { 'c', 'T', -2 },
+    { 'c', 'Y', -2 }, { 'c', 'f', -2 }, { 'c', 't', -2 }, { 'e', ',', -1 }, { 'e', '.', -2 }, { 'e', 'I', -2 },
+    { 'e', 'J', -1 }, { 'e', 'T', -2 }, { 'e', 'X', -1 }, { 'e', 'Z', -1 }, { 'e', 'a', -1 }, { 'e', 'j', -2 },
+    { 'e', 'l', -2 }, { 'f', ',', -2 }, { 'f', '.', -2 }, { 'f', 'J', -2 }, { 'f', 'a', -2 }, { 'f', 'c', -2 },
+    { 'f', 'd', -2 }, { 'f', 'e', -2 }, { 'f', 'f', -2 }, { 'f', 'g', -2 }, { 'f', 'j', -2 }, { 'f', 'm', -1 },
+    { 'f', 'o', -2 }, { 'f', 'p', -1 }, { 'f', 'q', -2 }, { 'f', 's', -2 }, { 'g', 'T', -2 }, { 'h', 'T', -2 },
+    { 'i', 'T', -2 }, { 'i', 'V', -2 }, { 'i', 'Y', -2 }, { 'i', 'f', -2 }, { 'i', 'g', -2 }, { 'i', 'q', -2 },
+    { 'i', 't', -2 }, { 'i', 'v', -2 }, { 'i', 'y', -2 }, { 'k', 'T', -2 }, { 'l', 'T', -2 }, { 'l', 'V', -2 },
+    { 'l', 'Y', -2 }, { 'l', 'f', -2 }, { 'l', 'g', -2 }, { 'l', 'q', -2 }, { 'l', 't', -2 }, { 'l', 'v', -2 },
+    { 'l', 'y', -2 }, { 'm', 'T', -2 }, { 'n', 'T', -2 }, { 'o', 'T', -2 }, { 'p', '.', -1 }, { 'p', 'I', -2 },
+    { 'p', 'T', -2 }, { 'p', 'j', -2 }, { 'p', 'l', -2 }, { 'q', 'T', -2 }, { 'r', ',', -2 }, { 'r', '.', -2 },
+    { 'r', 'I', -2 }, { 'r', 'J', -2 }, { 'r', 'T', -2 }, { 'r', 'X', -2 }, { 'r', 'Z', -2 }, { 'r', 'a', -2 },
+    { 'r', 'j', -2 }, { 'r', 'l', -2 }, { 's', 'T', -2 }, { 's', 'Y', -2 }, { 's', 'f', -2 }, { 's', 't', -2 },
+    { 't', 'T', -2 }, { 't', 'Y', -2 }, { 't', 'f', -2 }, { 't', 't', -2 }, { 'u', 'T', -2 }, { 'v', '.', -1 },
+    { 'v', 'I', -2 }, { 'v', 'T', -2 }, { 'v', 'j', -2 }, { 'v', 'l', -2 }, { 'w', 'T', -2 }, { 'x', 'T', -2 },
+    { 'y', 'T', -2 }, { 'z', 'T', -2 },
+};
+
+const font_t sans16 = {
+    16, 2, 32, 126,
+    sans16_offsets, sans16_glyphs, NULL,
+    sans16_kerning, 236
+};
+
+static const uint16_t sans8_offsets[96] = {
+    0, 3, 4, 7, 12, 17, 22, 27, 29, 32, 35, 40, 45, 47, 52, 54,
+    59, 64, 69, 74, 79, 84, 89, 94, 99, 104, 109, 111, 113, 117, 122, 126,
+    131, 136, 141, 146, 151, 156, 161, 166, 171, 176, 179, 184, 189, 194, 199, 204,
+    209, 214, 219, 224, 229, 234, 239, 244, 249, 254, 259, 264, 267, 272, 275, 280,
+    285, 288, 293, 298, 303, 308, 313, 318, 323, 328, 331, 335, 339, 342, 347, 352,
+    357, 362, 367, 372, 377, 382, 387, 392, 397, 402, 407, 412, 414, 415, 417, 421,
+};
 
-const uint8_t gfx_test[96*64/8]={
-    0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xfe,0xff,0xff,0xff
-    ,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xfc,0xff,0xff,0xff
-    ,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xf3,0xf8,0xff,0xff,0xff
-    ,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xe1,0xf0,0xff,0xff,0xff
-    ,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xe0,0xf0,0xe3,0xff,0xf8
-    ,0xff,0xff,0xff,0xff,0xff,0xff,0xf8,0xcc,0x06,0xc3,0xff,0xe0
-    ,0xff,0xdf,0xff,0xff,0xff,0xff,0xe0,0x0f,0x06,0x1b,0xff,0x81
-    ,0xfc,0x00,0xff,0xff,0xff,0xff,0x87,0x0f,0xff,0x98,0xfe,0x43
-    ,0xf8,0xfc,0x7f,0xff,0xff,0xff,0x83,0xef,0xff,0x82,0x7c,0x4f
-    ,0xf3,0xff,0x3f,0xff,0xff,0xff,0xf1,0x9f,0xff,0x87,0x02,0x9f
-    ,0xe7,0xff,0xdf,0xff,0xff,0xff,0xc1,0x7f,0xdf,0xb2,0x02,0x3f
-    ,0xef,0xff,0xcf,0xff,0xff,0xff,0x8f,0xff,0xdf,0x7a,0x52,0x7f
-    ,0xef,0xff,0xe7,0xf8,0x3f,0xff,0x3f,0xff,0xbe,0x7c,0x51,0xff
-    ,0xef,0xe7,0xb7,0xc0,0x01,0xff,0x3f,0xfd,0xb6,0x7c,0x53,0xff
-    ,0xee,0xdf,0xd3,0x0f,0xf8,0x3f,0x3f,0xba,0x66,0xfe,0x00,0x3f
-    ,0xee,0xd8,0x68,0x3f,0xff,0x1f,0x03,0x75,0xc2,0x72,0x70,0x3f
-    ,0xe6,0xb0,0x04,0x7f,0xff,0xc6,0x02,0xff,0x86,0xf1,0xf0,0xff
-    ,0xe7,0xa7,0x0c,0xff,0xff,0xe0,0x4f,0xff,0x30,0xe0,0xe3,0xff
-    ,0xf3,0xe7,0x99,0xff,0xff,0xff,0xd9,0xe6,0x71,0xf1,0xe3,0xff
-    ,0xf3,0xef,0xc1,0xff,0xff,0xff,0x99,0xe4,0xfe,0xf9,0xef,0xff
-    ,0xf9,0xe7,0xf3,0xff,0xff,0xff,0x9f,0xc4,0xfe,0x7f,0xcf,0xff
-    ,0xfd,0xa7,0xf3,0xff,0xff,0xff,0x9f,0xc4,0xfe,0x7f,0xdf,0xff
-    ,0xfd,0xa7,0xf7,0xff,0xff,0xff,0x90,0xd4,0xfc,0x7f,0xcf,0xff
-    ,0x7d,0xf7,0xe7,0xff,0xff,0xff,0x81,0x90,0xfd,0x3f,0xcf,0xff
-    ,0x3c,0xf7,0xe7,0xff,0xff,0xff,0xc1,0x38,0xfd,0x9f,0xcf,0xff
-    ,0x1d,0xe7,0xe7,0xff,0xff,0xff,0xc2,0x3f,0xfd,0x9f,0xcf,0xff
-    ,0x01,0xe7,0xe7,0xff,0xff,0xff,0xf0,0x7f,0xfd,0xc7,0xcf,0xff
-    ,0x1f,0xcf,0xe7,0xff,0xff,0xff,0xe0,0xff,0xfc,0xc6,0xcf,0xff
-    ,0x3f,0x9f,0xe7,0xff,0xff,0xff,0xe1,0xff,0xfc,0xe6,0xdf,0xff
-    ,0x8c,0x3f,0xe7,0xff,0xff,0xff,0xe3,0xff,0xfc,0xe7,0x9f,0xff
-    ,0xe0,0xff,0xc7,0xff,0xfb,0xff,0xe3,0xff,0xfc,0xf8,0x3f,0xff
-    ,0xff,0xe0,0x0f,0xff,0xf3,0xff,0xff,0xff,0xfc,0xfc,0xff,0xff
-    ,0xff,0xe7,0xff,0xff,0xf7,0xff,0xff,0xff,0xfd,0xff,0xff,0xff
-    ,0xff,0xcf,0xff,0xff,0xf7,0xff,0xff,0xff,0xf9,0xff,0xff,0xff
-    ,0xff,0xcf,0xff,0xff,0xf7,0xff,0xff,0xff,0xf9,0xff,0xff,0xff
-    ,0xff,0xcf,0xff,0xff,0xe7,0xff,0xff,0x3f,0xfc,0xff,0xff,0xff
-    ,0xff,0xcf,0xff,0xff,0xe3,0xff,0xff,0x9f,0xf6,0x7f,0xff,0xff
-    ,0xff,0xef,0xff,0xff,0x80,0xff,0xff,0x9f,0xf3,0x3f,0xff,0xff
-    ,0xff,0xe7,0xff,0xff,0x1e,0x3f,0xff,0xcf,0xf3,0x9f,0xff,0xff
-    ,0xff,0xe7,0xe7,0xfc,0x7f,0x80,0x3f,0x87,0xfb,0x9f,0xff,0xff
-    ,0xff,0xf7,0xc0,0x01,0xff,0xe0,0x00,0x03,0xf9,0xcf,0xff,0xff
-    ,0xff,0xf3,0xce,0x07,0xff,0xff,0xff,0xf8,0x7c,0xe7,0xff,0xff
-    ,0xff,0xf3,0xcf,0xbf,0xff,0xff,0xff,0xfc,0x0e,0x77,0xff,0xff
-    ,0xff,0xf9,0xcf,0x9f,0xff,0xff,0xff,0xff,0x87,0x13,0xff,0xff
-    ,0xff,0xf9,0xef,0xdf,0xff,0xff,0xff,0xff,0xf3,0x99,0xff,0xff
-    ,0xff,0xf9,0xe7,0xcf,0xff,0xff,0xff,0xff,0xf3,0xc9,0xff,0xff
-    ,0xff,0xfd,0xe7,0xcf,0xff,0xff,0xff,0xff,0xf3,0xc9,0xff,0xff
-    ,0xff,0xfc,0xf7,0xe7,0xff,0xff,0xff,0xff,0xf3,0xc9,0xff,0xff
-    ,0xff,0xfc,0xf3,0xe7,0xff,0xff,0xff,0xff,0xf7,0xc3,0xff,0xff
-    ,0xff,0xfc,0xf3,0xf7,0xff,0xff,0xff,0xff,0xe7,0x07,0xff,0xff
-    ,0xff,0xfc,0xf9,0xf3,0xff,0xff,0xff,0xff,0xc6,0x07,0xff,0xff
-    ,0xff,0xfc,0xf9,0xfb,0xff,0xff,0xff,0xff,0x8c,0xcf,0xff,0xff
-    ,0xff,0xfc,0xfc,0xf3,0xff,0xff,0xff,0xe0,0x3c,0xcf,0xff,0xff
-    ,0xff,0xfe,0x7c,0xf3,0xff,0xff,0xff,0xe0,0x79,0x9f,0xff,0xff
-    ,0xff,0xfe,0x79,0xe7,0xff,0xff,0xff,0xcb,0xf9,0x1f,0xff,0xff
-    ,0xff,0xfe,0x79,0xe7,0xff,0xff,0xff,0xcb,0xf2,0x3f,0xff,0xff
-    ,0xff,0xfc,0x79,0x27,0xff,0xff,0xff,0x92,0x60,0x7f,0xff,0xff
-    ,0xff,0xfc,0x38,0xc7,0xff,0xff,0xff,0x80,0x00,0xff,0xff,0xff
-    ,0xff,0xfc,0xc1,0xe7,0xff,0xff,0xff,0x83,0xff,0xff,0xff,0xff
-    ,0xff,0xfc,0xf0,0x67,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xfe,0x72,0x27,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xff,0x17,0x07,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xff,0x87,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff
-    ,0xff,0xff,0xef,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff
+static const uint8_t sans8_glyphs[421] = {
+    0x00, 0x00, 0x00, 0x2f, 0x07, 0x00, 0x07, 0x14, 0x7f, 0x14, 0x7f, 0x14, 0x24, 0x2a, 0x7f, 0x2a,
+    0x12, 0x23, 0x13, 0x08, 0x64, 0x62, 0x36, 0x49, 0x55, 0x22, 0x50, 0x05, 0x03, 0x1c, 0x22, 0x41,
+    0x41, 0x22, 0x1c, 0x14, 0x08, 0x3e, 0x08, 0x14, 0x08, 0x08, 0x3e, 0x08, 0x08, 0xa0, 0x60, 0x08,
+    0x08, 0x08, 0x08, 0x08, 0x60, 0x60, 0x20, 0x10, 0x08, 0x04, 0x02, 0x3e, 0x51, 0x49, 0x45, 0x3e,
+    0x00, 0x42, 0x7f, 0x40, 0x00, 0x42, 0x61, 0x51, 0x49, 0x46, 0x21, 0x41, 0x45, 0x4b, 0x31, 0x18,
+    0x14, 0x12, 0x7f, 0x10, 0x27, 0x45, 0x45, 0x45, 0x39, 0x3c, 0x4a, 0x49, 0x49, 0x30, 0x01, 0x71,
+    0x09, 0x05, 0x03, 0x36, 0x49, 0x49, 0x49, 0x36, 0x06, 0x49, 0x49, 0x29, 0x1e, 0x36, 0x36, 0x56,
+    0x36, 0x08, 0x14, 0x22, 0x41, 0x14, 0x14, 0x14, 0x14, 0x14, 0x41, 0x22, 0x14, 0x08, 0x02, 0x01,
+    0x51, 0x09, 0x06, 0x32, 0x49, 0x59, 0x51, 0x3e, 0x7c, 0x12, 0x11, 0x12, 0x7c, 0x7f, 0x49, 0x49,
+    0x49, 0x36, 0x3e, 0x41, 0x41, 0x41, 0x22, 0x7f, 0x41, 0x41, 0x22, 0x1c, 0x7f, 0x49, 0x49, 0x49,
+    0x41, 0x7f, 0x09, 0x09, 0x09, 0x01, 0x3e, 0x41, 0x49, 0x49, 0x7a, 0x7f, 0x08, 0x08, 0x08, 0x7f,
+    0x41, 0x7f, 0x41, 0x20, 0x40, 0x41, 0x3f, 0x01, 0x7f, 0x08, 0x14, 0x22, 0x41, 0x7f, 0x40, 0x40,
+    0x40, 0x40, 0x7f, 0x02, 0x0c, 0x02, 0x7f, 0x7f, 0x04, 0x08, 0x10, 0x7f, 0x3e, 0x41, 0x41, 0x41,
+    0x3e, 0x7f, 0x09, 0x09, 0x09, 0x06, 0x3e, 0x41, 0x51, 0x21, 0x5e, 0x7f, 0x09, 0x19, 0x29, 0x46,
+    0x46, 0x49, 0x49, 0x49, 0x31, 0x01, 0x01, 0x7f, 0x01, 0x01, 0x3f, 0x40, 0x40, 0x40, 0x3f, 0x1f,
+    0x20, 0x40, 0x20, 0x1f, 0x3f, 0x40, 0x38, 0x40, 0x3f, 0x63, 0x14, 0x08, 0x14, 0x63, 0x07, 0x08,
+    0x70, 0x08, 0x07, 0x61, 0x51, 0x49, 0x45, 0x43, 0x7f, 0x41, 0x41, 0x55, 0x2a, 0x55, 0x2a, 0x55,
+    0x41, 0x41, 0x7f, 0x04, 0x02, 0x01, 0x02, 0x04, 0x40, 0x40, 0x40, 0x40, 0x40, 0x01, 0x02, 0x04,
+    0x20, 0x54, 0x54, 0x54, 0x78, 0x7f, 0x48, 0x44, 0x44, 0x38, 0x38, 0x44, 0x44, 0x44, 0x20, 0x38,
+    0x44, 0x44, 0x48, 0x7f, 0x38, 0x54, 0x54, 0x54, 0x18, 0x08, 0x7e, 0x09, 0x01, 0x02, 0x18, 0xa4,
+    0xa4, 0xa4, 0x7c, 0x7f, 0x08, 0x04, 0x04, 0x78, 0x44, 0x7d, 0x40, 0x40, 0x80, 0x84, 0x7d, 0x7f,
+    0x10, 0x28, 0x44, 0x41, 0x7f, 0x40, 0x7c, 0x04, 0x18, 0x04, 0x78, 0x7c, 0x08, 0x04, 0x04, 0x78,
+    0x38, 0x44, 0x44, 0x44, 0x38, 0xfc, 0x24, 0x24, 0x24, 0x18, 0x18, 0x24, 0x24, 0x18, 0xfc, 0x7c,
+    0x08, 0x04, 0x04, 0x08, 0x48, 0x54, 0x54, 0x54, 0x20, 0x04, 0x3f, 0x44, 0x40, 0x20, 0x3c, 0x40,
+    0x40, 0x20, 0x7c, 0x1c, 0x20, 0x40, 0x20, 0x1c, 0x3c, 0x40, 0x30, 0x40, 0x3c, 0x44, 0x28, 0x10,
+    0x28, 0x44, 0x1c, 0xa0, 0xa0, 0xa0, 0x7c, 0x44, 0x64, 0x54, 0x4c, 0x44, 0x08, 0x77, 0x7f, 0x77,
+    0x08, 0x10, 0x08, 0x10, 0x08,
 };
+
+static const uint8_t sans8_inverted[421] = {
+    0xff, 0xff, 0xff, 0xd0, 0xf8, 0xff, 0xf8, 0xeb, 0x80, 0xeb, 0x80, 0xeb, 0xdb, 0xd5, 0x80, 0xd5,
+    0xed, 0xdc, 0xec, 0xf7, 0x9b, 0x9d, 0xc9, 0xb6, 0xaa, 0xdd, 0xaf, 0xfa, 0xfc, 0xe3, 0xdd, 0xbe,
+    0xbe, 0xdd, 0xe3, 0xeb, 0xf7, 0xc1, 0xf7, 0xeb, 0xf7, 0xf7, 0xc1, 0xf7, 0xf7, 0x5f, 0x9f, 0xf7,
+    0xf7, 0xf7, 0xf7, 0xf7, 0x9f, 0x9f, 0xdf, 0xef, 0xf7, 0xfb, 0xfd, 0xc1, 0xae, 0xb6, 0xba, 0xc1,
+    0xff, 0xbd, 0x80, 0xbf, 0xff, 0xbd, 0x9e, 0xae, 0xb6, 0xb9, 0xde, 0xbe, 0xba, 0xb4, 0xce, 0xe7,
+    0xeb, 0xed, 0x80, 0xef, 0xd8, 0xba, 0xba, 0xba, 0xc6, 0xc3, 0xb5, 0xb6, 0xb6, 0xcf, 0xfe, 0x8e,
+    0xf6, 0xfa, 0xfc, 0xc9, 0xb6, 0xb6, 0xb6, 0xc9, 0xf9, 0xb6, 0xb6, 0xd6, 0xe1, 0xc9, 0xc9, 0xa9,
+    0xc9, 0xf7, 0xeb, 0xdd, 0xbe, 0xeb, 0xeb, 0xeb, 0xeb, 0xeb, 0xbe, 0xdd, 0xeb, 0xf7, 0xfd, 0xfe,
+    0xae, 0xf6, 0xf9, 0xcd, 0xb6, 0xa6, 0xae, 0xc1, 0x83, 0xed, 0xee, 0xed, 0x83, 0x80, 0xb6, 0xb6,
+    0xb6, 0xc9, 0xc1, 0xbe, 0xbe, 0xbe, 0xdd, 0x80, 0xbe, 0xbe, 0xdd, 0xe3, 0x80, 0xb6, 0xb6, 0xb6,
+    0xbe, 0x80, 0xf6, 0xf6, 0xf6, 0xfe, 0xc1, 0xbe, 0xb6, 0xb6, 0x85, 0x80, 0xf7, 0xf7, 0xf7, 0x80,
+    0xbe, 0x80, 0xbe, 0xdf, 0xbf, 0xbe, 0xc0, 0xfe, 0x80, 0xf7, 0xeb, 0xdd, 0xbe, 0x80, 0xbf, 0xbf,
+    0xbf, 0xbf, 0x80, 0xfd, 0xf3, 0xfd, 0x80, 0x80, 0xfb, 0xf7, 0xef, 0x80, 0xc1, 0xbe, 0xbe, 0xbe,
+    0xc1, 0x80, 0xf6, 0xf6, 0xf6, 0xf9, 0xc1, 0xbe, 0xae, 0xde, 0xa1, 0x80, 0xf6, 0xe6, 0xd6, 0xb9,
+    0xb9, 0xb6, 0xb6, 0xb6, 0xce, 0xfe, 0xfe, 0x80, 0xfe, 0xfe, 0xc0, 0xbf, 0xbf, 0xbf, 0xc0, 0xe0,
+    0xdf, 0xbf, 0xdf, 0xe0, 0xc0, 0xbf, 0xc7, 0xbf, 0xc0, 0x9c, 0xeb, 0xf7, 0xeb, 0x9c, 0xf8, 0xf7,
+    0x8f, 0xf7, 0xf8, 0x9e, 0xae, 0xb6, 0xba, 0xbc, 0x80, 0xbe, 0xbe, 0xaa, 0xd5, 0xaa, 0xd5, 0xaa,
+    0xbe, 0xbe, 0x80, 0xfb, 0xfd, 0xfe, 0xfd, 0xfb, 0xbf, 0xbf, 0xbf, 0xbf, 0xbf, 0xfe, 0xfd, 0xfb,
+    0xdf, 0xab, 0xab, 0xab, 0x87, 0x80, 0xb7, 0xbb, 0xbb, 0xc7, 0xc7, 0xbb, 0xbb, 0xbb, 0xdf, 0xc7,
+    0xbb, 0xbb, 0xb7, 0x80, 0xc7, 0xab, 0xab, 0xab, 0xe7, 0xf7, 0x81, 0xf6, 0xfe, 0xfd, 0xe7, 0x5b,
+    0x5b, 0x5b, 0x83, 0x80, 0xf7, 0xfb, 0xfb, 0x87, 0xbb, 0x82, 0xbf, 0xbf, 0x7f, 0x7b, 0x82, 0x80,
+    0xef, 0xd7, 0xbb, 0xbe, 0x80, 0xbf, 0x83, 0xfb, 0xe7, 0xfb, 0x87, 0x83, 0xf7, 0xfb, 0xfb, 0x87,
+    0xc7, 0xbb, 0xbb, 0xbb, 0xc7, 0x03, 0xdb, 0xdb, 0xdb, 0xe7, 0xe7, 0xdb, 0xdb, 0xe7, 0x03, 0x83,
+    0xf7, 0xfb, 0xfb, 0xf7, 0xb7, 0xab, 0xab, 0xab, 0xdf, 0xfb, 0xc0, 0xbb, 0xbf, 0xdf, 0xc3, 0xbf,
+    0xbf, 0xdf, 0x83, 0xe3, 0xdf, 0xbf, 0xdf, 0xe3, 0xc3, 0xbf, 0xcf, 0xbf, 0xc3, 0xbb, 0xd7, 0xef,
+    0xd7, 0xbb, 0xe3, 0x5f, 0x5f, 0x5f, 0x83, 0xbb, 0x9b, 0xab, 0xb3, 0xbb, 0xf7, 0x88, 0x80, 0x88,
+    0xf7, 0xef, 0xf7, 0xef, 0xf7,
+};
+
+static const font_kern_t sans8_kerning[214] = {
+    { ',', 'T', -1 }, { ',', 'Y', -1 }, { ',', 'f', -1 }, { ',', 't', -1 }, { '.', 'T', -1 }, { '.', 'Y', -1 },
+    { '.', 'f', -1 }, { '.', 't', -1 }, { 'A', 'T', -1 }, { 'C', 'f', -1 }, { 'D', 'I', -1 }, { 'D', 'T', -1 },
+    { 'D', 'j', -1 }, { 'D', 'l', -1 }, { 'E', 'f', -1 }, { 'E', 'g', -1 }, { 'E', 'q', -1 }, { 'E', 't', -1 },
+    { 'E', 'v', -1 }, { 'E', 'y', -1 }, { 'F', ',', -1 }, { 'F', '.', -1 }, { 'F', 'A', -1 }, { 'F', 'J', -1 },
+    { 'F', 'a', -1 }, { 'F', 'c', -1 }, { 'F', 'd', -1 }, { 'F', 'e', -1 }, { 'F', 'f', -1 }, { 'F', 'g', -1 },
+    { 'F', 'i', -1 }, { 'F', 'j', -1 }, { 'F', 'm', -1 }, { 'F', 'n', -1 }, { 'F', 'o', -1 }, { 'F', 'p', -1 },
+    { 'F', 'q', -1 }, { 'F', 'r', -1 }, { 'F', 's', -1 }, { 'F', 't', -1 }, { 'F', 'u', -1 }, { 'F', 'v', -1 },
+    { 'F', 'w', -1 }, { 'F', 'x', -1 }, { 'F', 'y', -1 }, { 'F', 'z', -1 }, { 'I', 'f', -1 }, { 'I', 'g', -1 },
+    { 'I', 'q', -1 }, { 'I', 't', -1 }, { 'I', 'v', -1 }, { 'I', 'y', -1 }, { 'J', ',', -1 }, { 'J', '.', -1 },
+    { 'J', 'A', -1 }, { 'J', 'J', -1 }, { 'J', 'a', -1 }, { 'J', 'c', -1 }, { 'J', 'd', -1 }, { 'J', 'e', -1 },
+    { 'J', 'f', -1 }, { 'J', 'g', -1 }, { 'J', 'i', -1 }, { 'J', 'j', -1 }, { 'J', 'm', -1 }, { 'J', 'n', -1 },
+    { 'J', 'o', -1 }, { 'J', 'p', -1 }, { 'J', 'q', -1 }, { 'J', 'r', -1 }, { 'J', 's', -1 }, { 'J', 't', -1 },
+    { 'J', 'u', -1 }, { 'J', 'v', -1 }, { 'J', 'w', -1 }, { 'J', 'x', -1 }, { 'J', 'y', -1 }, { 'J', 'z', -1 },
+    { 'K', 'f', -1 }, { 'K', 'g', -1 }, { 'K', 'q', -1 }, { 'K', 't', -1 }, { 'K', 'v', -1 }, { 'K', 'y', -1 },
+    { 'L', 'T', -1 }, { 'L', 'V', -1 }, { 'L', 'Y', -1 }, { 'L', 'f', -1 }, { 'L', 'g', -1 }, { 'L', 'q', -1 },
+    { 'L', 't', -1 }, { 'L', 'v', -1 }, { 'L', 'y', -1 }, { 'P', ',', -1 }, { 'P', '.', -1 }, { 'P', 'J', -1 },
+    { 'P', 'a', -1 }, { 'P', 'j', -1 }, { 'S', 't', -1 }, { 'T', ',', -1 }, { 'T', '.', -1 }, { 'T', 'A', -1 },
+    { 'T', 'J', -1 }, { 'T', 'a', -1 }, { 'T', 'c', -1 }, { 'T', 'd', -1 }, { 'T', 'e', -1 }, { 'T', 'f', -1 },
+    { 'T', 'g', -1 }, { 'T', 'i', -1 }, { 'T', 'j', -1 }, { 'T', 'm', -1 }, { 'T', 'n', -1 }, { 'T', 'o', -1 },
+    { 'T', 'p', -1 }, { 'T', 'q', -1 }, { 'T', 'r', -1 }, { 'T', 's', -1 }, { 'T', 't', -1 }, { 'T', 'u', -1 },
+    { 'T', 'v', -1 }, { 'T', 'w', -1 }, { 'T', 'x', -1 }, { 'T', 'y', -1 }, { 'T', 'z', -1 }, { 'V', 'j', -1 },
+    { 'X', 'f', -1 }, { 'Y', ',', -1 }, { 'Y', '.', -1 }, { 'Y', 'J', -1 }, { 'Y', 'a', -1 }, { 'Y', 'j', -1 },
+    { 'Z', 'f', -1 }, { 'Z', 'g', -1 }, { 'Z', 'q', -1 }, { 'a', 'T', -1 }, { 'b', 'T', -1 }, { 'c', 'T', -1 },
+    { 'c', 'Y', -1 }, { 'c', 'f', -1 }, { 'c', 't', -1 }, { 'e', 'I', -1 }, { 'e', 'T', -1 }, { 'e', 'j', -1 },
+    { 'e', 'l', -1 }, { 'f', ',', -1 }, { 'f', '.', -1 }, { 'f', 'J', -1 }, { 'f', 'a', -1 }, { 'f', 'c', -1 },
+    { 'f', 'd', -1 }, { 'f', 'e', -1 }, { 'f', 'f', -1 }, { 'f', 'g', -1 }, { 'f', 'j', -1 }, { 'f', 'o', -1 },
+    { 'f', 'q', -1 }, { 'f', 's', -1 }, { 'g', 'T', -1 }, { 'h', 'T', -1 }, { 'i', 'T', -1 }, { 'i', 'V', -1 },
+    { 'i', 'Y', -1 }, { 'i', 'f', -1 }, { 'i', 'g', -1 }, { 'i', 'q', -1 }, { 'i', 't', -1 }, { 'i', 'v', -1 },
+    { 'i', 'y', -1 }, { 'k', 'T', -1 }, { 'l', 'T', -1 }, { 'l', 'V', -1 }, { 'l', 'Y', -1 }, { 'l', 'f', -1 },
+    { 'l', 'g', -1 }, { 'l', 'q', -1 }, { 'l', 't', -1 }, { 'l', 'v', -1 }, { 'l', 'y', -1 }, { 'm', 'T', -1 },
+    { 'n', 'T', -1 }, { 'o', 'T', -1 }, { 'p', 'I', -1 }, { 'p', 'T', -1 }, { 'p', 'j', -1 }, { 'p', 'l', -1 },
+    { 'q', 'T', -1 }, { 'r', ',', -1 }, { 'r', '.', -1 }, { 'r', 'I', -1 }, { 'r', 'J', -1 }, { 'r', 'T', -1 },
+    { 'r', 'X', -1 }, { 'r', 'Z', -1 }, { 'r', 'a', -1 }, { 'r', 'j', -1 }, { 'r', 'l', -1 }, { 's', 'T', -1 },
+    { 's', 'Y', -1 }, { 's', 'f', -1 }, { 's', 't', -1 }, { 't', 'T', -1 }, { 't', 'Y', -1 }, { 't', 'f', -1 },
+    { 't', 't', -1 }, { 'u', 'T', -1 }, { 'v', 'I', -1 }, { 'v', 'T', -1 }, { 'v', 'j', -1 }, { 'v', 'l', -1 },
+    { 'w', 'T', -1 }, { 'x', 'T', -1 }, { 'y', 'T', -1 }, { 'z', 'T', -1 },
+};
+
+const font_t sans8 = {
+    8, 1, 32, 126,
+    sans8_offsets, sans8_glyphs, sans8_inverted,
+    sans8_kerning, 214
+};
+
+static const uint8_t gfx_test_data[443] = {
+    0x84, 0x00, 0x82, 0x80, 0x00, 0xc0, 0x83, 0x80, 0x9f, 0x00, 0x80, 0x80, 0x80, 0xc0, 0x81, 0x60,
+    0x80, 0xc0, 0x05, 0xe0, 0xf8, 0x1c, 0x1c, 0x38, 0x30, 0x82, 0x60, 0x0b, 0x78, 0x1c, 0x1e, 0x7f,
+    0x40, 0xc0, 0xe0, 0x30, 0x30, 0xf0, 0x80, 0x80, 0x85, 0x00, 0x80, 0x80, 0x06, 0x40, 0xc0, 0xe0,
+    0xe0, 0xf0, 0x70, 0x30, 0x81, 0x00, 0x19, 0xfc, 0x06, 0x03, 0x01, 0xc1, 0x00, 0x00, 0xc0, 0x20,
+    0x20, 0x80, 0x81, 0x81, 0x83, 0x22, 0x4c, 0x98, 0x70, 0xc0, 0x80, 0x80, 0xc0, 0xc0, 0x60, 0x60,
+    0x20, 0x83, 0x30, 0x81, 0x20, 0x80, 0x60, 0x03, 0x40, 0xc0, 0xc0, 0x80, 0x83, 0x00, 0x2b, 0xf0,
+    0xf9, 0x8d, 0x8d, 0x87, 0x87, 0x06, 0x00, 0x84, 0x42, 0x02, 0x01, 0x80, 0x40, 0xa0, 0x40, 0x40,
+    0x30, 0x8c, 0xc0, 0xe0, 0x80, 0x00, 0xf0, 0xb8, 0x07, 0x03, 0x03, 0x87, 0x8d, 0x30, 0xfd, 0xff,
+    0x46, 0x7e, 0x46, 0xfe, 0xfe, 0xd1, 0xcf, 0xcd, 0xc6, 0x03, 0x01, 0x82, 0x00, 0x0c, 0x80, 0x00,
+    0x00, 0x03, 0x0f, 0x1c, 0xf0, 0x01, 0x00, 0x63, 0x00, 0x7e, 0xf7, 0x81, 0x01, 0x08, 0x03, 0x07,
+    0x0f, 0x8b, 0xf9, 0x3c, 0x0f, 0x03, 0x01, 0x8f, 0x00, 0x2d, 0x01, 0x03, 0x03, 0x02, 0x02, 0x03,
+    0x03, 0xf9, 0xff, 0x83, 0xc1, 0xcd, 0xcc, 0x41, 0x00, 0x80, 0xf0, 0x3c, 0xfc, 0x80, 0xf8, 0xfc,
+    0x06, 0x03, 0x01, 0x01, 0x07, 0x06, 0xc6, 0x7b, 0xf0, 0x80, 0x00, 0x02, 0x07, 0x0f, 0x0f, 0x02,
+    0x00, 0x00, 0xf0, 0xde, 0x07, 0x07, 0x01, 0x01, 0x86, 0x00, 0x0c, 0x1f, 0x3f, 0x2e, 0x64, 0x44,
+    0x44, 0x67, 0x61, 0x20, 0x30, 0x18, 0x8e, 0x87, 0x83, 0x80, 0x02, 0xc0, 0xff, 0x7f, 0x8d, 0x00,
+    0x01, 0x80, 0xc0, 0x8a, 0x00, 0x07, 0x03, 0x7b, 0x7f, 0x7f, 0x1d, 0x0e, 0x07, 0x03, 0x81, 0x00,
+    0x81, 0x01, 0x84, 0x00, 0x0d, 0xff, 0xf8, 0x00, 0x03, 0x0f, 0x3c, 0x3c, 0x40, 0xc0, 0xd8, 0x40,
+    0x60, 0x3f, 0x0f, 0x94, 0x00, 0x02, 0x1e, 0xff, 0xc1, 0x84, 0x00, 0x80, 0x80, 0x87, 0x00, 0x80,
+    0x80, 0x09, 0xc0, 0x60, 0x60, 0x38, 0x3f, 0x30, 0x20, 0x60, 0x40, 0xc0, 0x86, 0x80, 0x84, 0x00,
+    0x04, 0x08, 0xb8, 0xf0, 0xc0, 0x80, 0x85, 0x00, 0x06, 0x70, 0xe6, 0x0f, 0x18, 0x30, 0xe0, 0xc0,
+    0x9f, 0x00, 0x12, 0x07, 0x3e, 0xf8, 0x80, 0x00, 0x00, 0x0f, 0x7f, 0xe1, 0x01, 0x01, 0x03, 0x03,
+    0x0f, 0x7b, 0xe3, 0x83, 0x01, 0x01, 0x8a, 0x00, 0x90, 0x01, 0x00, 0x03, 0x81, 0x06, 0x81, 0x0c,
+    0x0a, 0xf8, 0xf1, 0x03, 0x06, 0x0c, 0x18, 0xf9, 0xe3, 0x0e, 0xf8, 0xf0, 0x9d, 0x00, 0x02, 0x1f,
+    0xff, 0xe0, 0x81, 0x00, 0x03, 0x03, 0xcf, 0xfc, 0x30, 0x81, 0x00, 0x02, 0xc1, 0xf7, 0x3c, 0x9a,
+    0x00, 0x03, 0xc0, 0xf0, 0x30, 0xf0, 0x81, 0x30, 0x0c, 0x18, 0x0c, 0x0e, 0x87, 0xe0, 0x78, 0x9c,
+    0xc6, 0xe6, 0x7f, 0x1f, 0x07, 0x01, 0x9e, 0x00, 0x0e, 0x0f, 0x1f, 0x33, 0x62, 0x64, 0xc4, 0x7c,
+    0x1f, 0x0f, 0x1a, 0x39, 0x31, 0x22, 0x3f, 0x3f, 0x9a, 0x00, 0x80, 0x07, 0x07, 0x06, 0x07, 0x07,
+    0x02, 0x03, 0x03, 0x02, 0x02, 0x83, 0x03, 0x00, 0x01, 0x95, 0x00,
+};
+
+const bitmap_t gfx_test = { 96, 64, 1, gfx_test_data };
+
+static const uint8_t kicon_logo_data[271] = {
+    0x87, 0x00, 0x00, 0x0c, 0x86, 0xfc, 0x00, 0x0c, 0x81, 0x00, 0x02, 0x80, 0xc0, 0xf0, 0x84, 0xfc,
+    0x06, 0x7c, 0x3c, 0x1c, 0x0c, 0x00, 0x7c, 0xfe, 0x83, 0xff, 0x01, 0xfe, 0x7c, 0x84, 0x00, 0x06,
+    0x80, 0xc0, 0xe0, 0xf0, 0xf0, 0xf8, 0xf8, 0x86, 0xfc, 0x81, 0xf8, 0x01, 0xf0, 0x30, 0xc1, 0x00,
+    0x86, 0xff, 0x02, 0xf0, 0xf8, 0xfe, 0x82, 0xff, 0x04, 0x7f, 0x1f, 0x0f, 0x07, 0x03, 0x83, 0x00,
+    0x00, 0x04, 0x81, 0xfc, 0x81, 0xfd, 0x80, 0xfc, 0x00, 0x04, 0x82, 0x00, 0x01, 0xf8, 0xfe, 0x84,
+    0xff, 0x05, 0x1f, 0x07, 0x03, 0x01, 0x01, 0x00, 0x81, 0x01, 0x02, 0x03, 0x07, 0x01, 0x82, 0x00,
+    0x05, 0x80, 0xc0, 0xf0, 0xf0, 0xf8, 0xf8, 0x87, 0xfc, 0x80, 0xf8, 0x02, 0xf0, 0xe0, 0xc0, 0x82,
+    0x00, 0x00, 0x1c, 0x85, 0xfc, 0x80, 0xf8, 0x86, 0xfc, 0x02, 0xf8, 0xf0, 0xe0, 0x92, 0x00, 0x86,
+    0xff, 0x00, 0x3f, 0x83, 0xff, 0x04, 0xfe, 0xf8, 0xf0, 0xc0, 0x80, 0x85, 0x00, 0x86, 0xff, 0x82,
+    0x00, 0x00, 0x0f, 0x86, 0xff, 0x00, 0xc0, 0x8c, 0x00, 0x00, 0xfc, 0x85, 0xff, 0x01, 0x03, 0x01,
+    0x81, 0x00, 0x01, 0x01, 0x03, 0x84, 0xff, 0x00, 0xfe, 0x82, 0x00, 0x85, 0xff, 0x80, 0x01, 0x80,
+    0x00, 0x01, 0x01, 0x03, 0x85, 0xff, 0x91, 0x00, 0x00, 0x80, 0x86, 0xff, 0x05, 0xc0, 0x00, 0x01,
+    0x03, 0x0f, 0x1f, 0x84, 0xff, 0x05, 0xfc, 0xf8, 0xf0, 0xc0, 0x00, 0x80, 0x86, 0xff, 0x00, 0x80,
+    0x83, 0x00, 0x05, 0x03, 0x0f, 0x1f, 0x3f, 0x7f, 0x7f, 0x81, 0xff, 0x00, 0xfe, 0x84, 0xfc, 0x0a,
+    0xfe, 0xff, 0xff, 0x7c, 0x70, 0x00, 0x01, 0x07, 0x1f, 0x3f, 0x7f, 0x81, 0xff, 0x01, 0xfe, 0xfc,
+    0x81, 0xf8, 0x08, 0xfc, 0xfe, 0xff, 0xff, 0x7f, 0x3f, 0x3f, 0x0f, 0x03, 0x81, 0x00, 0x00, 0xc0,
+    0x85, 0xff, 0x00, 0xc0, 0x81, 0x00, 0x01, 0x80, 0xc0, 0x85, 0xff, 0x00, 0x80, 0x87, 0x00,
+};
+
+const bitmap_t kicon_logo = { 128, 32, 1, kicon_logo_data };
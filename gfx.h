@@ -1,28 +1,25 @@
 /*
- * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
- *
- * This source code is free software; you can redistribute it
- * and/or modify it in source code form under the terms of the GNU
- * General Public License as published by the Free Software
- * Foundation; either version 2 of the License, or (at your option)
- * any later version.
- *
- * This program is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- * GNU General Public License for more details.
- *
- * You should have received a copy of the GNU General Public License
- * along with this program; if not, write to the Free Software
- * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ * Generated by scripts/gfx_convert.py from the images and fonts
+ * directories, do not edit.
  */
-
 #ifndef GFX_H
 #define GFX_H
 
-#include <stdint.h>
+#include "lcd.h"
+
+/* 24 px, 704 bytes, 0 kerning pairs */
+extern const font_t digits24;
+
+/* 16 px, 2584 bytes, 236 kerning pairs */
+extern const font_t sans16;
+
+/* 8 px, 1676 bytes, 214 kerning pairs */
+extern const font_t sans8;
+
+/* 96x64, 443 bytes, RLE */
+extern const bitmap_t gfx_test;
 
-const uint8_t kicon_logo[128*32/8];
-const uint8_t gfx_test[96*64/8];
+/* 128x32, 271 bytes, RLE */
+extern const bitmap_t kicon_logo;
 
 #endif /* GFX_H */
@@ -19,49 +19,244 @@
  */
 
 #include "i2c.h"
-#include "lcd.h"
 #include "command_handlers.h"
 #include "io_conf.h"
 
-#include <twi.h>
 #include <sysclk.h>
 #include <pio.h>
+#include <pdc.h>
+#include <interrupt.h>
 
-static twi_options_t twi_opt;
+/* TWI interrupt priority, capture interrupts take precedence */
+#define TWI_IRQ_PRI         8
+
+/* Interrupts used by the transaction state machine */
+#define TWI_IRQ_ALL         (TWI_IDR_TXBUFE | TWI_IDR_TXRDY | TWI_IDR_RXRDY | \
+                             TWI_IDR_TXCOMP | TWI_IDR_NACK)
+
+/* Pointer to TWI PDC register base */
+static Pdc *twi_pdc;
+
+/* Clock currently set in the TWI clock waveform generator */
+static uint32_t twi_clock;
+
+/* Clock used for the command interface transactions */
+static uint32_t user_clock = 100000;
+
+/* Transactions waiting for the bus, the queue is empty if head == tail */
+static twi_xfer_t *twi_queue[TWI_QUEUE_SIZE];
+static volatile uint8_t twi_queue_head = 0;
+static volatile uint8_t twi_queue_tail = 0;
+
+/* Transaction being executed, NULL if the bus is idle */
+static twi_xfer_t *volatile twi_current = NULL;
+
+/* Number of bytes received in the current read transaction */
+static uint16_t twi_received;
 
 void twi_init(void) {
+    twi_options_t twi_opt;
+
     pio_configure(PIOA, PIO_PERIPH_A,
             (PIO_PA3A_TWD0 | PIO_PA4A_TWCK0), PIO_OPENDRAIN | PIO_PULLUP);
     sysclk_enable_peripheral_clock(ID_TWI0);
     pmc_enable_periph_clk(ID_TWI0);
-    twi_set_clock(400000);
-}
 
-
-void twi_set_clock(unsigned int speed_hz) {
     twi_opt.master_clk = sysclk_get_peripheral_hz();
-    twi_opt.speed      = speed_hz;
+    twi_opt.speed      = 400000;
     twi_master_init(TWI0, &twi_opt);
+    twi_clock = twi_opt.speed;
+
+    twi_pdc = twi_get_pdc_base(TWI0);
+
+    NVIC_DisableIRQ(TWI0_IRQn);
+    NVIC_ClearPendingIRQ(TWI0_IRQn);
+    NVIC_SetPriority(TWI0_IRQn, TWI_IRQ_PRI);
+    NVIC_EnableIRQ(TWI0_IRQn);
+}
+
+
+/*
+ * Starts the first queued transaction, unless the bus is busy
+ * (called with the TWI interrupt masked)
+ */
+static void twi_start_next(void) {
+    twi_xfer_t *xfer;
+
+    if (twi_current || twi_queue_head == twi_queue_tail) {
+        return;
+    }
+
+    xfer = twi_queue[twi_queue_head % TWI_QUEUE_SIZE];
+    ++twi_queue_head;
+    twi_current = xfer;
+    xfer->started = DWT->CYCCNT;
+
+    /* the bus is idle, so it is safe to change the clock now */
+    if (xfer->clock != twi_clock) {
+        twi_set_speed(TWI0, xfer->clock, sysclk_get_peripheral_hz());
+        twi_clock = xfer->clock;
+    }
+
+    /* clear the status flags left by the previous transaction */
+    (void) TWI0->TWI_SR;
+
+    TWI0->TWI_MMR = 0;
+    TWI0->TWI_MMR = (xfer->read ? TWI_MMR_MREAD : 0) | TWI_MMR_DADR(xfer->chip)
+            | ((xfer->addr_length << TWI_MMR_IADRSZ_Pos) & TWI_MMR_IADRSZ_Msk);
+    TWI0->TWI_IADR = twi_mk_addr(xfer->addr, xfer->addr_length);
+
+    if (xfer->read) {
+        /* a single byte read has to request STOP together with START */
+        twi_received = 0;
+        TWI0->TWI_CR = xfer->length == 1 ? (TWI_CR_START | TWI_CR_STOP) : TWI_CR_START;
+        twi_enable_interrupt(TWI0, TWI_IER_RXRDY | TWI_IER_NACK);
+
+    } else {
+        pdc_packet_t first, second;
+
+        /* prefix and data are sent without STOP condition in between */
+        if (xfer->prefix_length > 0) {
+            first.ul_addr = (uint32_t) xfer->prefix;
+            first.ul_size = xfer->prefix_length;
+            second.ul_addr = (uint32_t) xfer->buffer;
+            second.ul_size = xfer->length;
+        } else {
+            first.ul_addr = (uint32_t) xfer->buffer;
+            first.ul_size = xfer->length;
+            second.ul_addr = 0;
+            second.ul_size = 0;
+        }
+
+        pdc_tx_init(twi_pdc, &first, &second);
+
+        // TXBUFE is set when both PDC buffers have been sent
+        twi_enable_interrupt(TWI0, TWI_IER_TXBUFE | TWI_IER_NACK);
+
+        /* Enable the TX PDC transfer requests */
+        pdc_enable_transfer(twi_pdc, PERIPH_PTCR_TXTEN);
+    }
+}
+
+
+/*
+ * Ends the current transaction and starts the next one
+ */
+static void twi_finish(uint32_t status) {
+    twi_xfer_t *xfer = twi_current;
+    /* the descriptor may be reused as soon as its status is set */
+    void (*done)(twi_xfer_t *) = xfer->done;
+
+    twi_disable_interrupt(TWI0, TWI_IRQ_ALL);
+    pdc_disable_transfer(twi_pdc, PERIPH_PTCR_TXTDIS);
+
+    twi_current = NULL;
+    xfer->status = status;
 
+    if (done) {
+        done(xfer);
+    }
+
+    twi_start_next();
+}
+
+
+uint32_t twi_submit(twi_xfer_t *xfer) {
+    irqflags_t flags;
+    uint32_t ret = TWI_BUSY;
+
+    if (xfer->length == 0 || xfer->addr_length > 3
+            || (xfer->read && xfer->prefix_length > 0)) {
+        return TWI_INVALID_ARGUMENT;
+    }
+
+    xfer->status = TWI_BUSY;
+
+    flags = cpu_irq_save();
+
+    if ((uint8_t)(twi_queue_tail - twi_queue_head) < TWI_QUEUE_SIZE) {
+        twi_queue[twi_queue_tail % TWI_QUEUE_SIZE] = xfer;
+        ++twi_queue_tail;
+        twi_start_next();
+        ret = TWI_SUCCESS;
+    }
+
+    cpu_irq_restore(flags);
+
+    return ret;
+}
+
+
+uint32_t twi_transfer(twi_xfer_t *xfer) {
+    uint32_t ret;
+
+    xfer->done = NULL;
+
+    /* every queue user has a single transaction in flight at most,
+     * so the queue gets free quickly */
+    while ((ret = twi_submit(xfer)) == TWI_BUSY);
+
+    if (ret != TWI_SUCCESS) {
+        return ret;
+    }
+
+    while (xfer->status == TWI_BUSY);
+
+    return xfer->status;
 }
 
 
-unsigned int twi_get_clock(void) {
-    return twi_opt.speed;
+void TWI0_Handler(void) {
+    uint32_t status = twi_get_interrupt_status(TWI0) & twi_get_interrupt_mask(TWI0);
+    twi_xfer_t *xfer = twi_current;
+
+    if (!xfer) {
+        twi_disable_interrupt(TWI0, TWI_IRQ_ALL);
+
+    } else if (status & TWI_SR_NACK) {
+        // the slave has not responded, the controller has already sent STOP
+        twi_finish(xfer->read ? TWI_RECEIVE_NACK : TWI_SEND_NACK);
+
+    } else if (status & TWI_SR_TXBUFE) {
+        // the PDC has written the last byte, wait until it is shifted out
+        twi_disable_interrupt(TWI0, TWI_IDR_TXBUFE);
+        pdc_disable_transfer(twi_pdc, PERIPH_PTCR_TXTDIS);
+        twi_enable_interrupt(TWI0, TWI_IER_TXRDY);
+
+    } else if (status & TWI_SR_TXRDY) {
+        twi_disable_interrupt(TWI0, TWI_IDR_TXRDY);
+        TWI0->TWI_CR = TWI_CR_STOP;
+        twi_enable_interrupt(TWI0, TWI_IER_TXCOMP);
+
+    } else if (status & TWI_SR_RXRDY) {
+        xfer->buffer[twi_received++] = TWI0->TWI_RHR;
+
+        // STOP has to be requested before the last byte is received
+        if (twi_received == xfer->length - 1) {
+            TWI0->TWI_CR = TWI_CR_STOP;
+        }
+
+        if (twi_received == xfer->length) {
+            twi_disable_interrupt(TWI0, TWI_IDR_RXRDY);
+            twi_enable_interrupt(TWI0, TWI_IER_TXCOMP);
+        }
+
+    } else if (status & TWI_SR_TXCOMP) {
+        twi_finish(TWI_SUCCESS);
+    }
 }
 
 
 void cmd_i2c(const uint8_t* data_in, unsigned int input_len) {
-    /* wait for the LCD to finish the data transfers */
-    while(SSD1306_isBusy());    // TODO better synchronization
-    io_configure(IO_I2C_CMD);
+    io_configure(IO_I2C);
 
     // I2C configuration, special case
     if (data_in[0] == CMD_I2C_CLOCK) {
         uint32_t clock = ((uint32_t)(data_in[1]) << 8 | data_in[2]) * 1000;
 
-        if (clock <= 400000) {
-            twi_set_clock(clock);
+        if (clock > 0 && clock <= 400000) {
+            // applied to the following transactions
+            user_clock = clock;
             cmd_resp_init(CMD_RESP_OK);
         } else {
             cmd_resp_init(CMD_RESP_EXEC_ERR);
@@ -69,41 +264,42 @@ void cmd_i2c(const uint8_t* data_in, unsigned int input_len) {
         return;
     }
 
-    uint32_t status = TWI_ERROR_TIMEOUT;
-    twi_packet_t packet;
+    uint32_t status;
+    twi_xfer_t xfer;
     const uint8_t* ptr = &data_in[1];
 
-    packet.chip = *ptr++;
-    packet.addr_length = *ptr++;
+    switch (data_in[0]) {
+        case CMD_I2C_READ:  xfer.read = 1; break;
+        case CMD_I2C_WRITE: xfer.read = 0; break;
+        default: cmd_resp_init(CMD_RESP_INVALID_CMD); return;
+    }
+
+    xfer.clock = user_clock;
+    xfer.chip = *ptr++;
+    xfer.addr_length = *ptr++;
 
-    if (packet.addr_length > 4) {
+    if (xfer.addr_length > 3) {
         cmd_resp_init(CMD_RESP_INVALID_CMD); return;
     }
 
-    for (uint8_t i = 0; i < packet.addr_length; ++i) {
-        packet.addr[i] = *ptr++;
+    for (uint8_t i = 0; i < xfer.addr_length; ++i) {
+        xfer.addr[i] = *ptr++;
     }
 
-    packet.length = *ptr++;
-    packet.buffer = (uint8_t*) ptr; /* discarding const qualifier */
+    xfer.prefix = NULL;
+    xfer.prefix_length = 0;
+    xfer.length = *ptr++;
+    xfer.buffer = (uint8_t*) ptr; /* discarding const qualifier */
 
-    switch (data_in[0]) {
-        case CMD_I2C_READ:
-            status = twi_master_read(TWI0, &packet);
-            break;
-
-        case CMD_I2C_WRITE:
-            status = twi_master_write(TWI0, &packet);
-            break;
-
-        default: cmd_resp_init(CMD_RESP_INVALID_CMD); return;
-    }
+    /* the display transactions are queued too, so the wait is limited
+     * to the transaction being sent at the moment */
+    status = twi_transfer(&xfer);
 
     if (status == TWI_SUCCESS) {
         cmd_resp_init(CMD_RESP_OK);
 
-        if (data_in[0] == CMD_I2C_READ) {
-            cmd_resp_writen(packet.buffer, packet.length);
+        if (xfer.read) {
+            cmd_resp_writen(xfer.buffer, xfer.length);
         }
     } else {
         cmd_resp_init(CMD_RESP_EXEC_ERR);
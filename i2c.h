@@ -21,8 +21,50 @@
 #ifndef I2C_H
 #define I2C_H
 
+#include <stdint.h>
+#include <twi.h>
+
+/* Number of transactions that may wait for the bus */
+#define TWI_QUEUE_SIZE      4
+
+/*
+ * TWI0 transaction descriptor. The descriptor is owned by the queue from
+ * twi_submit() until its status changes from TWI_BUSY, so it must not be
+ * modified or go out of scope in the meantime.
+ */
+typedef struct twi_xfer {
+    uint32_t clock;             ///< Bus clock for the transaction [Hz]
+    uint8_t chip;               ///< Slave address
+    uint8_t read;               ///< 1 for a read transaction, 0 for a write
+    uint8_t addr_length;        ///< Internal address length (0 to 3 bytes)
+    uint8_t addr[3];            ///< Internal address, MSB first
+    const uint8_t *prefix;      ///< Bytes written before the buffer (writes only)
+    uint16_t prefix_length;     ///< Number of prefix bytes, may be 0
+    uint8_t *buffer;            ///< Data to write or space for the read data
+    uint16_t length;            ///< Number of data bytes, at least 1
+    /// Called in the interrupt context when the transaction is finished,
+    /// may submit another transaction
+    void (*done)(struct twi_xfer *xfer);
+    volatile uint32_t status;   ///< TWI_BUSY until finished, then TWI_SUCCESS or an error
+    uint32_t started;           ///< DWT cycle counter value when the transaction started
+} twi_xfer_t;
+
 void twi_init(void);
-void twi_set_clock(unsigned int speed_hz);
-unsigned int twi_get_clock(void);
+
+/**
+ * Queues a transaction. Transactions are executed in the submission order
+ * by the TWI0 interrupt handler, the bus clock is switched between them
+ * as requested by the descriptors.
+ * @return TWI_SUCCESS if the transaction has been queued, TWI_BUSY if
+ * the queue is full or TWI_INVALID_ARGUMENT if the descriptor is invalid.
+ */
+uint32_t twi_submit(twi_xfer_t *xfer);
+
+/**
+ * Queues a transaction and waits until it is finished.
+ * Must not be called from interrupt handlers.
+ * @return the transaction status (TWI_SUCCESS or an error code).
+ */
+uint32_t twi_transfer(twi_xfer_t *xfer);
 
 #endif /* I2C_H */
@@ -23,8 +23,7 @@
 typedef enum {
     IO_UNINITIALIZED,
     IO_SPI,
-    IO_I2C_CMD,     /* I2C for command interface */
-    IO_I2C_LCD,     /* I2C for LCD */
+    IO_I2C,         /* I2C, shared by the LCD and the command interface */
     IO_UART,
     IO_ADC,
     IO_DAC
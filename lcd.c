@@ -26,79 +26,290 @@
 #include <pio.h>
 
 #include "command_handlers.h"
-#include "io_conf.h"
 #include "SSD1306_commands.h"
 #include "fonts.h"
 #include "uart.h"
-#include "pdc.h"
 
+#include <interrupt.h>
 #include <string.h>
+#include <stdio.h>
 
 #define SSD1306_ADDRESS     0x3C /* or 0x3D, depending on the jumper */
 
-/* horizontal offset values:
- * 0 for SSD1306 (normally 0.96")
- * 2 for SH1106  (normally 1.2")
- */
+/* the display controller is selected in lcd.h */
+#ifdef LCD_SH1106
+/* SH1106 has 132 columns, the display is centered */
 #define SSD1306_OFFSET      0x02
+/* no horizontal addressing mode, pages are sent in separate transactions */
+#define SSD1306_ADDRESSING  SSD1306_PAGE
+#else
+#define SSD1306_OFFSET      0x00
+/* consecutive pages may be sent in a single transaction */
+#define SSD1306_ADDRESSING  SSD1306_HORIZONTAL
+#endif
+
+/* maximum number of commands selecting the drawn area */
+#define WINDOW_CMDS         6
+
+/* bytes sent in a transaction besides the data (address, control bytes,
+ * commands, start and stop conditions) */
+#define XFER_OVERHEAD       (3 + 2 * WINDOW_CMDS)
+
+#ifndef LCD_SH1106
+/* maximum number of pages sent in a single DMA transaction, so other
+ * transactions queued for the TWI do not wait for the whole frame */
+#define XFER_MAX_PAGES      2
+#endif
 
 typedef enum
 {
     DATA = 0x40,
-    CMD = 0x00
+    CMD = 0x00,
+    CMD_NEXT = 0x80     /* single command followed by another control byte */
 } control_byte_t;
 
 
+/* size of a frame buffer */
+#define FRAME_SIZE          (LCD_WIDTH * LCD_PAGES)
+
 /*
- * Pointer to TWI PDC register base
+ * buffers to store image and send to display: drawing functions modify
+ * displayBuffer (back buffer), while frontBuffer is being transferred
  */
-static Pdc *g_p_twim_pdc;
+static uint8_t frameBuffers[2][FRAME_SIZE];
+static uint8_t *displayBuffer = frameBuffers[0];
+static uint8_t *frontBuffer = frameBuffers[1];
 
 /*
- * buffer to store image and send to display
+ * copy of the display memory contents, modified spans are compared against it
+ * so only the columns that have really changed are transferred
  */
-static uint8_t displayBuffer[LCD_WIDTH * LCD_PAGES];
+static uint8_t panelBuffer[FRAME_SIZE];
+
+/* 0 if the display memory contents are unknown (e.g. after scrolling) */
+static int panelValid = 0;
+
+/*
+ * range of modified columns in every page (empty if dirtyStart > dirtyEnd)
+ */
+static uint8_t dirtyStart[LCD_PAGES];
+static uint8_t dirtyEnd[LCD_PAGES];
+
+/* column ranges being transferred by DMA, same convention as above */
+static uint8_t xferStart[LCD_PAGES];
+static uint8_t xferEnd[LCD_PAGES];
 
-static inline uint32_t twi_read_status(Twi *p_twi) { return p_twi->TWI_SR; }
+/* first page of the next DMA transaction */
+static int xferPage = LCD_PAGES;
+
+/* commands preceding the data in a DMA transaction (the window and
+ * the start line), interleaved with control bytes */
+static uint8_t xferCmds[2 * (WINDOW_CMDS + 1)];
+
+/* queued TWI transaction sending the frontBuffer spans */
+static twi_xfer_t xfer;
 
 /* Busy flag */
 static volatile int busy = 0;
 
-/* DMA transfers counter */
-static int dma_transfers = 0;
+/* display start line, the panel shows its memory rotated by this many rows
+ * (SSD1306_scrollText()) */
+static uint8_t startLine = 0;
+
+/* text line being transferred by SSD1306_scrollText() */
+static uint8_t scrollLine[LCD_WIDTH];
 
 /*
- * \brief Write multiple bytes to a TWI compatible slave device.
- *
- * \param p_twi Pointer to a TWI instance.
- * \param p_packet Packet information and data (see \ref twi_packet_t).
+ * Frame statistics (CMD_LCD_STATS), times are measured with the DWT cycle
+ * counter. Draw time starts with the first buffer modification after
+ * a frame has been presented, queue time lasts from SSD1306_drawBufferDMA()
+ * until the first transaction is started, transfer time ends with
+ * the completion interrupt of the last transaction.
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} frame_stat_t;
+
+enum { STAT_DRAW, STAT_QUEUE, STAT_TRANSFER, STAT_BYTES, STAT_COUNT };
+
+static frame_stat_t frameStats[STAT_COUNT];
+
+/* cycle counter value when drawing started, 0 if the buffer has not been
+ * modified since the last frame */
+static uint32_t drawTime = 0;
+
+/* cycle counter value when the frame being transferred was presented */
+static uint32_t presentTime;
+
+/* cycle counter value when the first transaction of the frame started */
+static uint32_t xferTime;
+
+/* bytes of the frame sent so far */
+static uint32_t xferBytes;
+
+/* finished transactions of the frame, -1 if the transfer is not a frame */
+static int xferSpans = -1;
+
+/* frame rate overlay (CMD_LCD_STATS_OVERLAY), drawn only in the transferred
+ * frame, so the displayBuffer contents are not affected */
+static int fpsOverlay = 0;
+static uint32_t fpsTime;
+static uint32_t fpsFrames;
+static uint32_t fps;
+
+/* display mirroring mode (CMD_LCD_MIRROR_*) */
+static uint8_t mirrorMode = CMD_LCD_MIRROR_OFF;
+
+/* columns of the panelBuffer not sent to the host yet, same convention
+ * as the dirty ranges */
+static uint8_t mirrorStart[LCD_PAGES];
+static uint8_t mirrorEnd[LCD_PAGES];
+
+/*
+ * Waits until the DMA transfer is finished, so the TWI is available
+ */
+static void SSD1306_wait(void) {
+    while (busy);
+}
+
+/*
+ * Functions tracking the modified regions of the displayBuffer
+ */
+
+/*
+ * Marks a single column of a page as modified
+ */
+static inline void SSD1306_markColumn(uint8_t x, uint8_t pageIndex) {
+    if (!drawTime) drawTime = DWT->CYCCNT | 1;
+    if (x < dirtyStart[pageIndex]) dirtyStart[pageIndex] = x;
+    if (x > dirtyEnd[pageIndex]) dirtyEnd[pageIndex] = x;
+}
+
+/*
+ * Marks a range of the displayBuffer as modified, the range may span
+ * multiple pages
+ * offset - index of the first modified byte
+ * size - number of modified bytes
  */
-static void twi_master_pdc_write(twi_packet_t *p_packet) {
-    pdc_packet_t pdc_twi_packet;
-    uint8_t *buffer = p_packet->buffer;
+static void SSD1306_markRange(int offset, int size) {
+    int end = offset + size;
+
+    while (offset < end) {
+        int pageIndex = offset / LCD_WIDTH;
+        int pageEnd = (pageIndex + 1) * LCD_WIDTH;
 
-    pdc_disable_transfer(g_p_twim_pdc, PERIPH_PTCR_TXTDIS | PERIPH_PTCR_RXTDIS);
+        SSD1306_markColumn(offset - pageIndex * LCD_WIDTH, pageIndex);
+        SSD1306_markColumn((end < pageEnd ? end : pageEnd) - 1 - pageIndex * LCD_WIDTH,
+                           pageIndex);
+        offset = pageEnd;
+    }
+}
 
-    pdc_twi_packet.ul_addr = (uint32_t)buffer;
+/*
+ * Marks the whole displayBuffer as modified
+ */
+static void SSD1306_markAll(void) {
+    if (!drawTime) drawTime = DWT->CYCCNT | 1;
+    memset(dirtyStart, 0, sizeof(dirtyStart));
+    memset(dirtyEnd, LCD_WIDTH - 1, sizeof(dirtyEnd));
+}
+
+/*
+ * Resets the modified ranges
+ */
+static void SSD1306_markClean(void) {
+    memset(dirtyStart, LCD_WIDTH, sizeof(dirtyStart));
+    memset(dirtyEnd, 0, sizeof(dirtyEnd));
+}
+
+/*
+ * Adds a frame measurement to the statistics
+ */
+static void SSD1306_addStat(int stat, uint32_t value) {
+    frame_stat_t *s = &frameStats[stat];
+
+    if (!s->count || value < s->min) s->min = value;
+    if (value > s->max) s->max = value;
+
+    s->sum += value;
+    ++s->count;
+}
+
+/*
+ * Marks columns of the panelBuffer to be sent to the host (CMD_LCD_MIRROR)
+ * x0, x1 - range of updated columns
+ * pageIndex - updated page
+ */
+static void SSD1306_markMirror(uint8_t x0, uint8_t x1, uint8_t pageIndex) {
+    switch (mirrorMode) {
+        case CMD_LCD_MIRROR_SPANS:
+            if (x0 < mirrorStart[pageIndex]) mirrorStart[pageIndex] = x0;
+            if (x1 > mirrorEnd[pageIndex]) mirrorEnd[pageIndex] = x1;
+            break;
 
-    pdc_twi_packet.ul_size = (p_packet->length);
+        case CMD_LCD_MIRROR_FRAMES:
+            // any change resends the whole frame
+            memset(mirrorStart, 0, sizeof(mirrorStart));
+            memset(mirrorEnd, LCD_WIDTH - 1, sizeof(mirrorEnd));
+            break;
+    }
+}
 
-    pdc_tx_init(g_p_twim_pdc, &pdc_twi_packet, NULL);
+/*
+ * Display memory contents have been changed without updating the panelBuffer,
+ * the next refresh has to send the whole displayBuffer
+ */
+static void SSD1306_invalidate(void) {
+    panelValid = 0;
+    SSD1306_markAll();
+}
 
-    /* Set write mode, slave address and 3 internal address byte lengths */
-    TWI0->TWI_MMR = 0;
-    TWI0->TWI_MMR =
-        TWI_MMR_DADR(p_packet->chip) |
-        ((p_packet->addr_length << TWI_MMR_IADRSZ_Pos) & TWI_MMR_IADRSZ_Msk);
+/*
+ * Marks all the panel contents to be sent to the host, as the rows
+ * have been moved
+ */
+static void SSD1306_markMirrorAll(void) {
+    for (int i = 0; i < LCD_PAGES; i++) {
+        SSD1306_markMirror(0, LCD_WIDTH - 1, i);
+    }
+}
 
-    /* Set internal address for remote chip */
-    TWI0->TWI_IADR = 0;
-    TWI0->TWI_IADR = twi_mk_addr(p_packet->addr, p_packet->addr_length);
+static void SSD1306_xferDone(twi_xfer_t *finished);
 
-    twi_enable_interrupt(TWI0, TWI_SR_ENDTX);
+/*
+ * Queues a DMA transaction: commands followed by data, both sent without
+ * STOP condition in between. The transaction is completed by SSD1306_xferDone().
+ * cmds - commands to send
+ * count - number of commands
+ * data - data to send
+ * size - number of data bytes
+ */
+static void SSD1306_startDMA(const uint8_t *cmds, int count, const uint8_t *data,
+                             int size) {
+    uint8_t *ptr = xferCmds;
+
+    // the first control byte goes to the internal address register
+    for (int i = 0; i < count; i++) {
+        *ptr++ = cmds[i];
+        *ptr++ = (i == count - 1) ? DATA : CMD_NEXT;
+    }
 
-    /* Enable the TX PDC transfer requests */
-    pdc_enable_transfer(g_p_twim_pdc, PERIPH_PTCR_TXTEN);
+    xfer.clock = LCD_I2C_CLOCK;
+    xfer.chip = SSD1306_ADDRESS;
+    xfer.read = 0;
+    xfer.addr_length = 1;
+    xfer.addr[0] = CMD_NEXT;
+    xfer.prefix = xferCmds;
+    xfer.prefix_length = ptr - xferCmds;
+    xfer.buffer = (uint8_t *)data;
+    xfer.length = size;
+    xfer.done = SSD1306_xferDone;
+
+    // the display has a single transaction in flight, so there is a free slot
+    twi_submit(&xfer);
 }
 
 /*
@@ -106,23 +317,21 @@ static void twi_master_pdc_write(twi_packet_t *p_packet) {
  * buffer - bytes to send
  * size - number of bytes
  * ctrl_b - indicates whether it is cmd or data
- * DMA - 1 to use DMA for transfer
  */
-static void SSD1306_write(const uint8_t *buffer, int size, control_byte_t ctrl_b,
-                          int DMA) {
-    twi_packet_t packet_tx;
+static void SSD1306_write(const uint8_t *buffer, int size, control_byte_t ctrl_b) {
+    twi_xfer_t packet_tx;
 
+    packet_tx.clock = LCD_I2C_CLOCK;
     packet_tx.chip = SSD1306_ADDRESS;
+    packet_tx.read = 0;
     packet_tx.addr[0] = (uint8_t)ctrl_b;
     packet_tx.addr_length = 1;
+    packet_tx.prefix = NULL;
+    packet_tx.prefix_length = 0;
     packet_tx.buffer = (uint8_t *)buffer;
     packet_tx.length = size;
 
-    if (DMA) {
-        twi_master_pdc_write(&packet_tx);
-    } else {
-        twi_master_write(TWI0, &packet_tx);
-    }
+    twi_transfer(&packet_tx);
 }
 
 /*
@@ -131,7 +340,7 @@ static void SSD1306_write(const uint8_t *buffer, int size, control_byte_t ctrl_b
  * size - number of bytes
  */
 static void SSD1306_writeCmd(const uint8_t *buffer, int size) {
-    SSD1306_write(buffer, size, CMD, 0);
+    SSD1306_write(buffer, size, CMD);
 }
 
 /*
@@ -139,8 +348,41 @@ static void SSD1306_writeCmd(const uint8_t *buffer, int size) {
  * buffer - bytes to send
  * size - number of bytes
  */
-static void SSD1306_writeData(const uint8_t *buffer, int size, int DMA) {
-    SSD1306_write(buffer, size, DATA, DMA);
+static void SSD1306_writeData(const uint8_t *buffer, int size) {
+    SSD1306_write(buffer, size, DATA);
+}
+
+/*
+ * Fills commands selecting the drawn area, the data continues
+ * in the next page after the last column
+ * cmds - buffer for the commands (WINDOW_CMDS)
+ * firstPage, lastPage - range of drawn pages
+ * start, end - range of drawn columns
+ * returns the number of commands
+ */
+static int SSD1306_setWindow(uint8_t *cmds, uint8_t firstPage, uint8_t lastPage,
+                             uint8_t start, uint8_t end) {
+#ifdef LCD_SH1106
+    // page addressing mode: a single page, the end column is not used
+    const uint8_t column = start + SSD1306_OFFSET;
+
+    (void)lastPage;
+    (void)end;
+    cmds[0] = SSD1306_PAGESTART + firstPage;
+    cmds[1] = SSD1306_SETLOWCOLUMN | (column & 0x0f);
+    cmds[2] = SSD1306_SETHIGHCOLUMN | (column >> 4);
+
+    return 3;
+#else
+    cmds[0] = SSD1306_COLUMNADDR;
+    cmds[1] = start + SSD1306_OFFSET;
+    cmds[2] = end + SSD1306_OFFSET;
+    cmds[3] = SSD1306_PAGEADDR;
+    cmds[4] = firstPage;
+    cmds[5] = lastPage;
+
+    return 6;
+#endif
 }
 
 void SSD1306_init(void) {
@@ -163,28 +405,29 @@ void SSD1306_init(void) {
         0x80,  // osc frequency
         SSD1306_CHARGEPUMP,
         0x14,              // en charge pump regulator
+#ifndef LCD_SH1106
+        SSD1306_MEMORYMODE,
+        SSD1306_ADDRESSING,
+#endif
         SSD1306_DISPLAYON  // display on
         //        SSD1306_DISPLAYALLON                 // clear all
     };
 
     twi_init();
 
-    /* Configure TWI interrupts */
-    NVIC_DisableIRQ(TWI0_IRQn);
-    NVIC_ClearPendingIRQ(TWI0_IRQn);
-    NVIC_SetPriority(TWI0_IRQn, 0);
-    NVIC_EnableIRQ(TWI0_IRQn);
+    /* the cycle counter measures the frame statistics */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
-    /* Get pointer to TWI master PDC register base */
-    g_p_twim_pdc = twi_get_pdc_base(TWI0);
-
-    // init displayBuffer to all on
-    for (uint16_t i = 0; i < LCD_WIDTH * LCD_PAGES; i++) {
-        displayBuffer[i] = 0x00;
-    }
+    // init both buffers to all off
+    memset(frameBuffers, 0x00, sizeof(frameBuffers));
 
     SSD1306_writeCmd(init, sizeof(init));
     SSD1306_clear();
+
+    /* both the display and the buffer are blank */
+    SSD1306_markClean();
+    drawTime = 0;
 }
 
 /*
@@ -211,6 +454,8 @@ void SSD1306_setPixel(uint8_t x, uint8_t y, color_t color) {
     // check if within bounds
     if ((x >= LCD_WIDTH) || (y >= LCD_HEIGHT)) return;
 
+    SSD1306_markColumn(x, y / LCD_PAGE_SIZE);
+
     switch (color) {
         case WHITE:
             displayBuffer[x + (y / LCD_PAGE_SIZE) * LCD_WIDTH] |=
@@ -228,7 +473,96 @@ void SSD1306_setPixel(uint8_t x, uint8_t y, color_t color) {
 }
 
 /*
- * Sets a line in the buffer
+ * Marks a rectangular area as modified
+ * x0, x1 - range of columns
+ * page0, page1 - range of pages
+ */
+static void SSD1306_markArea(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+    for (int i = page0; i <= page1; i++) {
+        SSD1306_markColumn(x0, i);
+        SSD1306_markColumn(x1, i);
+    }
+}
+
+/*
+ * Applies a color to the bits selected by a mask
+ * ptr - modified byte
+ * mask - modified bits
+ * color - on/off/invert
+ */
+static inline void SSD1306_applyMask(uint8_t *ptr, uint8_t mask, color_t color) {
+    switch (color) {
+        case WHITE:
+            *ptr |= mask;
+            break;
+        case BLACK:
+            *ptr &= ~mask;
+            break;
+        case INVERSE:
+            *ptr ^= mask;
+            break;
+    }
+}
+
+/*
+ * Replaces the bits selected by a mask
+ * ptr - modified byte
+ * data - new bit values
+ * mask - modified bits
+ */
+static inline void SSD1306_writeMask(uint8_t *ptr, uint8_t data, uint8_t mask) {
+    *ptr = (*ptr & ~mask) | (data & mask);
+}
+
+/*
+ * Sets a vertical span without bounds checking and dirty tracking
+ */
+static void SSD1306_vspan(uint8_t x, uint8_t y0, uint8_t y1, color_t color) {
+    uint8_t *ptr = &displayBuffer[(y0 / LCD_PAGE_SIZE) * LCD_WIDTH + x];
+    uint8_t *last = &displayBuffer[(y1 / LCD_PAGE_SIZE) * LCD_WIDTH + x];
+    uint8_t mask = 0xff << (y0 & 7);
+    uint8_t lastMask = 0xff >> (7 - (y1 & 7));
+
+    // whole bytes between the first and the last page
+    while (ptr != last) {
+        SSD1306_applyMask(ptr, mask, color);
+        ptr += LCD_WIDTH;
+        mask = 0xff;
+    }
+
+    SSD1306_applyMask(ptr, mask & lastMask, color);
+}
+
+void SSD1306_setHLine(uint8_t x0, uint8_t x1, uint8_t y, color_t color) {
+    if (x0 > x1) SSD1306_swap(&x0, &x1);
+
+    // check if within bounds
+    if ((x0 >= LCD_WIDTH) || (y >= LCD_HEIGHT)) return;
+    if (x1 >= LCD_WIDTH) x1 = LCD_WIDTH - 1;
+
+    uint8_t *ptr = &displayBuffer[(y / LCD_PAGE_SIZE) * LCD_WIDTH];
+    const uint8_t mask = 1 << (y & 7);
+
+    for (int x = x0; x <= x1; x++) {
+        SSD1306_applyMask(&ptr[x], mask, color);
+    }
+
+    SSD1306_markArea(x0, x1, y / LCD_PAGE_SIZE, y / LCD_PAGE_SIZE);
+}
+
+void SSD1306_setVLine(uint8_t x, uint8_t y0, uint8_t y1, color_t color) {
+    if (y0 > y1) SSD1306_swap(&y0, &y1);
+
+    // check if within bounds
+    if ((x >= LCD_WIDTH) || (y0 >= LCD_HEIGHT)) return;
+    if (y1 >= LCD_HEIGHT) y1 = LCD_HEIGHT - 1;
+
+    SSD1306_vspan(x, y0, y1, color);
+    SSD1306_markArea(x, x, y0 / LCD_PAGE_SIZE, y1 / LCD_PAGE_SIZE);
+}
+
+/*
+ * Sets a line in the buffer (Bresenham's algorithm)
  * x0 - beginning of the line in horizontal direction
  * y0 - beginning of the line in vertical direction
  * x1 - end of the line in horizontal direction
@@ -241,58 +575,134 @@ void SSD1306_setLine(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
         (y1 >= LCD_HEIGHT))
         return;
 
-    int i = 0;
-    // check if coordinates are not swapped
-    //
-    if (x0 > x1) {
-        SSD1306_swap(&x0, &x1);
-    }
-
-    if (y0 > y1) {
-        SSD1306_swap(&y0, &y1);
+    if (y0 == y1) {
+        SSD1306_setHLine(x0, x1, y0, color);
+        return;
     }
 
-    // check if vertical line
     if (x0 == x1) {
-        for (i = 0; i <= (y1 - y0); i++) {
-            SSD1306_setPixel(x0, y0 + i, color);
-        }
+        SSD1306_setVLine(x0, y0, y1, color);
         return;
     }
 
-    // check if horizontal line
-    if (y0 == y1) {
-        for (i = 0; i <= (x1 - x0); i++) {
-            SSD1306_setPixel(x0 + i, y0, color);
-        }
-        return;
+    // draw from left to right
+    if (x0 > x1) {
+        SSD1306_swap(&x0, &x1);
+        SSD1306_swap(&y0, &y1);
     }
 
-    // check the angle
-    if (y1 < x1) {
-        // iterate over horizontal direction
-        for (i = 0; i <= (x1 - x0); i++) {
-            SSD1306_setPixel(x0 + i, (y1 * (x0 + i)) / x1, color);
+    const int dx = x1 - x0;
+    const int dy = (y1 > y0) ? y1 - y0 : y0 - y1;
+    const int sy = (y1 > y0) ? 1 : -1;
+    int x = x0;
+    int y = y0;
+    int err;
+
+    if (dx >= dy) {
+        // a single pixel in every column
+        err = dx / 2;
+
+        for (; x <= x1; x++) {
+            SSD1306_applyMask(&displayBuffer[(y / LCD_PAGE_SIZE) * LCD_WIDTH + x],
+                              1 << (y & 7), color);
+            err -= dy;
+
+            if (err < 0) {
+                y += sy;
+                err += dx;
+            }
         }
     } else {
-        // iterate over vertical direction
-        for (i = 0; i <= (y1 - y0); i++) {
-            SSD1306_setPixel((x1 * (x0 + i)) / y1, y0 + i, color);
+        // steep line, a vertical run in every column
+        int start = y0;
+        err = dy / 2;
+
+        for (;; y += sy) {
+            err -= dx;
+
+            if (y == y1) {
+                SSD1306_vspan(x, sy > 0 ? start : y, sy > 0 ? y : start, color);
+                break;
+            }
+
+            if (err < 0) {
+                SSD1306_vspan(x, sy > 0 ? start : y, sy > 0 ? y : start, color);
+                start = y + sy;
+                ++x;
+                err += dy;
+            }
         }
     }
+
+    if (y0 > y1) SSD1306_swap(&y0, &y1);
+    SSD1306_markArea(x0, x1, y0 / LCD_PAGE_SIZE, y1 / LCD_PAGE_SIZE);
 }
 
-/*
- * Copies raw data to the buffer.
- */
-static void SSD1306_setBuffer(uint8_t x, uint8_t pageIndex, uint8_t *buffer,
-                       int size) {
+void SSD1306_fillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height,
+                      color_t color) {
     // check if within bounds
-    if ((pageIndex >= LCD_PAGES) || (x >= LCD_WIDTH)) return;
-    int i;
+    if ((x >= LCD_WIDTH) || (y >= LCD_HEIGHT) || !width || !height) return;
+
+    const int x1 = (x + width > LCD_WIDTH) ? LCD_WIDTH - 1 : x + width - 1;
+    const int y1 = (y + height > LCD_HEIGHT) ? LCD_HEIGHT - 1 : y + height - 1;
+    const int page0 = y / LCD_PAGE_SIZE;
+    const int page1 = y1 / LCD_PAGE_SIZE;
+
+    for (int page = page0; page <= page1; page++) {
+        uint8_t *ptr = &displayBuffer[page * LCD_WIDTH];
+        uint8_t mask = 0xff;
+
+        if (page == page0) mask &= 0xff << (y & 7);
+        if (page == page1) mask &= 0xff >> (7 - (y1 & 7));
 
-    for (i = 0; i < size; i++) {
-        displayBuffer[pageIndex * LCD_WIDTH + x + i] = buffer[i];
+        for (int i = x; i <= x1; i++) {
+            SSD1306_applyMask(&ptr[i], mask, color);
+        }
+    }
+
+    SSD1306_markArea(x, x1, page0, page1);
+}
+
+void SSD1306_setRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height,
+                     color_t color) {
+    // check if within bounds
+    if ((x >= LCD_WIDTH) || (y >= LCD_HEIGHT) || !width || !height) return;
+
+    const int x1 = x + width - 1;
+    const int y1 = y + height - 1;
+
+    SSD1306_setHLine(x, x1 < LCD_WIDTH ? x1 : LCD_WIDTH - 1, y, color);
+
+    if (height > 1 && y1 < LCD_HEIGHT)
+        SSD1306_setHLine(x, x1 < LCD_WIDTH ? x1 : LCD_WIDTH - 1, y1, color);
+
+    // sides without the corners, so inverting does not cancel them
+    const int side0 = y + 1;
+    const int side1 = (y1 - 1 < LCD_HEIGHT) ? y1 - 1 : LCD_HEIGHT - 1;
+
+    if (side0 <= side1) {
+        SSD1306_setVLine(x, side0, side1, color);
+
+        if (width > 1 && x1 < LCD_WIDTH)
+            SSD1306_setVLine(x1, side0, side1, color);
+    }
+}
+
+void SSD1306_setPage(uint8_t pageIndex, const uint8_t *data) {
+    // check if within bounds
+    if (pageIndex >= LCD_PAGES) return;
+
+    memcpy(&displayBuffer[pageIndex * LCD_WIDTH], data, LCD_WIDTH);
+    SSD1306_markRange(pageIndex * LCD_WIDTH, LCD_WIDTH);
+}
+
+void SSD1306_setColumn(uint8_t x, const uint8_t *column) {
+    // check if within bounds
+    if (x >= LCD_WIDTH) return;
+
+    for (int i = 0; i < LCD_PAGES; i++) {
+        displayBuffer[i * LCD_WIDTH + x] = column[i];
+        SSD1306_markColumn(x, i);
     }
 }
 
@@ -302,6 +712,10 @@ void SSD1306_clearBuffer(uint8_t x, uint8_t pageIndex, color_t color,
     if ((pageIndex >= LCD_PAGES) || (x >= LCD_WIDTH)) return;
 
     uint8_t value = 0;
+    int offset = pageIndex * LCD_WIDTH + x;
+
+    if (size > FRAME_SIZE - offset)
+        size = FRAME_SIZE - offset;
 
     switch (color) {
         case WHITE:
@@ -314,8 +728,59 @@ void SSD1306_clearBuffer(uint8_t x, uint8_t pageIndex, color_t color,
     }
 
     for (int i = 0; i < size; i++) {
-        displayBuffer[pageIndex * LCD_WIDTH + x + i] = value;
+        displayBuffer[offset + i] = value;
     }
+
+    SSD1306_markRange(offset, size);
+}
+
+/*
+ * Sets a string in the displayBuffer, text rows do not need to be aligned
+ * to pages
+ * x - beginning of the string in the horizontal plane
+ * y - top row of the string
+ * string - string to set
+ * size - number of characters
+ * color - black/white string
+ */
+void SSD1306_setText(uint8_t x, uint8_t y, const char *string, int size,
+                     color_t color) {
+    // check if within bounds
+    if ((x >= LCD_WIDTH) || (y >= LCD_HEIGHT) || size <= 0) return;
+
+    const int page = y / LCD_PAGE_SIZE;
+    const int shift = y & 7;
+    uint8_t *top = &displayBuffer[page * LCD_WIDTH];
+    // the bottom part of the glyphs may fall outside the display
+    uint8_t *bottom = (shift && page + 1 < LCD_PAGES) ? top + LCD_WIDTH : NULL;
+    const uint8_t topMask = 0xff << shift;
+    const uint8_t bottomMask = ~topMask;
+    const uint8_t invert = color ? 0x00 : 0xff;
+    const int end = (x + size * 6 > LCD_WIDTH) ? LCD_WIDTH : x + size * 6;
+    int col = x;
+
+    for (int i = 0; i < size && col < end; i++) {
+        uint8_t chr = string[i];
+
+        if (chr < ' ' || chr > 0x7f) chr = ' ';
+
+        const uint8_t *chrPtr = &SSD1306_font6x8[(chr - ' ') * 6];
+
+        for (int j = 0; j < 6 && col < end; j++, col++) {
+            const uint8_t data = chrPtr[j] ^ invert;
+
+            if (!shift) {
+                top[col] = data;
+                continue;
+            }
+
+            SSD1306_writeMask(&top[col], data << shift, topMask);
+
+            if (bottom) SSD1306_writeMask(&bottom[col], data >> (8 - shift), bottomMask);
+        }
+    }
+
+    SSD1306_markArea(x, end - 1, page, bottom ? page + 1 : page);
 }
 
 /*
@@ -328,50 +793,274 @@ void SSD1306_clearBuffer(uint8_t x, uint8_t pageIndex, color_t color,
  */
 void SSD1306_setString(uint8_t x, uint8_t pageIndex, const char *string,
                        int size, color_t color) {
-    // check if within bounds. check also the size?
-    if ((pageIndex >= LCD_PAGES) || (x >= LCD_WIDTH)) return;
+    // check if within bounds
+    if (pageIndex >= LCD_PAGES) return;
 
-    int i;
-    int j;
+    SSD1306_setText(x, pageIndex * LCD_PAGE_SIZE, string, size, color);
+}
 
-    uint8_t stringBuffer[size * 6];
-    uint8_t *strPtr = stringBuffer;
-    const uint8_t *chrPtr;
-    uint8_t temp;
+/*
+ * Copies a page of a bitmap in the display layout
+ * x - horizontal coordinate of the top-left corner of the bitmap
+ * y - vertical coordinate of the top-left corner of the bitmap
+ * src - page data
+ * cols - number of drawn columns
+ * rows - number of drawn bitmap rows
+ * pageIndex - index of the bitmap page
+ */
+static void SSD1306_blitPage(uint8_t x, uint8_t y, const uint8_t *src, int cols,
+                             int rows, int pageIndex) {
+    const int shift = y & 7;
+    // rows of this page that are drawn
+    const int srcRows = (rows - pageIndex * 8 < 8) ? rows - pageIndex * 8 : 8;
+    const uint8_t srcMask = 0xff >> (8 - srcRows);
+    const int page = y / LCD_PAGE_SIZE + pageIndex;
+    uint8_t *dst = &displayBuffer[page * LCD_WIDTH + x];
+
+    if (!shift && srcRows == 8) {
+        // page-aligned, a plain copy
+        if (dst != src) memcpy(dst, src, cols);
+        return;
+    }
 
-    for (i = 0; i < size; i++) {
-        chrPtr = &SSD1306_font6x8[(string[i] - ' ') * 6];
+    for (int j = 0; j < cols; j++) {
+        SSD1306_writeMask(&dst[j], src[j] << shift, srcMask << shift);
+    }
 
-        for (j = 0; j < 6; j++) {
-            temp = *chrPtr;
+    // part shifted to the next page
+    if (shift && page + 1 <= (y + rows - 1) / LCD_PAGE_SIZE) {
+        dst += LCD_WIDTH;
 
-            if (!color) {
-                temp = ~temp;
-            }
-            *strPtr = temp;
-            ++strPtr;
-            ++chrPtr;
+        for (int j = 0; j < cols; j++) {
+            SSD1306_writeMask(&dst[j], src[j] >> (8 - shift),
+                              srcMask >> (8 - shift));
         }
     }
+}
+
+/*
+ * Copies a bitmap in the display layout (column bytes, pages top to bottom)
+ * x - horizontal coordinate of the top-left corner
+ * y - vertical coordinate of the top-left corner
+ * bitmap - bitmap data, (height + 7) / 8 pages of width bytes each
+ * width, height - bitmap size in pixels
+ */
+void SSD1306_blit(uint8_t x, uint8_t y, const uint8_t *bitmap, uint8_t width,
+                  uint8_t height) {
+    // check if within bounds
+    if ((x >= LCD_WIDTH) || (y >= LCD_HEIGHT) || !width || !height) return;
+
+    const int cols = (x + width > LCD_WIDTH) ? LCD_WIDTH - x : width;
+    const int rows = (y + height > LCD_HEIGHT) ? LCD_HEIGHT - y : height;
+
+    for (int i = 0; i < (rows + 7) / 8; i++) {
+        SSD1306_blitPage(x, y, &bitmap[i * width], cols, rows, i);
+    }
 
-    SSD1306_setBuffer(x, pageIndex, stringBuffer, size * 6);
+    SSD1306_markArea(x, x + cols - 1, y / LCD_PAGE_SIZE,
+                     (y + rows - 1) / LCD_PAGE_SIZE);
 }
 
-void SSD1306_drawBitmap(uint8_t x0, uint8_t y0, const uint8_t *bitmap,
-                        uint8_t width, uint8_t height) {
-    const uint8_t *ptr = bitmap;
+/*
+ * Decodes RLE compressed bitmap data (see scripts/gfx_convert.py)
+ * data - pointer to the compressed data, advanced to the next block
+ * remaining - bytes left in the current block, kept between calls
+ * value - repeated byte, 0 for literal blocks
+ * out - output buffer
+ * size - number of bytes to decode
+ */
+static void SSD1306_decodeRLE(const uint8_t **data, int *remaining, int *run,
+                              uint8_t *out, int size) {
+    const uint8_t *ptr = *data;
+
+    while (size > 0) {
+        if (*remaining == 0) {
+            const uint8_t header = *ptr++;
 
-    for (int y = y0; y < y0 + height; ++y) {
-        for (int x = x0 / 8; x < (x0 + width) / 8; ++x) {
-            uint8_t data = *ptr;
+            *run = header & 0x80;
+            *remaining = *run ? header - 0x80 + 2 : header + 1;
+        }
+
+        const int count = (*remaining < size) ? *remaining : size;
 
-            for (int i = 7; i >= 0; --i) {
-                SSD1306_setPixel(x * 8 + (7 - i), y, (data & (1 << i)) ? 0 : 1);
+        if (*run) {
+            // the repeated byte follows the header, skipped at the block end
+            memset(out, *ptr, count);
+            if (count == *remaining) ++ptr;
+        } else {
+            memcpy(out, ptr, count);
+            ptr += count;
+        }
+
+        out += count;
+        size -= count;
+        *remaining -= count;
+    }
+
+    *data = ptr;
+}
+
+void SSD1306_drawImage(uint8_t x, uint8_t y, const bitmap_t *bitmap) {
+    if (!bitmap->compressed) {
+        SSD1306_blit(x, y, bitmap->data, bitmap->width, bitmap->height);
+        return;
+    }
+
+    // check if within bounds
+    if ((x >= LCD_WIDTH) || (y >= LCD_HEIGHT)) return;
+
+    const int width = bitmap->width;
+    const int cols = (x + width > LCD_WIDTH) ? LCD_WIDTH - x : width;
+    const int rows = (y + bitmap->height > LCD_HEIGHT) ? LCD_HEIGHT - y
+                                                       : bitmap->height;
+    const uint8_t *data = bitmap->data;
+    int remaining = 0, run = 0;
+    uint8_t line[LCD_WIDTH];
+
+    for (int i = 0; i < (rows + 7) / 8; i++) {
+        // aligned pages are decoded directly to the buffer
+        const int aligned = !(y & 7) && rows - i * 8 >= 8;
+        uint8_t *out = aligned
+                     ? &displayBuffer[(y / LCD_PAGE_SIZE + i) * LCD_WIDTH + x]
+                     : line;
+        uint8_t skip[16];
+
+        SSD1306_decodeRLE(&data, &remaining, &run, out, cols);
+
+        // columns outside the display
+        for (int j = cols; j < width; j += sizeof(skip)) {
+            SSD1306_decodeRLE(&data, &remaining, &run, skip,
+                              (width - j < (int) sizeof(skip)) ? width - j : (int) sizeof(skip));
+        }
+
+        SSD1306_blitPage(x, y, out, cols, rows, i);
+    }
+
+    SSD1306_markArea(x, x + cols - 1, y / LCD_PAGE_SIZE,
+                     (y + rows - 1) / LCD_PAGE_SIZE);
+}
+
+/*
+ * Finds the glyph of a character
+ * font - font
+ * chr - character
+ * offset - glyph data offset
+ * returns glyph width, 0 for missing characters
+ */
+static int SSD1306_getGlyph(const font_t *font, uint8_t chr, int *offset) {
+    if (chr < font->first || chr > font->last) return 0;
+
+    const uint16_t *offsets = &font->offsets[chr - font->first];
+
+    *offset = offsets[0];
+
+    return (offsets[1] - offsets[0]) / (font->height / LCD_PAGE_SIZE);
+}
+
+/*
+ * Finds the gap adjustment for a pair of characters (binary search)
+ * font - font
+ * left - preceding character
+ * right - following character
+ */
+static int SSD1306_getKerning(const font_t *font, uint8_t left, uint8_t right) {
+    const uint16_t key = (left << 8) | right;
+    int low = 0, high = font->kerningCount - 1;
+
+    while (low <= high) {
+        const int mid = (low + high) / 2;
+        const uint16_t midKey = (font->kerning[mid].left << 8) | font->kerning[mid].right;
+
+        if (midKey == key) return font->kerning[mid].offset;
+
+        if (midKey < key) low = mid + 1;
+        else high = mid - 1;
+    }
+
+    return 0;
+}
+
+int SSD1306_getTextWidth(const char *string, int size, const font_t *font) {
+    int width = 0, prev = -1, offset;
+
+    for (int i = 0; i < size; i++) {
+        const uint8_t chr = string[i];
+        const int glyphWidth = SSD1306_getGlyph(font, chr, &offset);
+
+        if (!glyphWidth) continue;
+
+        if (prev >= 0) width += font->spacing + SSD1306_getKerning(font, prev, chr);
+
+        width += glyphWidth;
+        prev = chr;
+    }
+
+    return width;
+}
+
+/*
+ * Sets a string in the displayBuffer using a proportional font, whole glyph
+ * columns are copied to the buffer
+ * x - beginning of the string in the horizontal plane
+ * y - top row of the string
+ * string - string to set
+ * size - number of characters
+ * font - font
+ * color - black/white string
+ */
+int SSD1306_setTextFont(uint8_t x, uint8_t y, const char *string, int size,
+                        const font_t *font, color_t color) {
+    // check if within bounds
+    if ((x >= LCD_WIDTH) || (y >= LCD_HEIGHT) || size <= 0) return x;
+
+    const int rows = (y + font->height > LCD_HEIGHT) ? LCD_HEIGHT - y : font->height;
+    // inverted text uses the precomputed glyphs, when available
+    const uint8_t *glyphs = (color || !font->inverted) ? font->glyphs : font->inverted;
+    const uint8_t invert = (color || font->inverted) ? 0x00 : 0xff;
+    const color_t background = color ? BLACK : WHITE;
+    uint8_t line[LCD_WIDTH];
+    int col = x, prev = -1, offset;
+
+    for (int i = 0; i < size && col < LCD_WIDTH; i++) {
+        const uint8_t chr = string[i];
+        const int width = SSD1306_getGlyph(font, chr, &offset);
+
+        if (!width) continue;
+
+        if (prev >= 0) {
+            int gap = font->spacing + SSD1306_getKerning(font, prev, chr);
+
+            for (; gap > 0 && col < LCD_WIDTH; gap--, col++) {
+                SSD1306_vspan(col, y, y + rows - 1, background);
             }
 
-            ++ptr;
+            if (col >= LCD_WIDTH) break;
         }
+
+        const int cols = (col + width > LCD_WIDTH) ? LCD_WIDTH - col : width;
+
+        for (int j = 0; j < (rows + 7) / 8; j++) {
+            const uint8_t *src = &glyphs[offset + j * width];
+
+            if (invert) {
+                for (int k = 0; k < cols; k++) line[k] = src[k] ^ invert;
+
+                src = line;
+            }
+
+            SSD1306_blitPage(col, y, src, cols, rows, j);
+        }
+
+        col += width;
+        prev = chr;
+    }
+
+    if (col > x) {
+        SSD1306_markArea(x, (col > LCD_WIDTH ? LCD_WIDTH : col) - 1,
+                         y / LCD_PAGE_SIZE, (y + rows - 1) / LCD_PAGE_SIZE);
     }
+
+    return col;
 }
 
 /*
@@ -384,14 +1073,17 @@ void SSD1306_drawBitmap(uint8_t x0, uint8_t y0, const uint8_t *bitmap,
  * pageBuffer - data to send
  */
 void SSD1306_drawPage(uint8_t pageIndex, const uint8_t *pageBuffer) {
-    // commands to set page address and column starting point at 2: this display
-    // is shifted by 2 pixels so the column ranges from 2-129
-    const uint8_t cmds[5] = {SSD1306_PAGESTART + pageIndex, SSD1306_SETLOWCOLUMN,
-                       SSD1306_OFFSET, SSD1306_SETHIGHCOLUMN, 0x10};
+    uint8_t cmds[WINDOW_CMDS];
+    int count = SSD1306_setWindow(cmds, pageIndex, pageIndex, 0, LCD_WIDTH - 1);
 
-    io_configure(IO_I2C_LCD);
-    SSD1306_writeCmd(cmds, sizeof(cmds));
-    SSD1306_writeData(pageBuffer, LCD_WIDTH, 0);
+    SSD1306_wait();
+    SSD1306_writeCmd(cmds, count);
+    SSD1306_writeData(pageBuffer, LCD_WIDTH);
+
+    // the page may differ from the displayBuffer contents now
+    memcpy(&panelBuffer[pageIndex * LCD_WIDTH], pageBuffer, LCD_WIDTH);
+    SSD1306_markRange(pageIndex * LCD_WIDTH, LCD_WIDTH);
+    SSD1306_markMirror(0, LCD_WIDTH - 1, pageIndex);
 }
 
 /*
@@ -400,34 +1092,305 @@ void SSD1306_drawPage(uint8_t pageIndex, const uint8_t *pageBuffer) {
  * pageBuffer - data to send
  */
 void SSD1306_drawPageDMA(uint8_t pageIndex, const uint8_t *pageBuffer) {
+    uint8_t cmds[WINDOW_CMDS];
+    int count = SSD1306_setWindow(cmds, pageIndex, pageIndex, 0, LCD_WIDTH - 1);
+
+    SSD1306_wait();
     busy = 1;
-    // commands to set page address and column starting point at 2: this display
-    // is shifted by 2 pixels so the column ranges from 2-129
-    const uint8_t cmds[5] = {SSD1306_PAGESTART + pageIndex, SSD1306_SETLOWCOLUMN,
-                       SSD1306_OFFSET, SSD1306_SETHIGHCOLUMN, 0x10};
+    // no more pages to transfer afterwards
+    xferPage = LCD_PAGES;
+    xferSpans = -1;
 
+    SSD1306_startDMA(cmds, count, pageBuffer, LCD_WIDTH);
+
+    // the page may differ from the displayBuffer contents now
+    memcpy(&panelBuffer[pageIndex * LCD_WIDTH], pageBuffer, LCD_WIDTH);
+    SSD1306_markRange(pageIndex * LCD_WIDTH, LCD_WIDTH);
+    SSD1306_markMirror(0, LCD_WIDTH - 1, pageIndex);
+}
+
+/*
+ * Returns the first page starting from pageIndex that has a span
+ * to be transferred, LCD_PAGES if there are none
+ */
+static int SSD1306_nextSpan(int pageIndex) {
+    while (pageIndex < LCD_PAGES && xferStart[pageIndex] > xferEnd[pageIndex])
+        ++pageIndex;
+
+    return pageIndex;
+}
+
+/*
+ * Returns 1 if the whole page is going to be transferred
+ */
+static inline int SSD1306_isFullSpan(int pageIndex) {
+    return xferStart[pageIndex] == 0 && xferEnd[pageIndex] == LCD_WIDTH - 1;
+}
+
+/*
+ * Starts a DMA transaction sending the next span of the frontBuffer
+ * returns 0 if there is nothing left to transfer
+ */
+static int SSD1306_nextTransfer(void) {
+    uint8_t cmds[WINDOW_CMDS];
+    int first = SSD1306_nextSpan(xferPage);
+    int last = first;
+    int count;
+
+    if (first >= LCD_PAGES) return 0;
+
+#ifndef LCD_SH1106
+    // consecutive full pages are contiguous in the buffer
+    if (SSD1306_isFullSpan(first)) {
+        while (last + 1 < LCD_PAGES && last + 1 - first < XFER_MAX_PAGES
+                && SSD1306_isFullSpan(last + 1)) ++last;
+    }
+#endif
+
+    xferPage = last + 1;
+    count = SSD1306_setWindow(cmds, first, last, xferStart[first], xferEnd[first]);
+    SSD1306_startDMA(cmds, count,
+                     &frontBuffer[first * LCD_WIDTH + xferStart[first]],
+                     (last - first) * LCD_WIDTH + xferEnd[first] - xferStart[first] + 1);
+
+    return 1;
+}
+
+/*
+ * Restores the display start line, so the display memory pages are shown
+ * in order again. The panelBuffer stays valid, it follows the memory layout.
+ */
+static void SSD1306_resetStartLine(void) {
+    const uint8_t cmds[1] = {SSD1306_SETSTARTLINE};
+
+    if (!startLine) return;
+
+    SSD1306_wait();
     SSD1306_writeCmd(cmds, sizeof(cmds));
-    SSD1306_writeData(pageBuffer, LCD_WIDTH, 1);
+    startLine = 0;
+    SSD1306_markMirrorAll();
+}
+
+void SSD1306_scrollText(const char *string, int size, color_t color, int scroll) {
+    const uint8_t invert = color == BLACK ? 0xff : 0x00;
+    uint8_t cmds[WINDOW_CMDS + 1];
+    int pageIndex, count, col = 0;
+
+    SSD1306_wait();
+
+    for (int i = 0; i < size && col + 6 <= LCD_WIDTH; i++) {
+        uint8_t chr = string[i];
+
+        if (chr < ' ' || chr > 0x7f) chr = ' ';
+
+        for (int j = 0; j < 6; j++) {
+            scrollLine[col++] = SSD1306_font6x8[(chr - ' ') * 6 + j] ^ invert;
+        }
+    }
+
+    memset(&scrollLine[col], invert, LCD_WIDTH - col);
+
+    // the top page becomes the bottom one when the start line moves
+    // by a page, it is updated right after the start line command
+    if (scroll) startLine = (startLine + LCD_PAGE_SIZE) % LCD_HEIGHT;
+
+    pageIndex = (startLine / LCD_PAGE_SIZE + LCD_PAGES - 1) % LCD_PAGES;
+    cmds[0] = SSD1306_SETSTARTLINE | startLine;
+    count = SSD1306_setWindow(&cmds[1], pageIndex, pageIndex, 0, LCD_WIDTH - 1);
+
+    busy = 1;
+    xferPage = LCD_PAGES;
+    xferSpans = -1;
+    SSD1306_startDMA(cmds, count + 1, scrollLine, LCD_WIDTH);
+
+    // the page differs from the displayBuffer contents now
+    memcpy(&panelBuffer[pageIndex * LCD_WIDTH], scrollLine, LCD_WIDTH);
+    SSD1306_markRange(pageIndex * LCD_WIDTH, LCD_WIDTH);
+
+    if (scroll) {
+        SSD1306_markMirrorAll();
+    } else {
+        SSD1306_markMirror(0, LCD_WIDTH - 1, pageIndex);
+    }
 }
 
 /*
  * Sends a displayBuffer to the display
  */
 void SSD1306_drawBuffer(void) {
+    SSD1306_resetStartLine();
+
     for (uint16_t i = 0; i < LCD_PAGES; i++) {
         SSD1306_drawPage(i, displayBuffer + (i * LCD_WIDTH));
     }
+
+    panelValid = 1;
+    SSD1306_markClean();
+}
+
+/*
+ * Draws the frame rate in the top right corner of a frame (inverted text)
+ * frame - frame to draw in
+ * returns the first column of the overlay
+ */
+static int SSD1306_drawFps(uint8_t *frame) {
+    char text[16];
+    int len = sprintf(text, "%lu fps", fps);
+    int x = LCD_WIDTH - len * 6;
+
+    for (int i = 0; i < len; i++) {
+        for (int j = 0; j < 6; j++) {
+            frame[x + i * 6 + j] = SSD1306_font6x8[(text[i] - ' ') * 6 + j] ^ 0xff;
+        }
+    }
+
+    return x;
+}
+
+/*
+ * Marks the overlay columns of the top page as modified, they differ
+ * from the displayBuffer contents
+ * x - first column of the overlay
+ */
+static void SSD1306_markOverlay(int x) {
+    if (x < dirtyStart[0]) dirtyStart[0] = x;
+    dirtyEnd[0] = LCD_WIDTH - 1;
 }
 
 /*
- * Sends a displayBuffer to the display using DMA for transfer
+ * Sends the modified parts of the displayBuffer to the display
+ * using DMA for transfer, then swaps the buffers
  */
 void SSD1306_drawBufferDMA(void) {
+    const uint32_t now = DWT->CYCCNT;
+    const uint32_t hz = sysclk_get_cpu_hz();
+    uint8_t *back;
+    int first, overlay = LCD_WIDTH;
+#ifndef LCD_SH1106
+    int last = 0, spans = 0;
+#endif
+
+    if (drawTime) SSD1306_addStat(STAT_DRAW, now - drawTime);
+
+    // frames presented within the last second (at least)
+    ++fpsFrames;
+
+    if (now - fpsTime >= hz) {
+        fps = (uint64_t)fpsFrames * hz / (now - fpsTime);
+        fpsTime = now;
+        fpsFrames = 0;
+    }
+
+    // the previous frame might be still transferred from the front buffer
+    SSD1306_wait();
+    SSD1306_resetStartLine();
+    drawTime = 0;
+
+    // the presented frame becomes the front buffer, drawing continues
+    // in the other one starting from the same contents
+    back = frontBuffer;
+    frontBuffer = displayBuffer;
+    displayBuffer = back;
+    memcpy(displayBuffer, frontBuffer, FRAME_SIZE);
+
+    // the overlay is drawn only in the transferred frame
+    if (fpsOverlay) {
+        overlay = SSD1306_drawFps(frontBuffer);
+        SSD1306_markOverlay(overlay);
+    }
+
+    for (int i = 0; i < LCD_PAGES; i++) {
+        const uint8_t *buf = &frontBuffer[i * LCD_WIDTH];
+        const uint8_t *panel = &panelBuffer[i * LCD_WIDTH];
+        int start = dirtyStart[i];
+        int end = dirtyEnd[i];
+
+        // redrawn contents are often the same, skip the unchanged columns
+        if (panelValid) {
+            while (start <= end && buf[start] == panel[start]) ++start;
+            while (end >= start && buf[end] == panel[end]) --end;
+        }
+
+        if (start <= end) {
+            xferStart[i] = start;
+            xferEnd[i] = end;
+        } else {
+            xferStart[i] = LCD_WIDTH;
+            xferEnd[i] = 0;
+        }
+    }
+
+    xferPage = 0;
+    first = SSD1306_nextSpan(0);
+
+    // nothing has changed
+    if (first >= LCD_PAGES) {
+        SSD1306_markClean();
+        if (fpsOverlay) SSD1306_markOverlay(overlay);
+        return;
+    }
+
+#ifndef LCD_SH1106
+    // when most of the frame has changed, a single transaction sending
+    // whole pages is cheaper than a transaction per span
+    for (int i = first; i < LCD_PAGES; i++) {
+        if (xferStart[i] <= xferEnd[i]) {
+            spans += xferEnd[i] - xferStart[i] + 1 + XFER_OVERHEAD;
+            last = i;
+        }
+    }
+
+    if ((last - first + 1) * LCD_WIDTH + XFER_OVERHEAD <= spans) {
+        for (int i = first; i <= last; i++) {
+            xferStart[i] = 0;
+            xferEnd[i] = LCD_WIDTH - 1;
+        }
+    }
+#endif
+
+    for (int i = first; i < LCD_PAGES; i++) {
+        if (xferStart[i] <= xferEnd[i]) {
+            memcpy(&panelBuffer[i * LCD_WIDTH + xferStart[i]],
+                   &frontBuffer[i * LCD_WIDTH + xferStart[i]],
+                   xferEnd[i] - xferStart[i] + 1);
+            SSD1306_markMirror(xferStart[i], xferEnd[i], i);
+        }
+    }
+
+    panelValid = 1;
+    SSD1306_markClean();
+
+    // the next frame redraws the overlay or restores the columns once
+    // it is hidden
+    if (fpsOverlay) SSD1306_markOverlay(overlay);
+
     busy = 1;
-    dma_transfers = LCD_PAGES;
-    io_configure(IO_I2C_LCD);
+    presentTime = now;
+    xferBytes = 0;
+    xferSpans = 0;
+    SSD1306_nextTransfer();
+}
+
+int SSD1306_getMirrorSpan(uint8_t *pageIndex, uint8_t *x, const uint8_t **data) {
+    if (mirrorMode == CMD_LCD_MIRROR_OFF) return 0;
+
+    for (int i = 0; i < LCD_PAGES; i++) {
+        if (mirrorStart[i] <= mirrorEnd[i]) {
+            const int size = mirrorEnd[i] - mirrorStart[i] + 1;
 
-    SSD1306_drawPageDMA(0, displayBuffer);
+            // panel memory page shown at the page position on the screen
+            *pageIndex = (i + LCD_PAGES - startLine / LCD_PAGE_SIZE) % LCD_PAGES;
+            *x = mirrorStart[i];
+            *data = &panelBuffer[i * LCD_WIDTH + mirrorStart[i]];
+
+            mirrorStart[i] = LCD_WIDTH;
+            mirrorEnd[i] = 0;
+
+            return size;
+        }
+    }
+
+    return 0;
 }
 
 int SSD1306_isBusy(void) {
@@ -443,44 +1406,174 @@ void SSD1306_clear(void) {
         buffer[i] = 0x00;
     }
 
+    SSD1306_resetStartLine();
+
     for (i = 0; i < LCD_PAGES; i++) {
         SSD1306_drawPage(i, buffer);
     }
+
+    panelValid = 1;
 }
 
 void SSD1306_clearBufferFull(void) {
-    memset(displayBuffer, 0x00, sizeof(displayBuffer));
+    memset(displayBuffer, 0x00, FRAME_SIZE);
+    SSD1306_markAll();
 }
 
-void TWI0_Handler(void) {
-    uint32_t status;
+/*
+ * Called by the TWI queue (interrupt context) when a DMA transaction is finished
+ */
+static void SSD1306_xferDone(twi_xfer_t *finished) {
+    if (finished->status != TWI_SUCCESS) {
+        // the display has not responded, its memory contents are unknown
+        xferPage = LCD_PAGES;
+        xferSpans = -1;
+        SSD1306_invalidate();
+        busy = 0;
+        return;
+    }
 
-    status = twi_get_interrupt_mask(TWI0);
+    if (xferSpans >= 0) {
+        if (xferSpans++ == 0) {
+            xferTime = finished->started;
+            SSD1306_addStat(STAT_QUEUE, xferTime - presentTime);
+        }
 
-    int pIndex;
+        // slave address, the first control byte, commands and data
+        xferBytes += 2 + finished->prefix_length + finished->length;
+    }
+
+    if (!SSD1306_nextTransfer()) {
+        if (xferSpans > 0) {
+            SSD1306_addStat(STAT_TRANSFER, DWT->CYCCNT - xferTime);
+            SSD1306_addStat(STAT_BYTES, xferBytes);
+            xferSpans = -1;
+        }
+
+        busy = 0;
+    }
+}
 
-    if ((status & TWI_IMR_ENDTX) == TWI_IMR_ENDTX) {
-        twi_disable_interrupt(TWI0, TWI_SR_ENDTX);
+/*
+ * Writes the frame statistics to the response (CMD_LCD_STATS)
+ * flags - CMD_LCD_STATS_* flags
+ */
+static void SSD1306_respStats(uint8_t flags) {
+    const uint32_t cyclesPerUs = sysclk_get_cpu_hz() / 1000000;
+    frame_stat_t stats[STAT_COUNT];
+    irqflags_t irq;
+
+    // transfer statistics are updated in the interrupt context
+    irq = cpu_irq_save();
+    memcpy(stats, frameStats, sizeof(stats));
+
+    if (flags & CMD_LCD_STATS_RESET) {
+        memset(frameStats, 0, sizeof(frameStats));
     }
 
-    dma_transfers--;
+    cpu_irq_restore(irq);
 
-    /* Disable the RX and TX PDC transfer requests */
-    pdc_disable_transfer(g_p_twim_pdc, PERIPH_PTCR_TXTDIS | PERIPH_PTCR_RXTDIS);
+    cmd_resp_write_u32(stats[STAT_TRANSFER].count);
+    cmd_resp_write_u32(fps);
 
-    while ((twi_read_status(TWI0) & TWI_SR_TXRDY) == 0);
+    for (int i = 0; i < STAT_COUNT; i++) {
+        const uint32_t div = (i == STAT_BYTES) ? 1 : cyclesPerUs;
+        const uint32_t avg = stats[i].count ? stats[i].sum / stats[i].count : 0;
 
-    TWI0->TWI_CR = TWI_CR_STOP;
-    while (!(TWI0->TWI_SR & TWI_SR_TXCOMP)) {
+        cmd_resp_write_u32(stats[i].min / div);
+        cmd_resp_write_u32(avg / div);
+        cmd_resp_write_u32(stats[i].max / div);
     }
 
-    if (dma_transfers > 0) {
-        pIndex = LCD_PAGES - dma_transfers;
-        SSD1306_drawPageDMA(pIndex, displayBuffer + (pIndex * LCD_WIDTH));
-    } else {
-        busy = 0;
-        dma_transfers = 0;
+    fpsOverlay = (flags & CMD_LCD_STATS_OVERLAY) ? 1 : 0;
+}
+
+/*
+ * Writes data received from the host to a rectangular area of the buffer
+ * x - first column of the area
+ * pageIndex - first page of the area
+ * width - area width, data fills the area page by page
+ * data - data encoded according to the flags
+ * size - data length
+ * encoding - CMD_LCD_BLIT_* flags
+ * returns 0 if the data is malformed or does not fit the display
+ */
+static int SSD1306_blitHost(uint8_t x, uint8_t pageIndex, uint8_t width,
+                            const uint8_t *data, int size, int encoding) {
+    int page = pageIndex, col = 0, ret = 1;
+
+    while (size > 0 && ret) {
+        const uint8_t *src = data;
+        uint8_t value = 0;
+        int count;
+
+        if (encoding & CMD_LCD_BLIT_RLE) {
+            const uint8_t header = *data++;
+            // bytes following the header
+            const int length = (header & 0x80) ? 1 : header + 1;
+
+            if (--size < length) {
+                ret = 0;
+                break;
+            }
+
+            if (header & 0x80) {
+                // a repeated byte
+                count = header - 0x80 + 2;
+                src = NULL;
+                value = *data;
+            } else {
+                count = length;
+                src = data;
+            }
+
+            data += length;
+            size -= length;
+        } else {
+            count = size;
+            size = 0;
+        }
+
+        while (count > 0) {
+            if (page >= LCD_PAGES) {
+                ret = 0;
+                break;
+            }
+
+            uint8_t *dst = &displayBuffer[page * LCD_WIDTH + x + col];
+            const int n = (count < width - col) ? count : width - col;
+
+            if (encoding & CMD_LCD_BLIT_DELTA) {
+                // unchanged areas are runs of zeros
+                if (src) {
+                    for (int i = 0; i < n; i++) dst[i] ^= src[i];
+                } else if (value) {
+                    for (int i = 0; i < n; i++) dst[i] ^= value;
+                }
+            } else if (src) {
+                memcpy(dst, src, n);
+            } else {
+                memset(dst, value, n);
+            }
+
+            if (src) src += n;
+
+            count -= n;
+            col += n;
+
+            if (col == width) {
+                col = 0;
+                ++page;
+            }
+        }
     }
+
+    // pages that have been written to
+    if (page > pageIndex || col) {
+        SSD1306_markArea(x, x + width - 1, pageIndex, col ? page : page - 1);
+    }
+
+    return ret;
 }
 
 void cmd_lcd(const uint8_t *data_in, unsigned int input_len) {
@@ -492,8 +1585,6 @@ void cmd_lcd(const uint8_t *data_in, unsigned int input_len) {
             break;
 
         case CMD_LCD_REFRESH:
-            while (SSD1306_isBusy())
-                ;
             SSD1306_drawBufferDMA();
             break;
 
@@ -506,6 +1597,60 @@ void cmd_lcd(const uint8_t *data_in, unsigned int input_len) {
                               (const char *)&data_in[4], data_in[3], WHITE);
             break;
 
+        case CMD_LCD_READ:
+            if (input_len < 2 || data_in[1] >= LCD_PAGES) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            cmd_resp_writen(&displayBuffer[data_in[1] * LCD_WIDTH], LCD_WIDTH);
+            break;
+
+        case CMD_LCD_MIRROR:
+            if (input_len < 2 || data_in[1] > CMD_LCD_MIRROR_FRAMES) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            if (data_in[1] != mirrorMode) {
+                memset(mirrorStart, LCD_WIDTH, sizeof(mirrorStart));
+                memset(mirrorEnd, 0, sizeof(mirrorEnd));
+                mirrorMode = data_in[1];
+
+                // the host starts with the current panel contents
+                if (panelValid) {
+                    for (int i = 0; i < LCD_PAGES; i++) {
+                        SSD1306_markMirror(0, LCD_WIDTH - 1, i);
+                    }
+                }
+            }
+            break;
+
+        case CMD_LCD_BLIT:
+            if (input_len < 5 || data_in[1] >= LCD_WIDTH || data_in[2] >= LCD_PAGES
+                    || data_in[3] == 0 || data_in[1] + data_in[3] > LCD_WIDTH) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            if (!SSD1306_blitHost(data_in[1], data_in[2], data_in[3], &data_in[5],
+                                  input_len - 5, data_in[4])) {
+                cmd_resp_init(CMD_RESP_EXEC_ERR);
+                return;
+            }
+
+            if (data_in[4] & CMD_LCD_BLIT_REFRESH) SSD1306_drawBufferDMA();
+            break;
+
+        case CMD_LCD_STATS:
+            if (input_len < 2) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            SSD1306_respStats(data_in[1]);
+            break;
+
         default:
             cmd_resp_init(CMD_RESP_INVALID_CMD);
             return;
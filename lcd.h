@@ -21,13 +21,50 @@
 #ifndef LCD_H
 #define LCD_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define LCD_WIDTH           128
 #define LCD_HEIGHT          64
 #define LCD_PAGE_SIZE       8
-#define LCD_PAGES           LCD_HEIGHT/LCD_PAGE_SIZE
+#define LCD_PAGES           (LCD_HEIGHT / LCD_PAGE_SIZE)
 #define LCD_I2C_CLOCK       400000
+/* Approximate refresh rate, depends on the display oscillator */
+#define LCD_FRAME_RATE      105
+
+/* display controller:
+ * SSD1306 (normally 0.96") if commented out
+ * SH1106  (normally 1.2")
+ */
+#define LCD_SH1106
+
+/* Bitmap in the display layout, generated by scripts/gfx_convert.py */
+typedef struct {
+    uint8_t width;          ///< Bitmap width (pixels)
+    uint8_t height;         ///< Bitmap height (pixels)
+    uint8_t compressed;     ///< 1 if the data is RLE compressed
+    const uint8_t *data;    ///< Pages of column bytes, see SSD1306_blit()
+} bitmap_t;
+
+/* Kerning pair, adjusts the gap between two characters */
+typedef struct {
+    uint8_t left;           ///< Preceding character
+    uint8_t right;          ///< Following character
+    int8_t offset;          ///< Gap adjustment (columns)
+} font_kern_t;
+
+/* Proportional font, generated by scripts/gfx_convert.py */
+typedef struct {
+    uint8_t height;         ///< Glyph height (pixels, multiple of 8)
+    uint8_t spacing;        ///< Gap between glyphs (columns)
+    uint8_t first;          ///< First character in the font
+    uint8_t last;           ///< Last character in the font
+    const uint16_t *offsets;        ///< Glyph data offsets (last - first + 2 entries)
+    const uint8_t *glyphs;          ///< Glyphs in the bitmap layout, see SSD1306_blit()
+    const uint8_t *inverted;        ///< Inverted glyphs or NULL
+    const font_kern_t *kerning;     ///< Kerning pairs sorted by characters or NULL
+    uint16_t kerningCount;          ///< Number of kerning pairs
+} font_t;
 
 typedef enum {
     BLACK,      ///< Draw 'off' pixels
@@ -82,6 +119,50 @@ void SSD1306_setPixel(uint8_t x, uint8_t y, color_t color);
  */
 void SSD1306_setLine(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, color_t color);
 
+/**
+ * Draws a horizontal line segment.
+ *
+ * @param x0 is the horizontal coordinate of the origin.
+ * @param x1 is the horizontal coordinate of the end.
+ * @param y is the vertical coordinate.
+ * @param color defines the line color.
+ */
+void SSD1306_setHLine(uint8_t x0, uint8_t x1, uint8_t y, color_t color);
+
+/**
+ * Draws a vertical line segment, whole column bytes are modified at once.
+ *
+ * @param x is the horizontal coordinate.
+ * @param y0 is the vertical coordinate of the origin.
+ * @param y1 is the vertical coordinate of the end.
+ * @param color defines the line color.
+ */
+void SSD1306_setVLine(uint8_t x, uint8_t y0, uint8_t y1, color_t color);
+
+/**
+ * Draws a rectangle outline.
+ *
+ * @param x is the horizontal coordinate of the top-left corner.
+ * @param y is the vertical coordinate of the top-left corner.
+ * @param width is the rectangle width (pixels).
+ * @param height is the rectangle height (pixels).
+ * @param color defines the outline color.
+ */
+void SSD1306_setRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height,
+        color_t color);
+
+/**
+ * Draws a filled rectangle.
+ *
+ * @param x is the horizontal coordinate of the top-left corner.
+ * @param y is the vertical coordinate of the top-left corner.
+ * @param width is the rectangle width (pixels).
+ * @param height is the rectangle height (pixels).
+ * @param color defines the fill color.
+ */
+void SSD1306_fillRect(uint8_t x, uint8_t y, uint8_t width, uint8_t height,
+        color_t color);
+
 /**
  * Draws a text.
  *
@@ -95,16 +176,97 @@ void SSD1306_setString(uint8_t x, uint8_t pageIndex, const char *string,
         int size, color_t color);
 
 /**
- * Copies a bitmap to the buffer.
+ * Draws a text at any vertical position. Characters are 6x8 pixels,
+ * their background is overwritten. Text exceeding the display is clipped.
  *
- * @param x0 is the horizontal coordinate of the origin (top-left corner).
- * @param y0 is the vertical coordinate of the origin (top-left corner).
- * @param bitmap is the bitmap data (1-bit per pixel, rows then cols).
+ * @param x is the horizontal offset (from 0 to LCD_WIDTH - 1).
+ * @param y is the top row of the text (from 0 to LCD_HEIGHT - 1).
+ * @param string is the text to display.
+ * @param size is the text length.
+ * @param color is the text color (BLACK draws inverted text).
+ */
+void SSD1306_setText(uint8_t x, uint8_t y, const char *string, int size,
+        color_t color);
+
+/**
+ * Draws a text using a proportional font. Glyph columns and the gaps
+ * between glyphs overwrite the background, text exceeding the display is
+ * clipped. Characters missing in the font are skipped.
+ *
+ * @param x is the horizontal offset (from 0 to LCD_WIDTH - 1).
+ * @param y is the top row of the text (from 0 to LCD_HEIGHT - 1).
+ * @param string is the text to display.
+ * @param size is the text length.
+ * @param font is the font.
+ * @param color is the text color (BLACK draws inverted text).
+ * @return the horizontal coordinate following the text.
+ */
+int SSD1306_setTextFont(uint8_t x, uint8_t y, const char *string, int size,
+        const font_t *font, color_t color);
+
+/**
+ * Returns the width of a text drawn with SSD1306_setTextFont() (pixels).
+ *
+ * @param string is the text.
+ * @param size is the text length.
+ * @param font is the font.
+ */
+int SSD1306_getTextWidth(const char *string, int size, const font_t *font);
+
+/**
+ * Copies a bitmap stored in the display layout: a byte holds 8 vertical
+ * pixels (LSB at the top), bytes make rows of 8 pixel high pages. Bitmaps
+ * aligned to pages are copied without any conversion.
+ *
+ * @param x is the horizontal coordinate of the origin (top-left corner).
+ * @param y is the vertical coordinate of the origin (top-left corner).
+ * @param bitmap is the bitmap data ((height + 7) / 8 pages, width bytes each).
  * @param width is the bitmap width (pixels).
  * @param height is the bitmap height (pixels).
  */
-void SSD1306_drawBitmap(uint8_t x0, uint8_t y0, const uint8_t *bitmap,
-        uint8_t width, uint8_t height);
+void SSD1306_blit(uint8_t x, uint8_t y, const uint8_t *bitmap, uint8_t width,
+        uint8_t height);
+
+/**
+ * Draws a bitmap, see SSD1306_blit() for the clipping rules.
+ *
+ * @param x is the horizontal coordinate of the origin (top-left corner).
+ * @param y is the vertical coordinate of the origin (top-left corner).
+ * @param bitmap is the bitmap to draw (plain or RLE compressed).
+ */
+void SSD1306_drawImage(uint8_t x, uint8_t y, const bitmap_t *bitmap);
+
+/**
+ * Copies a page to the buffer.
+ *
+ * @param pageIndex is the page number (from 0 to LCD_PAGES - 1).
+ * @param data is the page data (LCD_WIDTH bytes).
+ */
+void SSD1306_setPage(uint8_t pageIndex, const uint8_t *data);
+
+/**
+ * Copies a column (one byte per page) to the buffer.
+ *
+ * @param x is the column number (from 0 to LCD_WIDTH - 1).
+ * @param column is the column data (LCD_PAGES bytes, top page first).
+ */
+void SSD1306_setColumn(uint8_t x, const uint8_t *column);
+
+/**
+ * Starts a DMA transfer that draws a line of text (6x8 font) at the bottom
+ * of the screen, bypassing the buffer. Text that does not fit is clipped.
+ *
+ * When scroll is set, the screen contents move up by a page first. The
+ * display start line register is used for that, so only the new line
+ * is transferred. Functions drawing the whole buffer restore the start line,
+ * the pages drawn with this function are redrawn then.
+ *
+ * @param string is the text to draw.
+ * @param size is the number of characters.
+ * @param color is the text color (BLACK draws inverted text).
+ * @param scroll set to 1 adds a new line, 0 overwrites the bottom line.
+ */
+void SSD1306_scrollText(const char *string, int size, color_t color, int scroll);
 
 /**
  * Blocking call that draws a page using the provided data.
@@ -128,14 +290,43 @@ void SSD1306_drawBuffer(void);
 void SSD1306_drawPageDMA(uint8_t pageIndex, const uint8_t *pageBuffer);
 
 /**
- * Starts a DMA transfer to copy the buffer contents to the display.
+ * Presents the buffer contents: starts a DMA transfer to copy them
+ * to the display.
+ *
+ * The buffer is double-buffered, so drawing may continue right after
+ * the call, while the presented frame is being transferred. The new
+ * buffer starts with the presented contents. If the previous frame is
+ * still being transferred, the function waits until it is finished.
+ *
+ * Only the modified parts of the buffer are sent: every page that has been
+ * written to since the previous refresh is compared against the last
+ * transferred contents and the range of changed columns is sent. Returns
+ * immediately if nothing has changed.
+ *
+ * The transfer is completed in the interrupt context. SSD1306 controllers
+ * receive consecutive whole pages in a single transaction (horizontal
+ * addressing mode), SH1106 requires a transaction per page.
  */
 void SSD1306_drawBufferDMA(void);
 
 /**
- * Returns 1 if the buffer is transferred to the display. One should not
- * modify the buffer contents during the data transfer.
+ * Returns 1 if a frame is being transferred to the display. The buffer may
+ * be modified during the transfer, blocking drawing functions wait until
+ * it is finished.
  */
 int SSD1306_isBusy(void);
 
+/**
+ * Returns the next span of the panel contents that has changed since it was
+ * last returned, when display mirroring is enabled (CMD_LCD_MIRROR).
+ * Consecutive updates of a span are merged, so only the latest contents are
+ * returned.
+ *
+ * @param pageIndex is the page of the span.
+ * @param x is the first column of the span.
+ * @param data is the span contents (valid until the next refresh).
+ * @return the span size (columns), 0 if nothing has changed.
+ */
+int SSD1306_getMirrorSpan(uint8_t *pageIndex, uint8_t *x, const uint8_t **data);
+
 #endif /* LCD_H */
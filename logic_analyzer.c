@@ -31,8 +31,6 @@
 #include <string.h>
 #include <limits.h>
 
-#define LA_CHANNELS 8
-
 // Samples buffer
 #define LA_BUFFER_SIZE     (BUFFER_SIZE)
 static uint8_t * const la_buffer = buffer.u8;
@@ -59,14 +57,6 @@ static volatile enum la_state_t { IDLE, RUNNING, ACQUIRED } la_state = IDLE;
 #define LA_IOC_BUFFERS_CNT  4
 static ioc_buffer_t la_ioc_buffers[LA_IOC_BUFFERS_CNT];
 
-// Fixes the hardware channel order
-// (see the connection between the logic probes pin header and the input buffer)
-#define LA_FIX_ORDER(val) ((val & 0x0f) \
-            | (val & 0x80) >> 3 \
-            | (val & 0x40) >> 1 \
-            | (val & 0x20) << 1 \
-            | (val & 0x10) << 3)
-
 static void la_fix_channels(uint32_t offset, uint32_t size) {
     uint8_t* buf_ptr = &la_buffer[offset];
 
@@ -137,6 +127,7 @@ static void la_start_acq(void) {
     }
 
     la_state = RUNNING;
+    ioc_set_handler(la_acq_finished);   /* the mixed signal mode uses its own */
     ioc_start(la_ioc_buffers, LA_IOC_BUFFERS_CNT);
 }
 
@@ -167,7 +158,6 @@ static void la_display_acq(uint32_t offset) {
             }
         }
 
-        while(SSD1306_isBusy());
         SSD1306_drawPage(chan, CURRENT_PAGE);
     }
 }
@@ -356,7 +346,6 @@ static int la_acq_finished(int buf_idx) {
 static void la_display_state(void) {
     char samples_cnt[16];
 
-    while(SSD1306_isBusy());
     SSD1306_clearBufferFull();
     SSD1306_setString(5, 1, "Logic Analyzer (USB)", 20, WHITE);
 
@@ -20,6 +20,17 @@
 #ifndef LOGIC_ANALYZER_H
 #define LOGIC_ANALYZER_H
 
+/** Number of logic analyzer inputs */
+#define LA_CHANNELS 8
+
+// Fixes the hardware channel order
+// (see the connection between the logic probes pin header and the input buffer)
+#define LA_FIX_ORDER(val) ((val & 0x0f) \
+            | (val & 0x80) >> 3 \
+            | (val & 0x40) >> 1 \
+            | (val & 0x20) << 1 \
+            | (val & 0x10) << 3)
+
 /**
  * @brief Initialization routine, has to be called before the first acquisition.
  */
@@ -80,7 +80,6 @@ static menu_stack_entry_t menu_stack_pop(void) {
 }
 
 static void menu_draw(void) {
-    while(SSD1306_isBusy());
     SSD1306_clearBufferFull();
 
     for (int i = 0; i < MENU_ENTRY_COUNT; ++i) {
@@ -99,11 +98,12 @@ static void menu_draw(void) {
             break;
         }
 
-        SSD1306_setString(0, i, entryName, strlen(entryName),
-                entry_idx == selection ? BLACK : WHITE);
+        SSD1306_setTextFont(0, i * LCD_PAGE_SIZE, entryName, strlen(entryName),
+                &sans8, entry_idx == selection ? BLACK : WHITE);
 
         if (entry->type == SETTING && entry_idx == menu_current->val) {
-            SSD1306_setString(128 - 6, i, "<", 1,
+            SSD1306_setTextFont(LCD_WIDTH - SSD1306_getTextWidth("<", 1, &sans8),
+                i * LCD_PAGE_SIZE, "<", 1, &sans8,
                 entry_idx == selection ? BLACK : WHITE);
         }
     }
@@ -197,7 +197,7 @@ void menu(void) {
     if (buttons & BUT_DOWN) {
         if (++down == 20) {
             SSD1306_clearBufferFull();
-            SSD1306_drawBitmap(16, 0, gfx_test, 96, 64);
+            SSD1306_drawImage(16, 0, &gfx_test);
             SSD1306_drawBufferDMA();
             while (!btn_state());
             down = 0;
@@ -106,6 +106,11 @@ menu_list_t menu_scope_fsampling = {
         { SETTING,  { .setting = "200 kHz" } },
         { SETTING,  { .setting = "100 kHz" } },
         { SETTING,  { .setting = "50 kHz" } },
+        { SETTING,  { .setting = "20 kHz" } },
+        { SETTING,  { .setting = "10 kHz" } },
+        { SETTING,  { .setting = "5 kHz" } },
+        { SETTING,  { .setting = "2 kHz" } },
+        { SETTING,  { .setting = "1 kHz" } },
         { END,      { NULL } }
     }
 };
@@ -120,6 +125,103 @@ menu_list_t menu_scope_fsampling = {
     }
 };*/
 
+menu_list_t menu_scope_acq = {
+    "Acquisition", 0, {
+        { SETTING,  { .setting = "Normal" } },
+        { SETTING,  { .setting = "Peak detect" } },
+        { SETTING,  { .setting = "Average x4" } },
+        { SETTING,  { .setting = "Average x16" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_scope_filter = {
+    "Filter", 0, {
+        { SETTING,  { .setting = "Off" } },
+        { SETTING,  { .setting = "Low-pass fs/10" } },
+        { SETTING,  { .setting = "High-pass fs/100" } },
+        { SETTING,  { .setting = "Notch 50 Hz" } },
+        { SETTING,  { .setting = "Notch 60 Hz" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_scope_persist = {
+    "Persistence", 0, {
+        { SETTING,  { .setting = "Off" } },
+        { SETTING,  { .setting = "Short" } },
+        { SETTING,  { .setting = "Long" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_scope_meas = {
+    "Measurements", 0, {
+        { SETTING,  { .setting = "Off" } },
+        { SETTING,  { .setting = "On" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_scope_mode = {
+    "Mode", 0, {
+        { SETTING,  { .setting = "Waveform" } },
+        { SETTING,  { .setting = "Spectrum" } },
+        { SETTING,  { .setting = "Roll" } },
+        { SETTING,  { .setting = "Equivalent time" } },
+        { SETTING,  { .setting = "High resolution" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_scope_roll = {
+    "Roll speed", 1, {
+        { SETTING,  { .setting = "2.4 s/screen" } },
+        { SETTING,  { .setting = "6 s/screen" } },
+        { SETTING,  { .setting = "30 s/screen" } },
+        { SETTING,  { .setting = "78 s/screen" } },
+        { SETTING,  { .setting = "5 min/screen" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_scope_hires = {
+    "Resolution", 3, {
+        { SETTING,  { .setting = "13 bit" } },
+        { SETTING,  { .setting = "14 bit" } },
+        { SETTING,  { .setting = "15 bit" } },
+        { SETTING,  { .setting = "16 bit" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_scope_fft_size = {
+    "FFT size", 1, {
+        { SETTING,  { .setting = "256" } },
+        { SETTING,  { .setting = "512" } },
+        { SETTING,  { .setting = "1024" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_scope_fft_window = {
+    "FFT window", 1, {
+        { SETTING,  { .setting = "Rectangular" } },
+        { SETTING,  { .setting = "Hann" } },
+        { SETTING,  { .setting = "Blackman" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_scope_fft_avg = {
+    "FFT averaging", 0, {
+        { SETTING,  { .setting = "Off" } },
+        { SETTING,  { .setting = "x4" } },
+        { SETTING,  { .setting = "x16" } },
+        { END,      { NULL } }
+    }
+};
+
 application_t app_scope = { "RUN", app_scope_func };
 
 menu_list_t menu_scope = {
@@ -128,19 +230,136 @@ menu_list_t menu_scope = {
         { APP,       { .app     = &app_scope } },
         { SUBMENU,   { .submenu = &menu_scope_channels } },
         { SUBMENU,   { .submenu = &menu_scope_fsampling } },
+        { SUBMENU,   { .submenu = &menu_scope_acq } },
+        { SUBMENU,   { .submenu = &menu_scope_filter } },
+        { SUBMENU,   { .submenu = &menu_scope_persist } },
+        { SUBMENU,   { .submenu = &menu_scope_meas } },
+        { SUBMENU,   { .submenu = &menu_scope_mode } },
+        { SUBMENU,   { .submenu = &menu_scope_roll } },
+        { SUBMENU,   { .submenu = &menu_scope_hires } },
+        { SUBMENU,   { .submenu = &menu_scope_fft_size } },
+        { SUBMENU,   { .submenu = &menu_scope_fft_window } },
+        { SUBMENU,   { .submenu = &menu_scope_fft_avg } },
         /*{ SUBMENU,   { .submenu = &menu_scope_gain } },*/
         { END,      { NULL } }
     }
 };
 
 
+application_t app_mixed = { "RUN", app_mixed_func };
+
+menu_list_t menu_mixed_fsampling = {
+    "Sampling frequency", 3, {
+        { SETTING,  { .setting = "10 MHz" } },
+        { SETTING,  { .setting = "5 MHz" } },
+        { SETTING,  { .setting = "2 MHz" } },
+        { SETTING,  { .setting = "1 MHz" } },
+        { SETTING,  { .setting = "500 kHz" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_mixed_channels = {
+    "Analog channels", 0, {
+        { SETTING,  { .setting = "1" } },
+        { SETTING,  { .setting = "2" } },
+        { SETTING,  { .setting = "1 & 2" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_mixed_trigger = {
+    "Trigger input", 0, {
+        { SETTING,  { .setting = "Free run" } },
+        { SETTING,  { .setting = "Input 0" } },
+        { SETTING,  { .setting = "Input 1" } },
+        { SETTING,  { .setting = "Input 2" } },
+        { SETTING,  { .setting = "Input 3" } },
+        { SETTING,  { .setting = "Input 4" } },
+        { SETTING,  { .setting = "Input 5" } },
+        { SETTING,  { .setting = "Input 6" } },
+        { SETTING,  { .setting = "Input 7" } },
+        { SETTING,  { .setting = "Analog" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_mixed_trigger_level = {
+    "Trigger level", 1, {
+        { SETTING,  { .setting = "Low/falling" } },
+        { SETTING,  { .setting = "High/rising" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_mixed = {
+    "Mixed signal", 0,
+    {
+        { APP,       { .app     = &app_mixed } },
+        { SUBMENU,   { .submenu = &menu_mixed_fsampling } },
+        { SUBMENU,   { .submenu = &menu_mixed_channels } },
+        { SUBMENU,   { .submenu = &menu_mixed_trigger } },
+        { SUBMENU,   { .submenu = &menu_mixed_trigger_level } },
+        { END,      { NULL } }
+    }
+};
+
+
+application_t app_siggen = { "RUN", app_siggen_func };
+
+menu_list_t menu_siggen_wave = {
+    "Waveform", 0, {
+        { SETTING,  { .setting = "Sine" } },
+        { SETTING,  { .setting = "Square" } },
+        { SETTING,  { .setting = "Triangle" } },
+        { SETTING,  { .setting = "Arbitrary" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_siggen_freq = {
+    "Frequency", 2, {
+        { SETTING,  { .setting = "10 Hz" } },
+        { SETTING,  { .setting = "100 Hz" } },
+        { SETTING,  { .setting = "1 kHz" } },
+        { SETTING,  { .setting = "10 kHz" } },
+        { SETTING,  { .setting = "100 kHz" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_siggen_mode = {
+    "Mode", 0, {
+        { SETTING,  { .setting = "Continuous" } },
+        { SETTING,  { .setting = "Sweep" } },
+        { SETTING,  { .setting = "Burst" } },
+        { END,      { NULL } }
+    }
+};
+
+menu_list_t menu_siggen = {
+    "Signal generator", 0,
+    {
+        { APP,       { .app     = &app_siggen } },
+        { SUBMENU,   { .submenu = &menu_siggen_wave } },
+        { SUBMENU,   { .submenu = &menu_siggen_freq } },
+        { SUBMENU,   { .submenu = &menu_siggen_mode } },
+        { END,      { NULL } }
+    }
+};
+
+
 application_t app_command = { "Command interface", app_command_func };
 
 
 application_t app_uart = { "RUN", app_uart_func };
 
 menu_list_t menu_uart_baud = {
-    "Baud rate", 0, {
+    "Baud rate", 4, {
+        { SETTING,  { .setting = "1500000" } },
+        { SETTING,  { .setting = "921600" } },
+        { SETTING,  { .setting = "460800" } },
+        { SETTING,  { .setting = "230400" } },
         { SETTING,  { .setting = "115200" } },
         { SETTING,  { .setting = "57600" } },
         { SETTING,  { .setting = "38400" } },
@@ -149,11 +368,21 @@ menu_list_t menu_uart_baud = {
     }
 };
 
+menu_list_t menu_uart_view = {
+    "Display", 0, {
+        { SETTING,  { .setting = "ASCII" } },
+        { SETTING,  { .setting = "Hex" } },
+        { SETTING,  { .setting = "Off" } },
+        { END,      { NULL } }
+    }
+};
+
 menu_list_t menu_uart = {
     "USB-UART adapter", 0,
     {
         { APP,      { .app     = &app_uart } },
         { SUBMENU,  { .submenu = &menu_uart_baud } },
+        { SUBMENU,  { .submenu = &menu_uart_view } },
         { END,      { NULL } }
     }
 };
@@ -164,6 +393,8 @@ menu_list_t main_menu = {
        { APP,       { .app     = &app_la_usb } },
        { SUBMENU,   { .submenu = &menu_la_lcd } },
        { SUBMENU,   { .submenu = &menu_scope } },
+       { SUBMENU,   { .submenu = &menu_mixed } },
+       { SUBMENU,   { .submenu = &menu_siggen } },
        { APP,       { .app     = &app_command } },
        { SUBMENU,   { .submenu = &menu_uart } },
        { END,       { NULL } }
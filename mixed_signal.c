@@ -0,0 +1,587 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "mixed_signal.h"
+#include "adc_capture.h"
+#include "io_capture.h"
+#include "logic_analyzer.h"
+#include "lcd.h"
+#include "scope.h"
+#include "buttons.h"
+#include "io_conf.h"
+#include "buffer.h"
+#include "apps_list.h"
+#include "settings_list.h"
+#include "command_handlers.h"
+#include "udi_cdc.h"
+
+#include <interrupt.h>
+#include <string.h>
+#include <limits.h>
+
+/* The general buffer is divided in the following way:
+ * start                end                     description
+ * 0                    BUFFER_SIZE/2-1         ms_digital (logic inputs ring, uint8_t)
+ * BUFFER_SIZE/2        BUFFER_SIZE-1           ms_analog (ADC ring, uint16_t)
+ *
+ * Both rings are split into PDC banks acquired in the circular mode until
+ * the trigger is found and the post-trigger part is complete. Samples are
+ * counted from the start in both domains, and the logic inputs rate is an
+ * integer multiple (ratio) of the ADC rate, so digital sample n corresponds
+ * to analog sample n / ratio.
+ */
+#define MS_DIG_RING         (BUFFER_SIZE / 2)
+#define MS_DIG_BANKS        8
+#define MS_DIG_BANK         (MS_DIG_RING / MS_DIG_BANKS)
+#define MS_ANA_RING         (BUFFER_SIZE / 4)
+#define MS_ANA_BANKS        8
+#define MS_ANA_BANK         (MS_ANA_RING / MS_ANA_BANKS)
+#define MS_ANA_BANKS_MAX    64
+
+/* An analog trigger is found when its ADC bank is complete, meanwhile the
+ * logic inputs ring is being overwritten. The bank span (in logic inputs
+ * samples) is limited, so the pre-trigger part survives it and the three
+ * logic banks acquired before the acquisition stops. */
+#define MS_ANA_LATENCY_MAX  MS_DIG_BANK
+
+/* Maximum record lengths; the rest of the rings is overwritten by the banks
+ * acquired after the decision to stop (two banks for the logic inputs) */
+#define MS_DIG_RECORD_MAX   (MS_DIG_RING / 2)
+#define MS_ANA_RECORD_MAX   (MS_ANA_RING / 2)     /* all channels together */
+
+/** Analog trigger hysteresis [ADC counts] */
+#define MS_ANA_HYST         64
+
+static uint8_t * const ms_digital = buffer.u8;
+static uint16_t * const ms_analog = &buffer.u16[MS_DIG_RING / 2];
+
+static ioc_buffer_t ms_dig_banks[MS_DIG_BANKS];
+static adcc_buffer_t ms_ana_banks[MS_ANA_BANKS_MAX];
+
+/* Logic inputs sampling frequencies */
+static const struct {
+    clock_freq_t clock;
+    uint32_t freq;
+} ms_clocks[] = {
+    { F10MHZ,   10000000 },
+    { F8MHZ,    8000000 },
+    { F6MHZ,    6000000 },
+    { F5MHZ,    5000000 },
+    { F4MHZ,    4000000 },
+    { F3MHZ,    3000000 },
+    { F2MHZ,    2000000 },
+    { F1MHZ,    1000000 },
+    { F500KHZ,  500000 },
+    { F250KHZ,  250000 },
+    { F125KHZ,  125000 },
+};
+
+// Trigger settings
+static cmd_adc_trig_t ms_trig_source;
+static uint8_t ms_trig_mask;        /* hardware channel order */
+static uint8_t ms_trig_val;
+static int32_t ms_trig_level;       /* inverted for the falling edge */
+static int ms_trig_falling;
+static int ms_trig_armed;
+
+// Acquisition settings
+static uint32_t ms_chans;
+static uint32_t ms_ratio;
+static uint32_t ms_ana_per_bank;    /* samples per channel in an ADC bank */
+static uint32_t ms_dig_record;
+static uint32_t ms_ana_record;      /* samples per channel */
+
+// Number of acquired banks
+static volatile uint32_t ms_dig_done;
+static volatile uint32_t ms_ana_done;
+
+// Trigger positions (UINT_MAX when not detected)
+static volatile uint32_t ms_dig_trig;
+static volatile uint32_t ms_ana_trig;
+
+static volatile int ms_dig_stopping;
+
+
+/**
+ * \brief Configures both acquisitions.
+ *
+ * \param channels ADC channels.
+ * \param count Number of ADC channels.
+ * \param freq Logic inputs sampling frequency [Hz].
+ * \param record Requested number of samples per ADC channel.
+ * \return 1 on success, 0 if the configuration is not achievable.
+ */
+static int ms_configure(const enum adc_channel_num_t *channels, int count,
+        uint32_t freq, uint32_t record)
+{
+    unsigned int clk;
+
+    for (clk = 0; clk < sizeof(ms_clocks) / sizeof(ms_clocks[0]); clk++)
+    {
+        if (ms_clocks[clk].freq == freq)
+            break;
+    }
+
+    if (clk == sizeof(ms_clocks) / sizeof(ms_clocks[0]) || count < 1)
+        return 0;
+
+    /* the fastest ADC rate that is an integer fraction of the logic inputs rate */
+    ms_ratio = (freq * count + ADCC_MAX_RATE - 1) / ADCC_MAX_RATE;
+
+    if (freq % ms_ratio || !adcc_configure(channels, count, freq / ms_ratio)
+            || adcc_get_rate() != freq / ms_ratio)
+        return 0;
+
+    if (record * count > MS_ANA_RECORD_MAX)
+        record = MS_ANA_RECORD_MAX / count;
+
+    if (record * ms_ratio > MS_DIG_RECORD_MAX)
+        record = MS_DIG_RECORD_MAX / ms_ratio;
+
+    /* shorter ADC banks at high rate ratios, halved so they still fill the ring */
+    ms_ana_per_bank = MS_ANA_BANK / count;
+
+    while (ms_ana_per_bank * ms_ratio > MS_ANA_LATENCY_MAX
+            && ms_ana_per_bank * count > MS_ANA_RING / MS_ANA_BANKS_MAX)
+        ms_ana_per_bank /= 2;
+
+    if (ms_ana_per_bank * ms_ratio + 3 * MS_DIG_BANK + record * ms_ratio / 2 > MS_DIG_RING)
+        return 0;
+
+    ioc_set_clock(ms_clocks[clk].clock);
+    ms_chans = count;
+    ms_ana_record = record;
+    ms_dig_record = record * ms_ratio;
+
+    return 1;
+}
+
+
+/**
+ * \brief Sets the trigger.
+ *
+ * \param source Trigger source.
+ * \param mask Logic inputs taken into account (digital trigger).
+ * \param val Expected logic inputs state (digital trigger).
+ * \param level Crossed level [ADC counts] (analog trigger).
+ * \param rising Crossing direction (analog trigger).
+ */
+static void ms_set_trigger(cmd_adc_trig_t source, uint8_t mask, uint8_t val,
+        uint16_t level, int rising)
+{
+    ms_trig_source = source;
+    ms_trig_mask = LA_FIX_ORDER(mask);
+    ms_trig_val = LA_FIX_ORDER(val) & ms_trig_mask;
+    ms_trig_falling = !rising;
+    ms_trig_level = rising ? level : MAX_DIGITAL - level;
+}
+
+
+static void ms_trigger(uint32_t dig, uint32_t ana)
+{
+    ms_ana_trig = ana;
+    ms_dig_trig = dig;
+}
+
+
+/**
+ * \brief Logic inputs bank handler (called from the PIOA interrupt).
+ */
+static int ms_dig_finished(int buf_idx)
+{
+    const uint8_t *bank = ms_dig_banks[buf_idx].addr;
+    uint32_t start = ms_dig_done * MS_DIG_BANK;
+    uint32_t pre = ms_dig_record / 2;
+
+    ms_dig_done = ms_dig_done + 1;
+
+    if (ms_dig_trig == UINT_MAX && ms_trig_source == CMD_ADC_TRIG_DIGITAL)
+    {
+        /* trigger on entering the pattern, after the pre-trigger part */
+        for (uint32_t i = 0; i < MS_DIG_BANK; i++)
+        {
+            if ((bank[i] & ms_trig_mask) != ms_trig_val)
+            {
+                ms_trig_armed = 1;
+            }
+            else if (ms_trig_armed && start + i >= pre)
+            {
+                ms_trigger(start + i, (start + i) / ms_ratio);
+                break;
+            }
+        }
+    }
+
+    if (!ms_dig_stopping && ms_dig_trig != UINT_MAX
+            && start + MS_DIG_BANK >= ms_dig_trig + ms_dig_record - pre)
+    {
+        /* stop after the bank being acquired and the queued one */
+        ms_dig_banks[(buf_idx + 2) % MS_DIG_BANKS].last = 1;
+        ms_dig_stopping = 1;
+    }
+
+    return ms_dig_banks[buf_idx].last;
+}
+
+
+/**
+ * \brief ADC bank handler (called from the ADC interrupt).
+ */
+static int ms_ana_finished(int buf_idx)
+{
+    const uint16_t *bank = ms_ana_banks[buf_idx].addr;
+    uint32_t per_bank = ms_ana_per_bank;
+    uint32_t start = ms_ana_done * per_bank;
+    uint32_t pre = ms_ana_record / 2;
+
+    ms_ana_done = ms_ana_done + 1;
+
+    if (ms_ana_trig == UINT_MAX && ms_trig_source == CMD_ADC_TRIG_ANALOG)
+    {
+        /* the first channel triggers, the edge has to leave the hysteresis band */
+        for (uint32_t i = 0; i < per_bank; i++)
+        {
+            int32_t sample = ADCC_DATA(bank[i * ms_chans]);
+
+            if (ms_trig_falling)
+                sample = MAX_DIGITAL - sample;
+
+            if (sample < ms_trig_level - MS_ANA_HYST)
+            {
+                ms_trig_armed = 1;
+            }
+            else if (ms_trig_armed && sample >= ms_trig_level && start + i >= pre)
+            {
+                ms_trigger((start + i) * ms_ratio, start + i);
+                break;
+            }
+        }
+    }
+
+    return ms_ana_trig != UINT_MAX
+        && start + per_bank >= ms_ana_trig + ms_ana_record - pre;
+}
+
+
+static void ms_start(void)
+{
+    uint32_t ana_bank = ms_ana_per_bank * ms_chans;
+    int ana_banks = MS_ANA_RING / ana_bank;
+    irqflags_t flags;
+
+    for (int i = 0; i < MS_DIG_BANKS; i++)
+    {
+        ms_dig_banks[i].addr = ms_digital + i * MS_DIG_BANK;
+        ms_dig_banks[i].size = MS_DIG_BANK;
+        ms_dig_banks[i].last = 0;
+    }
+
+    for (int i = 0; i < ana_banks; i++)
+    {
+        ms_ana_banks[i].addr = ms_analog + i * ana_bank;
+        ms_ana_banks[i].size = ana_bank;
+        ms_ana_banks[i].last = 0;
+    }
+
+    ms_dig_done = 0;
+    ms_ana_done = 0;
+    ms_dig_stopping = 0;
+    ms_trig_armed = 0;
+
+    if (ms_trig_source == CMD_ADC_TRIG_NONE)
+        ms_trigger(ms_dig_record / 2, ms_ana_record / 2);
+    else
+        ms_trigger(UINT_MAX, UINT_MAX);
+
+    ioc_set_handler(ms_dig_finished);
+    adcc_set_handler(ms_ana_finished);
+
+    /* start the sampling clocks back to back, so the time bases match */
+    flags = cpu_irq_save();
+    adcc_start(ms_ana_banks, ana_banks);
+    ioc_start(ms_dig_banks, MS_DIG_BANKS);
+    cpu_irq_restore(flags);
+}
+
+
+static int ms_busy(void)
+{
+    return adcc_busy() || ioc_busy();
+}
+
+
+static void ms_abort(void)
+{
+    adcc_stop();
+
+    /* the logic inputs acquisition stops on a bank marked as the last one */
+    for (int i = 0; i < MS_DIG_BANKS; i++)
+        ms_dig_banks[i].last = 1;
+
+    ms_dig_stopping = 1;
+    while (ioc_busy());
+}
+
+
+/* Index of the first ADC sample in the record */
+static uint32_t ms_ana_first(void)
+{
+    return ms_ana_trig - ms_ana_record / 2;
+}
+
+
+static uint8_t ms_dig_sample(uint32_t n)
+{
+    uint8_t val = ms_digital[n % MS_DIG_RING];
+    return LA_FIX_ORDER(val);
+}
+
+
+static uint16_t ms_ana_sample(uint32_t n, uint32_t chan)
+{
+    return ADCC_DATA(ms_analog[(n * ms_chans + chan) % MS_ANA_RING]);
+}
+
+
+/* LCD view: analog channels in the upper half, logic inputs in the lower
+ * half (two inputs per page, four rows each). Each column shows one ADC
+ * sample and the corresponding 'ratio' logic input samples. */
+#define MS_ANALOG_HEIGHT    (LCD_HEIGHT / 2)
+
+static void ms_draw(void)
+{
+    static uint8_t pages[LCD_PAGES / 2][LCD_WIDTH];
+    uint32_t first = ms_ana_first();
+    uint32_t prev_y[NUM_CHANNELS] = { 0, 0 };
+
+    SSD1306_clearBufferFull();
+
+    for (int x = 0; x < LCD_WIDTH; x++)
+    {
+        uint8_t all = 0xff, any = 0;
+
+        for (uint32_t chan = 0; chan < ms_chans; chan++)
+        {
+            uint32_t y = MS_ANALOG_HEIGHT - 1
+                - ms_ana_sample(first + x, chan) * (MS_ANALOG_HEIGHT - 1) / MAX_DIGITAL;
+
+            if (x > 0)
+                SSD1306_setLine(x - 1, prev_y[chan], x, y, WHITE);
+
+            prev_y[chan] = y;
+        }
+
+        for (uint32_t i = 0; i < ms_ratio; i++)
+        {
+            uint8_t val = ms_dig_sample((first + x) * ms_ratio + i);
+            all &= val;
+            any |= val;
+        }
+
+        for (int chan = 0; chan < LA_CHANNELS; chan += 2)
+        {
+            uint8_t col = 0;
+
+            for (int j = 0; j < 2; j++)
+            {
+                uint8_t mask = 1 << (chan + j);
+                /* high, low or both levels when the input toggles */
+                uint8_t bits = (all & mask) ? 0x01 : (any & mask) ? 0x07 : 0x04;
+
+                col |= bits << (4 * j);
+            }
+
+            pages[chan / 2][x] = col;
+        }
+    }
+
+    for (int page = 0; page < LCD_PAGES / 2; page++)
+        SSD1306_setPage(LCD_PAGES / 2 + page, pages[page]);
+
+    /* trigger position */
+    for (int y = 0; y < MS_ANALOG_HEIGHT; y += 4)
+        SSD1306_setPixel(LCD_WIDTH / 2, y, WHITE);
+
+    SSD1306_drawBufferDMA();
+}
+
+
+void app_mixed_func(void)
+{
+    static const uint32_t freqs[] = { 10000000, 5000000, 2000000, 1000000, 500000 };
+    enum adc_channel_num_t chans[NUM_CHANNELS];
+    int chan_count = 0;
+    int trigger = menu_mixed_trigger.val;
+    int level = menu_mixed_trigger_level.val;
+
+    io_configure(IO_ADC);
+
+    switch (menu_mixed_channels.val) {
+        case 0: /* channel 1 */
+            chan_count = 1;
+            chans[0] = ADC_CHANNEL_3;
+            break;
+        case 1: /* channel 2 */
+            chan_count = 1;
+            chans[0] = ADC_CHANNEL_9;
+            break;
+        case 2: /* channel 1&2 */
+            chan_count = 2;
+            chans[0] = ADC_CHANNEL_3;
+            chans[1] = ADC_CHANNEL_9;
+            break;
+    }
+
+    if (trigger == 0) {
+        ms_set_trigger(CMD_ADC_TRIG_NONE, 0, 0, 0, 1);
+    } else if (trigger <= LA_CHANNELS) {
+        /* the selected input in the selected state */
+        uint8_t mask = 1 << (trigger - 1);
+        ms_set_trigger(CMD_ADC_TRIG_DIGITAL, mask, level ? mask : 0, 0, 1);
+    } else {
+        /* the first channel crossing the middle of the range */
+        ms_set_trigger(CMD_ADC_TRIG_ANALOG, 0, 0, (MAX_DIGITAL + 1) / 2, level);
+    }
+
+    if (!ms_configure(chans, chan_count, freqs[menu_mixed_fsampling.val], LCD_WIDTH))
+        return;
+
+    if (trigger != 0) {
+        SSD1306_clearBufferFull();
+        SSD1306_setString(6, 0, "Waiting for trigger", 19, WHITE);
+        SSD1306_drawBufferDMA();
+    }
+
+    ms_start();
+
+    while (btn_state() != BUT_LEFT) {
+        if (ms_busy())
+            continue;
+
+        ms_draw();
+        ms_start();
+    }
+
+    ms_abort();
+    while(btn_state());    /* wait for the button release */
+}
+
+
+/* Sends a part of a ring buffer, handling the wrap around */
+static void ms_send_ring(uint8_t *ring, uint32_t ring_size, uint32_t offset,
+        uint32_t size)
+{
+    offset %= ring_size;
+
+    if (offset + size <= ring_size) {
+        udi_cdc_write_buf(&ring[offset], size);
+    } else {
+        udi_cdc_write_buf(&ring[offset], ring_size - offset);
+        udi_cdc_write_buf(ring, size - (ring_size - offset));
+    }
+}
+
+
+/* Record format (little endian):
+ * digital samples count (2 bytes), ADC samples count per channel (2 bytes),
+ * ADC channels count (1 byte), logic inputs to ADC rate ratio (1 byte),
+ * trigger position in digital samples (2 bytes),
+ * digital samples (1 byte each, bit n = logic input n),
+ * ADC samples (2 bytes each, channels interleaved). */
+static void ms_send(void)
+{
+    uint32_t ana_first = ms_ana_first();
+    uint32_t dig_first = ana_first * ms_ratio;
+    uint32_t trig = ms_dig_trig - dig_first;
+    uint8_t header[8] = {
+        ms_dig_record & 0xff, ms_dig_record >> 8,
+        ms_ana_record & 0xff, ms_ana_record >> 8,
+        ms_chans, ms_ratio,
+        trig & 0xff, trig >> 8
+    };
+
+    /* fix the channel order and strip the tags in place */
+    for (uint32_t n = dig_first; n < dig_first + ms_dig_record; n++)
+        ms_digital[n % MS_DIG_RING] = ms_dig_sample(n);
+
+    for (uint32_t n = ana_first * ms_chans; n < (ana_first + ms_ana_record) * ms_chans; n++)
+        ms_analog[n % MS_ANA_RING] = ADCC_DATA(ms_analog[n % MS_ANA_RING]);
+
+    udi_cdc_write_buf(header, sizeof(header));
+    ms_send_ring(ms_digital, MS_DIG_RING, dig_first, ms_dig_record);
+    ms_send_ring((uint8_t*) ms_analog, MS_ANA_RING * 2, ana_first * ms_chans * 2,
+            ms_ana_record * ms_chans * 2);
+}
+
+
+/* An empty record header precedes the error response */
+static void ms_send_empty(void)
+{
+    const uint8_t header[8] = { 0 };
+
+    udi_cdc_write_buf(header, sizeof(header));
+    cmd_resp_init(CMD_RESP_EXEC_ERR);
+}
+
+
+void cmd_adc_mixed(const uint8_t *data_in)
+{
+    enum adc_channel_num_t chans[NUM_CHANNELS];
+    int chan_count = 0;
+    uint32_t freq = (data_in[2] << 24) | (data_in[3] << 16) | (data_in[4] << 8) | data_in[5];
+
+    if (data_in[1] & 0x01)
+        chans[chan_count++] = ADC_CHANNEL_3;
+
+    if (data_in[1] & 0x02)
+        chans[chan_count++] = ADC_CHANNEL_9;
+
+    io_configure(IO_ADC);
+
+    if (data_in[6] > CMD_ADC_TRIG_ANALOG
+            || !ms_configure(chans, chan_count, freq, MS_ANA_RECORD_MAX)) {
+        ms_send_empty();
+        return;
+    }
+
+    ms_set_trigger(data_in[6], data_in[7], data_in[8],
+            (data_in[9] << 8) | data_in[10], data_in[11]);
+    ms_start();
+
+    /* any byte received from the host cancels waiting for the trigger */
+    while (ms_busy()) {
+        if (udi_cdc_is_rx_ready() || btn_state() == BUT_LEFT) {
+            ms_abort();
+
+            if (udi_cdc_is_rx_ready()) {
+                udi_cdc_getc();
+            }
+
+            ms_send_empty();
+            return;
+        }
+    }
+
+    ms_send();
+
+    cmd_resp_init(CMD_RESP_OK);
+    cmd_resp_write_u32(freq);
+    cmd_resp_write_u32(adcc_get_rate());
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "oversample.h"
+#include "adc_capture.h"
+
+#include <compiler.h>
+
+/* A halfword holds the sum of up to 16 12-bit samples */
+#define OVS_LANE_SAMPLES        16
+
+uint32_t ovs_reduce(const uint16_t *samples, uint32_t count, uint32_t channels,
+        uint32_t bits, uint16_t *out)
+{
+    /* samples are word aligned (see oversample.h) */
+    const uint32_t *words = (const void*) samples;
+    uint32_t group = 1 << (2 * bits);
+    uint32_t outputs = count / (group * channels);
+
+    for (uint32_t o = 0; o < outputs; ++o) {
+        /* both halfwords are summed separately, they hold either the two
+         * channels or two consecutive samples of a single channel */
+        uint32_t acc_lo = 0, acc_hi = 0;
+        uint32_t left = group * channels / 2;
+
+        while (left) {
+            uint32_t n = left < OVS_LANE_SAMPLES ? left : OVS_LANE_SAMPLES;
+            uint32_t lanes = 0;
+
+            left -= n;
+
+            while (n--)
+                lanes = __UADD16(lanes, ADCC_DATA2(*words++));
+
+            acc_lo += lanes & 0xffff;
+            acc_hi += lanes >> 16;
+        }
+
+        if (channels == 2) {
+            *out++ = acc_lo >> bits;
+            *out++ = acc_hi >> bits;
+        } else {
+            *out++ = (acc_lo + acc_hi) >> bits;
+        }
+    }
+
+    return outputs * channels;
+}
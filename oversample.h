@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+/**
+ * ADC oversampling and decimation: every 4^n conversions are summed and
+ * scaled down by 2^n, which adds n bits of resolution when the signal
+ * carries at least 1 LSB of noise.
+ */
+
+#ifndef OVERSAMPLE_H
+#define OVERSAMPLE_H
+
+#include <stdint.h>
+
+/** Extra resolution bits range (13 - 16 bit results) */
+#define OVS_MIN_BITS            1
+#define OVS_MAX_BITS            4
+
+/** Bank size holding a whole number of output samples for any number
+ * of extra bits and channels (samples) */
+#define OVS_BANK_SAMPLES        ((1 << (2 * OVS_MAX_BITS)) * 2)
+
+/**
+ * Reduces a bank of interleaved ADC samples.
+ *
+ * @param samples are the acquired samples (word aligned, may carry channel tags).
+ * @param count is the number of samples, a multiple of 4^bits * channels.
+ * @param channels is the number of interleaved channels (1 or 2).
+ * @param bits is the number of extra resolution bits (OVS_MIN_BITS - OVS_MAX_BITS).
+ * @param out receives the interleaved (12 + bits)-bit results, count / 4^bits values.
+ * @return Number of values written to out.
+ */
+uint32_t ovs_reduce(const uint16_t *samples, uint32_t count, uint32_t channels,
+        uint32_t bits, uint16_t *out);
+
+#endif /* OVERSAMPLE_H */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "persistence.h"
+#include "lcd.h"
+
+#include <compiler.h>
+#include <string.h>
+
+/* Counters are stored in the display buffer order (page-major), with
+ * 8 consecutive bytes for the 8 pixels of a display byte:
+ *   counters[(page * LCD_WIDTH + x) * LCD_PAGE_SIZE + (y % LCD_PAGE_SIZE)]
+ * so rendering a display byte reads two adjacent words. */
+static uint8_t *persist_counters;
+static unsigned int persist_shift;
+static uint8_t persist_hit;
+static uint32_t persist_decay_mask;
+static unsigned int persist_frame;
+
+/* Thresholds for temporal dithering (4 frames, 5 intensity levels), each
+ * pixel in a column starts at a different phase to reduce flicker */
+static const uint8_t persist_thresholds[4] = { 32, 160, 96, 224 };
+static uint32_t persist_thr_words[4];
+
+
+void persist_init(uint8_t *counters, unsigned int decay_shift)
+{
+    persist_counters = counters;
+    persist_shift = decay_shift;
+    /* a pixel hit in every frame settles close to saturation */
+    persist_hit = 0xff / ((1 << decay_shift) - 1);
+    persist_decay_mask = (0xff >> decay_shift) * 0x01010101;
+    persist_frame = 0;
+
+    for (int i = 0; i < 4; i++) {
+        persist_thr_words[i] = persist_thresholds[i]
+                | (persist_thresholds[(i + 1) & 3] << 8)
+                | (persist_thresholds[(i + 2) & 3] << 16)
+                | (persist_thresholds[(i + 3) & 3] << 24);
+    }
+
+    memset(counters, 0, PERSIST_BUFFER_SIZE);
+}
+
+
+static inline uint8_t *persist_counter(uint8_t x, uint8_t y)
+{
+    return &persist_counters[((y / LCD_PAGE_SIZE) * LCD_WIDTH + x) * LCD_PAGE_SIZE
+            + (y % LCD_PAGE_SIZE)];
+}
+
+
+void persist_pixel(uint8_t x, uint8_t y)
+{
+    uint8_t *cnt;
+
+    if (x >= LCD_WIDTH || y >= LCD_HEIGHT)
+        return;
+
+    cnt = persist_counter(x, y);
+    *cnt = (*cnt > 0xff - persist_hit) ? 0xff : *cnt + persist_hit;
+}
+
+
+void persist_vline(uint8_t x, uint8_t y0, uint8_t y1)
+{
+    if (x >= LCD_WIDTH || y0 > y1)
+        return;
+
+    if (y1 >= LCD_HEIGHT)
+        y1 = LCD_HEIGHT - 1;
+
+    for (unsigned int y = y0; y <= y1; y++)
+        persist_pixel(x, y);
+}
+
+
+void persist_render(void)
+{
+    /* the counters buffer is word aligned (persist_init()) */
+    uint32_t *cnt = (void*) persist_counters;
+    uint8_t page[LCD_WIDTH];
+
+    for (int p = 0; p < LCD_PAGES; p++) {
+        for (int x = 0; x < LCD_WIDTH; x++) {
+            uint32_t thr = persist_thr_words[(x + persist_frame) & 3];
+            uint32_t lo = cnt[0], hi = cnt[1];
+            uint32_t mask_lo, mask_hi;
+
+            /* GE flags mark the counters above the threshold */
+            __USUB8(lo, thr);
+            mask_lo = __SEL(0x01010101, 0);
+            __USUB8(hi, thr);
+            mask_hi = __SEL(0x01010101, 0);
+
+            /* decay: c -= c >> shift (4 counters at once) */
+            cnt[0] = __UQSUB8(lo, (lo >> persist_shift) & persist_decay_mask);
+            cnt[1] = __UQSUB8(hi, (hi >> persist_shift) & persist_decay_mask);
+            cnt += 2;
+
+            /* gather the bytes' LSBs into a nibble */
+            page[x] = (((mask_lo * 0x01020408) >> 24) & 0x0f)
+                    | ((((mask_hi * 0x01020408) >> 24) & 0x0f) << 4);
+        }
+
+        SSD1306_setPage(p, page);
+    }
+
+    ++persist_frame;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * Display persistence: pixels keep per-frame hit counters that decay over
+ * time. Intensity is rendered on the 1-bit display by temporal dithering.
+ */
+
+#ifndef PERSISTENCE_H
+#define PERSISTENCE_H
+
+#include <stdint.h>
+#include "lcd.h"
+
+/** Size of the hit counters buffer (bytes) */
+#define PERSIST_BUFFER_SIZE     (LCD_WIDTH * LCD_HEIGHT)
+
+/**
+ * Initializes (clears) the hit counters.
+ *
+ * @param counters is a word aligned buffer of PERSIST_BUFFER_SIZE bytes.
+ * @param decay_shift sets the decay rate: every rendered frame removes
+ * 1/2^decay_shift of the counter value (1-7).
+ */
+void persist_init(uint8_t *counters, unsigned int decay_shift);
+
+/**
+ * Registers a hit at a pixel.
+ */
+void persist_pixel(uint8_t x, uint8_t y);
+
+/**
+ * Registers hits at a vertical line (y0 <= y1).
+ */
+void persist_vline(uint8_t x, uint8_t y0, uint8_t y1);
+
+/**
+ * Decays the counters and renders them to the display buffer.
+ * Pixels are lit in a fraction of frames proportional to their intensity,
+ * so it should be called at the highest possible frame rate.
+ */
+void persist_render(void);
+
+#endif /* PERSISTENCE_H */
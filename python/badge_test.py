@@ -18,6 +18,7 @@
 # Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
 
 from kicon_badge import KiconBadge
+import numpy as np
 import time
 
 badge = KiconBadge('/dev/ttyACM0')
@@ -30,9 +31,8 @@ uart_data = badge.uart_transfer(bytes('badge test', 'ascii'))
 badge.lcd_clear()
 
 # draw a checker pattern
-for y in range(12):
-    for x in range(badge.LCD_WIDTH):
-        badge.lcd_pixel(x, y, (x ^ y) & 0x02)
+y, x = np.mgrid[0:12, 0:badge.LCD_WIDTH]
+badge.lcd_blit((x ^ y) & 0x02, refresh=False)
 
 badge.lcd_text(1, 2, "hey, it is scripted")
 badge.lcd_text(4, 3, "with Python!")
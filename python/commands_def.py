@@ -19,6 +19,7 @@ CMD_RESP_INVALID_CMD = 3
 CMD_RESP_OVERFLOW = 4
 CMD_RESP_CRC_ERR = 5
 CMD_RESP_EXEC_ERR = 6
+CMD_RESP_LCD_SPAN = 7
 
 
 CMD_LED_SET = 0
@@ -38,4 +39,47 @@ CMD_LCD_CLEAR = 0
 CMD_LCD_REFRESH = 1
 CMD_LCD_PIXEL = 2
 CMD_LCD_TEXT = 3
+CMD_LCD_BLIT = 4
+CMD_LCD_READ = 5
+CMD_LCD_MIRROR = 6
+CMD_LCD_STATS = 7
+
+
+CMD_LCD_MIRROR_OFF = 0
+CMD_LCD_MIRROR_SPANS = 1
+CMD_LCD_MIRROR_FRAMES = 2
+
+
+CMD_LCD_STATS_RESET = 1
+CMD_LCD_STATS_OVERLAY = 2
+
+
+CMD_LCD_BLIT_RAW = 0
+CMD_LCD_BLIT_RLE = 1
+CMD_LCD_BLIT_DELTA = 2
+CMD_LCD_BLIT_REFRESH = 4
+
+
+CMD_ADC_STREAM = 0
+CMD_ADC_MEASURE = 1
+CMD_ADC_MIXED = 2
+CMD_ADC_READ = 3
+CMD_ADC_OVERSAMPLE = 4
+
+
+CMD_ADC_TRIG_NONE = 0
+CMD_ADC_TRIG_DIGITAL = 1
+CMD_ADC_TRIG_ANALOG = 2
+
+
+CMD_DAC_START = 0
+CMD_DAC_SWEEP = 1
+CMD_DAC_STOP = 2
+CMD_DAC_LOAD = 3
+
+
+CMD_DAC_SINE = 0
+CMD_DAC_SQUARE = 1
+CMD_DAC_TRIANGLE = 2
+CMD_DAC_ARBITRARY = 3
 
@@ -22,6 +22,7 @@ import serial
 import struct
 import time
 import binascii
+import numpy as np
 import commands_def as cmd_defs
 
 class KiconBadge:
@@ -38,10 +39,29 @@ class KiconBadge:
 
     LCD_WIDTH = 128
     LCD_HEIGHT = 64
+    LCD_PAGES = 8
+    LCD_BLIT_MAX = 249  # data bytes in a single CMD_LCD_BLIT command
+
+    ADC_CH1 = 0x01
+    ADC_CH2 = 0x02
+    ADC_MAX_RATE = 1000000
+    ADC_READ_MAX = 32766
+    ADC_OVERSAMPLE_MAX = 31742
+
+    # DAC output range [V]
+    DAC_MIN_V = 3.3 / 6
+    DAC_MAX_V = 3.3 * 5 / 6
+    DAC_MAX_SAMPLES = 1024
 
     def __init__(self, port):
         self._serial = None
         self._serial = serial.Serial(port, 115200, timeout=0.5)   # TODO baud?
+        # display buffer contents (pages of column bytes), None if unknown
+        self._lcd_frame = None
+        # mirrored panel contents (see lcd_mirror()), None if disabled
+        self._lcd_mirror = None
+        self._lcd_mirror_mode = cmd_defs.CMD_LCD_MIRROR_OFF
+        self._lcd_mirror_changed = False
 
     def __del__(self):
         if self._serial:
@@ -73,18 +93,123 @@ class KiconBadge:
         else:
             return struct.pack('>BBB', 1, cmd, self._crc(cmd))
 
+    # Reads exactly 'length' bytes, raises an exception on timeout.
+    def _read_exact(self, length):
+        data = self._serial.read(length)
+
+        if len(data) != length:
+            raise Exception('Timeout (expected %d bytes, got %d)' % (length, len(data)))
+
+        return data
+
+    # Unpacks 12-bit samples (2 samples stored in 3 bytes).
+    def _unpack12(self, data, channels):
+        raw = np.frombuffer(data, dtype=np.uint8).reshape(-1, 3).astype(np.uint16)
+        samples = np.empty(raw.shape[0] * 2, dtype=np.uint16)
+        samples[0::2] = raw[:, 0] | ((raw[:, 1] & 0x0f) << 8)
+        samples[1::2] = (raw[:, 1] >> 4) | (raw[:, 2] << 4)
+        return samples.reshape(-1, channels)
+
+    # Converts an image to the display layout: rows of 8 pixel high pages,
+    # a byte holds a column of a page (LSB at the top).
+    def _lcd_pages(self, image):
+        if hasattr(image, 'convert'):   # PIL image
+            image = image.convert('1')
+
+        pixels = np.asarray(image) != 0
+
+        if pixels.ndim != 2:
+            raise Exception('Monochrome image expected')
+
+        height, width = pixels.shape
+        pages = (height + 7) // 8
+        rows = np.zeros((pages * 8, width), dtype=np.uint8)
+        rows[:height] = pixels
+        weights = (1 << np.arange(8)).reshape(1, 8, 1)
+
+        return (rows.reshape(pages, 8, width) * weights).sum(axis=1).astype(np.uint8)
+
+    # Converts data in the display layout to an image (rows x columns, 1 for lit pixels).
+    def _lcd_image(self, pages):
+        bits = (pages[:, np.newaxis, :] >> np.arange(8).reshape(1, 8, 1)) & 1
+        return bits.reshape(-1, pages.shape[1]).astype(np.uint8)
+
+    # Compresses data using the same RLE scheme as scripts/gfx_convert.py:
+    # 0x00-0x7f header: (header + 1) literal bytes follow,
+    # 0x80-0xff header: the next byte is repeated (header - 0x80 + 2) times.
+    def _rle_encode(self, data):
+        out = bytearray()
+        literal = bytearray()
+        i = 0
+
+        def flush():
+            while literal:
+                chunk = literal[:0x80]
+                out.append(len(chunk) - 1)
+                out.extend(chunk)
+                del literal[:len(chunk)]
+
+        while i < len(data):
+            run = 1
+
+            while i + run < len(data) and data[i + run] == data[i] and run < 0x81:
+                run += 1
+
+            if run >= 3 or (run == 2 and not literal):
+                flush()
+                out.append(0x80 + run - 2)
+                out.append(data[i])
+            else:
+                literal.extend(data[i:i + run])
+
+            i += run
+
+        flush()
+        return bytes(out)
+
+    # Encodes display data, returns the shortest variant as (flags, data).
+    def _lcd_encode(self, data, delta):
+        variants = [(cmd_defs.CMD_LCD_BLIT_RAW, data.tobytes()),
+                    (cmd_defs.CMD_LCD_BLIT_RLE, self._rle_encode(data.tobytes()))]
+
+        if delta is not None:
+            variants.append((cmd_defs.CMD_LCD_BLIT_RLE | cmd_defs.CMD_LCD_BLIT_DELTA,
+                    self._rle_encode(delta.tobytes())))
+
+        return min(variants, key=lambda v: len(v[1]))
+
+    # Reads a block of samples. Returns (sequence number, raw data) or None for the terminating block.
+    def _adc_read_block(self):
+        count, seq = struct.unpack('<HH', self._read_exact(4))
+
+        if count == 0:
+            return None
+
+        return seq, self._read_exact(count * 3 // 2)
+
     # Receives and validates response from the badge. Returns raw data (if any).
     def _get_resp(self):
-        resp_len = self._serial.read(1)[0]
-        resp_data = self._serial.read(resp_len + 1) # +1 for CRC
-        resp_type = resp_data[0]
-        resp_crc = resp_data[-1]
-        calc_crc = self._crc(resp_data[:-1])
-        raw_data = resp_data[1:-1]      # strip command response type and CRC
-
-        if resp_crc != calc_crc:
-            raise Exception('CRC error (expected 0x%x, got 0x%x)'
-                    % (calc_crc, resp_crc))
+        while True:
+            resp_len = self._serial.read(1)[0]
+            resp_data = self._serial.read(resp_len + 1) # +1 for CRC
+            resp_type = resp_data[0]
+            resp_crc = resp_data[-1]
+            calc_crc = self._crc(resp_data[:-1])
+            raw_data = resp_data[1:-1]      # strip command response type and CRC
+
+            if resp_crc != calc_crc:
+                raise Exception('CRC error (expected 0x%x, got 0x%x)'
+                        % (calc_crc, resp_crc))
+
+            # display mirroring updates precede responses
+            if resp_type != cmd_defs.CMD_RESP_LCD_SPAN:
+                break
+
+            if self._lcd_mirror is not None:
+                page, x = raw_data[0], raw_data[1]
+                self._lcd_mirror[page, x:x + len(raw_data) - 2] = np.frombuffer(
+                        raw_data[2:], dtype=np.uint8)
+                self._lcd_mirror_changed = True
 
         if resp_type != cmd_defs.CMD_RESP_OK:
             raise Exception('Response != OK: response = 0x%.2x, data = "%s"'
@@ -99,6 +224,7 @@ class KiconBadge:
         # special command type, cannot be created with make_cmd
         reset_cmd = struct.pack('>B', cmd_defs.CMD_TYPE_RESET)
         reset_resp = self._make_resp(cmd_defs.CMD_RESP_RESET)
+        self._lcd_frame = None
 
         self._serial.write(reset_cmd)
         time.sleep(0.1)
@@ -124,10 +250,12 @@ class KiconBadge:
 
     ## Clears the display buffer.
     def lcd_clear(self):
+        self._lcd_frame = None
         cmd = self._make_cmd(cmd_defs.CMD_TYPE_LCD,
                 struct.pack('>B', cmd_defs.CMD_LCD_CLEAR))
         self._serial.write(cmd)
         self._get_resp()
+        self._lcd_frame = np.zeros((self.LCD_PAGES, self.LCD_WIDTH), dtype=np.uint8)
 
     ## Redraws the display buffer.
     def lcd_refresh(self):
@@ -142,23 +270,179 @@ class KiconBadge:
     # @param y is the vertical coordinate (0-63).
     # @param color is the pixel color (BLACK [0] or WHITE [1]).
     def lcd_pixel(self, x, y, color):
+        frame, self._lcd_frame = self._lcd_frame, None
         cmd = self._make_cmd(cmd_defs.CMD_TYPE_LCD,
                 struct.pack('>BBBB', cmd_defs.CMD_LCD_PIXEL, x, y, color))
         self._serial.write(cmd)
         self._get_resp()
 
+        if frame is not None:
+            if color:
+                frame[y // 8, x] |= 1 << (y % 8)
+            else:
+                frame[y // 8, x] &= ~(1 << (y % 8))
+
+            self._lcd_frame = frame
+
     ## Draws a text in the display buffer.
     #
     # @param row is the row number (0-7).
     # @param col is the column number (0-63).
     # @param text is the string to be drawn.
     def lcd_text(self, row, col, text):
+        self._lcd_frame = None
         cmd = self._make_cmd(cmd_defs.CMD_TYPE_LCD,
                 struct.pack('>BBBB%ds' % len(text),
                 cmd_defs.CMD_LCD_TEXT, row, col, len(text), bytes(text, 'ascii')))
         self._serial.write(cmd)
         self._get_resp()
 
+    ## Draws an image in the display buffer.
+    #
+    # The image is sent in the display layout, compressed and, when the
+    # buffer contents are known (after lcd_clear() or a full screen blit),
+    # as a difference from them. Unchanged pages are skipped, so redrawing
+    # a host-rendered screen costs little more than its modified parts.
+    # @param image is a numpy array (nonzero elements are lit pixels) or
+    # a PIL image. Its height is rounded up to whole pages, the extra rows
+    # are cleared.
+    # @param x is the horizontal coordinate of the top-left corner (0-127).
+    # @param page is the page of the top-left corner (0-7, 8 rows each).
+    # @param refresh redraws the display afterwards (see lcd_refresh()).
+    def lcd_blit(self, image, x=0, page=0, refresh=True):
+        data = self._lcd_pages(image)
+        pages, width = data.shape
+
+        if width == 0 or x + width > self.LCD_WIDTH or page + pages > self.LCD_PAGES:
+            raise Exception('Image does not fit the display')
+
+        frame, self._lcd_frame = self._lcd_frame, None
+        delta = None if frame is None else data ^ frame[page:page + pages, x:x + width]
+        cmds = []
+        first = 0
+
+        while first < pages:
+            if delta is not None and not delta[first].any():
+                first += 1
+                continue
+
+            # as many pages as fit in a single command
+            last = first + 1
+            flags, payload = self._lcd_encode(data[first:last],
+                    None if delta is None else delta[first:last])
+
+            while last < pages:
+                encoded = self._lcd_encode(data[first:last + 1],
+                        None if delta is None else delta[first:last + 1])
+
+                if len(encoded[1]) > self.LCD_BLIT_MAX:
+                    break
+
+                flags, payload = encoded
+                last += 1
+
+            cmds.append([flags, page + first, payload])
+            first = last
+
+        if not cmds:
+            if refresh:
+                self.lcd_refresh()
+        else:
+            if refresh:
+                cmds[-1][0] |= cmd_defs.CMD_LCD_BLIT_REFRESH
+
+            # commands are queued by the badge, so responses are collected afterwards
+            for flags, first, payload in cmds:
+                self._serial.write(self._make_cmd(cmd_defs.CMD_TYPE_LCD,
+                        struct.pack('>BBBBB', cmd_defs.CMD_LCD_BLIT, x, first, width, flags)
+                        + payload))
+
+            for _ in cmds:
+                self._get_resp()
+
+        if frame is None and (x, page, width, pages) == (0, 0, self.LCD_WIDTH, self.LCD_PAGES):
+            frame = data.copy()
+        elif frame is not None:
+            frame[page:page + pages, x:x + width] = data
+
+        self._lcd_frame = frame
+
+    ## Reads the display buffer.
+    #
+    # The buffer may contain changes that have not been drawn on the display
+    # yet (see lcd_refresh()).
+    # @return numpy array [LCD_HEIGHT x LCD_WIDTH], 1 for lit pixels.
+    def lcd_read(self):
+        for page in range(self.LCD_PAGES):
+            self._serial.write(self._make_cmd(cmd_defs.CMD_TYPE_LCD,
+                    struct.pack('>BB', cmd_defs.CMD_LCD_READ, page)))
+
+        pages = np.array([np.frombuffer(self._get_resp(), dtype=np.uint8)
+                for page in range(self.LCD_PAGES)])
+        self._lcd_frame = pages.copy()
+
+        return self._lcd_image(pages)
+
+    ## Enables display mirroring.
+    #
+    # When enabled, the badge sends the display updates before command
+    # responses, so they never interrupt streamed data. The first update
+    # contains the whole display, then only the modified parts follow.
+    # Use lcd_mirror_update() to receive updates when no other commands are
+    # issued.
+    # @param mode is CMD_LCD_MIRROR_SPANS (modified spans of the presented
+    # frames), CMD_LCD_MIRROR_FRAMES (whole frames) or CMD_LCD_MIRROR_OFF.
+    def lcd_mirror(self, mode=cmd_defs.CMD_LCD_MIRROR_SPANS):
+        if mode != self._lcd_mirror_mode:
+            self._lcd_mirror = None if mode == cmd_defs.CMD_LCD_MIRROR_OFF \
+                    else np.zeros((self.LCD_PAGES, self.LCD_WIDTH), dtype=np.uint8)
+
+        self._lcd_mirror_mode = mode
+        cmd = self._make_cmd(cmd_defs.CMD_TYPE_LCD,
+                struct.pack('>BB', cmd_defs.CMD_LCD_MIRROR, mode))
+        self._serial.write(cmd)
+        self._get_resp()
+
+    ## Receives the pending display mirroring updates (see lcd_mirror()).
+    #
+    # @return numpy array [LCD_HEIGHT x LCD_WIDTH] with the display contents
+    # (1 for lit pixels) or None if nothing has changed since the previous call.
+    def lcd_mirror_update(self):
+        if self._lcd_mirror is None:
+            raise Exception('Display mirroring is disabled')
+
+        self.lcd_mirror(self._lcd_mirror_mode)
+
+        if not self._lcd_mirror_changed:
+            return None
+
+        self._lcd_mirror_changed = False
+        return self._lcd_image(self._lcd_mirror)
+
+    ## Reads the display frame statistics, collected since the previous reset.
+    #
+    # Draw time lasts from the first buffer modification to the frame
+    # presentation, queue time until the first transaction is started and
+    # transfer time until the last one is finished.
+    # @param reset clears the statistics after reading.
+    # @param overlay shows the frame rate in the top-right corner of the display.
+    # @return dictionary with the number of transferred frames ('frames'),
+    # the frame rate ('fps') and (min, avg, max) tuples: 'draw', 'queue',
+    # 'transfer' [s] and 'bytes'.
+    def lcd_stats(self, reset=False, overlay=False):
+        flags = (cmd_defs.CMD_LCD_STATS_RESET if reset else 0) \
+                | (cmd_defs.CMD_LCD_STATS_OVERLAY if overlay else 0)
+        self._serial.write(self._make_cmd(cmd_defs.CMD_TYPE_LCD,
+                struct.pack('>BB', cmd_defs.CMD_LCD_STATS, flags)))
+        values = struct.unpack('>14I', self._get_resp())
+        stats = {'frames': values[0], 'fps': values[1]}
+
+        for i, name in enumerate(('draw', 'queue', 'transfer', 'bytes')):
+            stat = values[2 + i * 3:5 + i * 3]
+            stats[name] = stat if name == 'bytes' else tuple(v * 1e-6 for v in stat)
+
+        return stats
+
     ## Turns on/off an LED.
     #
     # @param led is the LED number (LED1 [0] or LED2 [1]).
@@ -292,3 +576,348 @@ class KiconBadge:
                     data_in_len, data_in))
         self._serial.write(cmd)
         return self._get_resp()
+
+    ## Starts streaming ADC samples to the host.
+    #
+    # Samples are sent continuously until adc_stream_stop() is called.
+    # Channels are interleaved and the total sampling rate (rate * number of
+    # channels) cannot exceed ADC_MAX_RATE.
+    # @param channels is the channel mask (ADC_CH1, ADC_CH2 or both).
+    # @param rate is the sampling frequency per channel [Hz].
+    def adc_stream_start(self, channels, rate):
+        chan_count = bin(channels & (self.ADC_CH1 | self.ADC_CH2)).count('1')
+
+        if chan_count == 0:
+            raise Exception("No ADC channel selected")
+
+        if rate < 1 or rate * chan_count > self.ADC_MAX_RATE:
+            raise Exception("Total sampling rate must be in range [1-%d] Hz" % self.ADC_MAX_RATE)
+
+        self._adc_channels = chan_count
+        self._adc_stream_result = None
+        cmd = self._make_cmd(cmd_defs.CMD_TYPE_ADC,
+                struct.pack('>BBI', cmd_defs.CMD_ADC_STREAM, channels, rate))
+        self._serial.write(cmd)
+
+    ## Reads the next block of streamed samples.
+    #
+    # Gaps in the sequence numbers indicate blocks dropped by the badge.
+    # @return Tuple (sequence number, numpy array [samples x channels]) or None
+    # if the stream has been terminated by the badge.
+    def adc_stream_read(self):
+        block = self._adc_read_block()
+
+        if block is None:
+            self._adc_stream_result = self._get_resp()
+            return None
+
+        seq, data = block
+        return seq, self._unpack12(data, self._adc_channels)
+
+    ## Stops streaming ADC samples.
+    #
+    # @return Tuple (actual sampling frequency per channel [Hz], number of dropped blocks).
+    def adc_stream_stop(self):
+        # the badge might have terminated the stream already (button press),
+        # then the stop byte would be taken as the beginning of a command
+        while self._adc_stream_result is None and self._serial.in_waiting:
+            self.adc_stream_read()
+
+        if self._adc_stream_result is None:
+            self._serial.write(b'\x00')
+
+            while self._adc_read_block() is not None:
+                pass
+
+            self._adc_stream_result = self._get_resp()
+
+        result = struct.unpack('>II', self._adc_stream_result)
+        self._adc_stream_result = None
+        return result
+
+    ## Acquires a continuous record of samples by streaming them.
+    #
+    # @param channels is the channel mask (ADC_CH1, ADC_CH2 or both).
+    # @param rate is the sampling frequency per channel [Hz].
+    # @param samples is the number of samples per channel.
+    # @return numpy array of 12-bit samples [samples x channels].
+    def adc_stream(self, channels, rate, samples):
+        blocks = []
+        acquired = 0
+        next_seq = 0
+
+        self.adc_stream_start(channels, rate)
+
+        while acquired < samples:
+            block = self.adc_stream_read()
+
+            if block is None:
+                raise Exception("Stream terminated by the badge")
+
+            seq, data = block
+
+            if seq != next_seq:
+                self.adc_stream_stop()
+                raise Exception("Samples lost, try a lower sampling rate")
+
+            blocks.append(data)
+            acquired += data.shape[0]
+            next_seq = (seq + 1) & 0xffff
+
+        self.adc_stream_stop()
+        return np.concatenate(blocks)[:samples]
+
+    ## Acquires a record of samples in a single transfer.
+    #
+    # The samples are stored in the badge memory and sent back at once, so
+    # the sampling rate is not limited by the USB throughput, but the record
+    # length is limited to ADC_READ_MAX samples (all channels together).
+    # @param channels is the channel mask (ADC_CH1, ADC_CH2 or both).
+    # @param rate is the sampling frequency per channel [Hz].
+    # @param samples is the number of samples per channel.
+    # @return Tuple (actual sampling frequency per channel [Hz],
+    # numpy array of 12-bit samples [samples x channels]).
+    def adc_read(self, channels, rate, samples):
+        chan_count = bin(channels & (self.ADC_CH1 | self.ADC_CH2)).count('1')
+
+        if chan_count == 0:
+            raise Exception("No ADC channel selected")
+
+        if rate < 1 or rate * chan_count > self.ADC_MAX_RATE:
+            raise Exception("Total sampling rate must be in range [1-%d] Hz" % self.ADC_MAX_RATE)
+
+        if samples < 1 or samples * chan_count > self.ADC_READ_MAX:
+            raise Exception("Record length must be in range [1-%d] samples"
+                    % (self.ADC_READ_MAX // chan_count))
+
+        self._serial.write(self._make_cmd(cmd_defs.CMD_TYPE_ADC,
+                struct.pack('>BBII', cmd_defs.CMD_ADC_READ, channels, rate, samples)))
+
+        # wait for the acquisition to finish (with some margin)
+        deadline = time.time() + samples / rate + 1.0
+
+        while self._serial.in_waiting == 0:
+            if time.time() > deadline:
+                self._serial.write(b'\x00')     # cancel the acquisition
+                break
+
+            time.sleep(0.01)
+
+        block = self._adc_read_block()
+
+        if block is None:
+            # empty block, the response contains the error code
+            self._get_resp()
+            raise Exception("Acquisition failed")
+
+        data = self._unpack12(block[1], 1)
+        actual_rate = struct.unpack('>I', self._get_resp())[0]
+
+        return actual_rate, data[:samples * chan_count].reshape(-1, chan_count)
+
+    ## Acquires a record of oversampled and decimated samples.
+    #
+    # Every output sample is the sum of 4^bits conversions scaled down by
+    # 2^bits, so the results have 12 + bits bits of resolution.
+    # @param channels is the channel mask (ADC_CH1, ADC_CH2 or both).
+    # @param rate is the output sampling frequency per channel [Hz]
+    # (rate * 4^bits * number of channels cannot exceed ADC_MAX_RATE).
+    # @param bits is the number of extra resolution bits (1-4).
+    # @param samples is the number of output samples per channel.
+    # @return Tuple (actual output sampling frequency per channel [Hz],
+    # numpy array of (12 + bits)-bit samples [samples x channels]).
+    # Full scale (3.3 V) is 4095 * 2^bits.
+    def adc_oversample(self, channels, rate, bits, samples):
+        chan_count = bin(channels & (self.ADC_CH1 | self.ADC_CH2)).count('1')
+
+        if chan_count == 0:
+            raise Exception("No ADC channel selected")
+
+        if bits < 1 or bits > 4:
+            raise Exception("Extra resolution must be in range [1-4] bits")
+
+        if rate < 1 or (rate << (2 * bits)) * chan_count > self.ADC_MAX_RATE:
+            raise Exception("Output sampling rate must be in range [1-%d] Hz"
+                    % (self.ADC_MAX_RATE // chan_count >> (2 * bits)))
+
+        if samples < 1 or samples * chan_count > self.ADC_OVERSAMPLE_MAX:
+            raise Exception("Record length must be in range [1-%d] samples"
+                    % (self.ADC_OVERSAMPLE_MAX // chan_count))
+
+        self._serial.write(self._make_cmd(cmd_defs.CMD_TYPE_ADC,
+                struct.pack('>BBIBI', cmd_defs.CMD_ADC_OVERSAMPLE, channels, rate,
+                    bits, samples)))
+
+        # wait for the acquisition to finish (with some margin)
+        deadline = time.time() + samples / rate + 1.0
+
+        while self._serial.in_waiting == 0:
+            if time.time() > deadline:
+                self._serial.write(b'\x00')     # cancel the acquisition
+                break
+
+            time.sleep(0.01)
+
+        count, resolution = struct.unpack('<HH', self._read_exact(4))
+
+        if count == 0:
+            # empty record, the response contains the error code
+            self._get_resp()
+            raise Exception("Acquisition failed")
+
+        data = np.frombuffer(self._read_exact(count * 2), dtype='<u2')
+        actual_rate = struct.unpack('>I', self._get_resp())[0]
+
+        return actual_rate, data.reshape(-1, chan_count)
+
+    ## Measures the signal(s) on the ADC channels.
+    #
+    # @param channels is the channel mask (ADC_CH1, ADC_CH2 or both).
+    # @param rate is the sampling frequency per channel [Hz].
+    # @return List of dictionaries (one per channel) with keys: 'vpp', 'mean',
+    # 'rms' [V], 'freq' [Hz] and 'period' [s]. Frequency and period are 0 if
+    # no period has been detected.
+    def adc_measure(self, channels, rate):
+        chan_count = bin(channels & (self.ADC_CH1 | self.ADC_CH2)).count('1')
+
+        if chan_count == 0:
+            raise Exception("No ADC channel selected")
+
+        if rate < 1 or rate * chan_count > self.ADC_MAX_RATE:
+            raise Exception("Total sampling rate must be in range [1-%d] Hz" % self.ADC_MAX_RATE)
+
+        self._serial.write(self._make_cmd(cmd_defs.CMD_TYPE_ADC,
+                struct.pack('>BBI', cmd_defs.CMD_ADC_MEASURE, channels, rate)))
+        resp = self._get_resp()
+        results = []
+
+        for i in range(chan_count):
+            vpp, mean, rms, freq, period = struct.unpack_from('>HHHII', resp, i * 14)
+            results.append({'vpp': vpp / 1000.0, 'mean': mean / 1000.0,
+                    'rms': rms / 1000.0, 'freq': freq, 'period': period * 1e-9})
+
+        return results
+
+    ## Acquires the logic inputs and ADC channels with a common time base.
+    #
+    # The logic inputs sampling frequency is an integer multiple (ratio)
+    # of the ADC sampling frequency, digital sample n corresponds to ADC
+    # sample n // ratio.
+    # @param channels is the channel mask (ADC_CH1, ADC_CH2 or both).
+    # @param rate is the logic inputs sampling frequency [Hz]
+    # (10, 8, 6, 5, 4, 3, 2, 1 MHz, 500, 250 or 125 kHz).
+    # @param trigger is the trigger source (cmd_defs.CMD_ADC_TRIG_*).
+    # @param mask selects the logic inputs that trigger the acquisition.
+    # @param value is the logic inputs state that triggers the acquisition.
+    # @param level is the analog trigger level [V].
+    # @param rising selects the analog trigger edge.
+    # @param timeout is the maximum time to wait for the trigger [s].
+    # @return Dictionary with keys: 'digital' (numpy array of logic inputs
+    # states), 'analog' (numpy array of 12-bit samples [samples x channels]),
+    # 'trigger' (trigger position in digital samples), 'ratio',
+    # 'digital_rate' and 'analog_rate' [Hz].
+    def adc_mixed(self, channels, rate, trigger=cmd_defs.CMD_ADC_TRIG_NONE,
+            mask=0, value=0, level=1.65, rising=True, timeout=5.0):
+        if channels & (self.ADC_CH1 | self.ADC_CH2) == 0:
+            raise Exception("No ADC channel selected")
+
+        level_raw = min(max(int(level * 4095 / 3.3), 0), 4095)
+        self._serial.write(self._make_cmd(cmd_defs.CMD_TYPE_ADC,
+                struct.pack('>BBIBBBHB', cmd_defs.CMD_ADC_MIXED, channels, rate,
+                    trigger, mask, value, level_raw, 1 if rising else 0)))
+
+        deadline = time.time() + timeout
+
+        while self._serial.in_waiting == 0:
+            if time.time() > deadline:
+                self._serial.write(b'\x00')     # cancel waiting for the trigger
+                break
+
+            time.sleep(0.01)
+
+        dig_count, ana_count, chan_count, ratio, trig_pos = struct.unpack('<HHBBH',
+                self._read_exact(8))
+
+        if dig_count == 0:
+            # empty record, the response contains the error code
+            self._get_resp()
+            raise Exception("Trigger not found")
+
+        digital = np.frombuffer(self._read_exact(dig_count), dtype=np.uint8)
+        analog = np.frombuffer(self._read_exact(ana_count * chan_count * 2),
+                dtype='<u2').reshape(-1, chan_count)
+        dig_rate, ana_rate = struct.unpack('>II', self._get_resp())
+
+        return {'digital': digital, 'analog': analog, 'trigger': trig_pos,
+                'ratio': ratio, 'digital_rate': dig_rate, 'analog_rate': ana_rate}
+
+    # Converts a voltage span to DAC codes.
+    def _dac_codes(self, volts):
+        return min(max(int(round(volts * 4095 / (self.DAC_MAX_V - self.DAC_MIN_V))), 0), 4095)
+
+    ## Starts the waveform generator on the DAC0 pin (PB13).
+    #
+    # @param wave is the waveform (cmd_defs.CMD_DAC_SINE, CMD_DAC_SQUARE,
+    # CMD_DAC_TRIANGLE or CMD_DAC_ARBITRARY, see dac_load()).
+    # @param freq is the waveform frequency [Hz] (up to 250 kHz).
+    # @param vpp is the peak-to-peak amplitude [V].
+    # @param offset is the center level [V]. The output is clipped to
+    # DAC_MIN_V - DAC_MAX_V.
+    # @param burst is the number of periods in a burst (0 for continuous output).
+    # @param idle is the number of idle periods between bursts (0 for a single burst).
+    # @return Tuple of the actual frequency [Hz] and samples per period.
+    def dac_start(self, wave, freq, vpp=DAC_MAX_V - DAC_MIN_V,
+            offset=(DAC_MAX_V + DAC_MIN_V) / 2, burst=0, idle=0):
+        cmd = self._make_cmd(cmd_defs.CMD_TYPE_DAC,
+                struct.pack('>BBIHHHH', cmd_defs.CMD_DAC_START, wave, freq,
+                    self._dac_codes(vpp), self._dac_codes(offset - self.DAC_MIN_V),
+                    burst, idle))
+        self._serial.write(cmd)
+        return struct.unpack('>IH', self._get_resp())
+
+    ## Starts a repeated linear frequency sweep on the DAC0 pin (PB13).
+    #
+    # The waveform period has the same number of samples over the whole
+    # range, so the frequency steps get coarser at the upper end.
+    # @param wave is the waveform (see dac_start()).
+    # @param f_start is the initial frequency [Hz].
+    # @param f_stop is the final frequency [Hz].
+    # @param duration is the sweep duration [s].
+    # @param vpp is the peak-to-peak amplitude [V].
+    # @param offset is the center level [V].
+    # @return Tuple of the actual initial frequency [Hz] and samples per period.
+    def dac_sweep(self, wave, f_start, f_stop, duration, vpp=DAC_MAX_V - DAC_MIN_V,
+            offset=(DAC_MAX_V + DAC_MIN_V) / 2):
+        cmd = self._make_cmd(cmd_defs.CMD_TYPE_DAC,
+                struct.pack('>BBIIIHH', cmd_defs.CMD_DAC_SWEEP, wave, f_start,
+                    f_stop, int(duration * 1000), self._dac_codes(vpp),
+                    self._dac_codes(offset - self.DAC_MIN_V)))
+        self._serial.write(cmd)
+        return struct.unpack('>IH', self._get_resp())
+
+    ## Stops the waveform generator.
+    def dac_stop(self):
+        cmd = self._make_cmd(cmd_defs.CMD_TYPE_DAC,
+                struct.pack('>B', cmd_defs.CMD_DAC_STOP))
+        self._serial.write(cmd)
+        self._get_resp()
+
+    ## Uploads one period of the arbitrary waveform (CMD_DAC_ARBITRARY).
+    #
+    # The new waveform is used by the next dac_start() or dac_sweep() call.
+    # @param samples are the waveform samples (-1.0 to 1.0, 4 to
+    # DAC_MAX_SAMPLES), scaled by the amplitude when generated.
+    def dac_load(self, samples):
+        data = (np.clip(np.asarray(samples, dtype=float), -1.0, 1.0) * 32767).astype('>i2')
+
+        if len(data) < 4 or len(data) > self.DAC_MAX_SAMPLES:
+            raise Exception("Invalid waveform size")
+
+        chunk = 124     # samples per command
+
+        for first in range(0, len(data), chunk):
+            cmd = self._make_cmd(cmd_defs.CMD_TYPE_DAC,
+                    struct.pack('>BHH', cmd_defs.CMD_DAC_LOAD, first, len(data))
+                    + data[first:first + chunk].tobytes())
+            self._serial.write(cmd)
+            self._get_resp()
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+#
+# This source code is free software; you can redistribute it
+# and/or modify it in source code form under the terms of the GNU
+# General Public License as published by the Free Software
+# Foundation; either version 2 of the License, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+## @package docstring
+# Shows the badge display contents live (the badge has to run the command
+# interface) or saves a snapshot.
+
+from kicon_badge import KiconBadge
+import commands_def as cmd_defs
+import argparse
+import tkinter as tk
+
+LIT = '#ffffff'
+UNLIT = '#000000'
+
+
+# Saves an image as PBM, using the same convention as the images directory
+# (black pixels are off), so snapshots can be converted back to bitmaps.
+def save_pbm(path, image):
+    with open(path, 'w') as f:
+        f.write('P1\n%d %d\n' % (image.shape[1], image.shape[0]))
+
+        for row in image:
+            line = ''.join('0' if v else '1' for v in row)
+
+            # lines should not exceed 70 characters
+            for i in range(0, len(line), 64):
+                f.write(line[i:i + 64] + '\n')
+
+
+class Viewer:
+    def __init__(self, root, badge, scale, interval):
+        self._root = root
+        self._badge = badge
+        self._scale = scale
+        self._interval = interval
+        self._updates = 0
+        self._image = tk.PhotoImage(width=badge.LCD_WIDTH, height=badge.LCD_HEIGHT)
+        self._zoomed = self._image.zoom(scale)
+        self._label = tk.Label(root, image=self._zoomed)
+        self._label.pack()
+        self._poll()
+
+    def _show(self, image):
+        self._image.put(' '.join('{' + ' '.join(LIT if v else UNLIT for v in row) + '}'
+                for row in image))
+        self._zoomed = self._image.zoom(self._scale)
+        self._label.configure(image=self._zoomed)
+        self._updates += 1
+        self._root.title('KiCon badge display (%d updates)' % self._updates)
+
+    def _poll(self):
+        image = self._badge.lcd_mirror_update()
+
+        if image is not None:
+            self._show(image)
+
+        self._root.after(self._interval, self._poll)
+
+
+parser = argparse.ArgumentParser(description='Shows the badge display contents')
+parser.add_argument('-p', '--port', default='/dev/ttyACM0', help='badge serial port')
+parser.add_argument('-s', '--scale', type=int, default=4, help='zoom factor')
+parser.add_argument('-i', '--interval', type=int, default=20,
+        help='polling interval [ms]')
+parser.add_argument('--frames', action='store_true',
+        help='receive whole frames instead of the modified spans')
+parser.add_argument('--snapshot', metavar='FILE',
+        help='save the display buffer as a PBM image and quit')
+args = parser.parse_args()
+
+badge = KiconBadge(args.port)
+badge.init()
+
+if args.snapshot:
+    save_pbm(args.snapshot, badge.lcd_read())
+else:
+    badge.lcd_mirror(cmd_defs.CMD_LCD_MIRROR_FRAMES if args.frames
+            else cmd_defs.CMD_LCD_MIRROR_SPANS)
+
+    root = tk.Tk()
+    Viewer(root, badge, args.scale, args.interval)
+
+    try:
+        root.mainloop()
+    finally:
+        badge.lcd_mirror(cmd_defs.CMD_LCD_MIRROR_OFF)
@@ -18,28 +18,55 @@
  */
 
 #include "lcd.h"
+#include "gfx.h"
 #include "scope.h"
 #include "buttons.h"
 #include "apps_list.h"
 #include "settings_list.h"
 #include "io_conf.h"
 #include "buffer.h"
+#include "adc_capture.h"
+#include "command_handlers.h"
+#include "udi_cdc.h"
+#include "fft.h"
+#include "scope_meas.h"
+#include "persistence.h"
+#include "filter.h"
+#include "mixed_signal.h"
+#include "oversample.h"
 
 #include <sysclk.h>
 #include <twi.h>
 #include <pio.h>
 #include <adc.h>
-#include "pdc.h"
+#include <stdio.h>
+#include <string.h>
 
 /* The general buffer is divided in the following way:
  * start                end                     description
  * 0                    SCOPE_BUFFER_SIZE/2-1   adc_ch[0].buffer
  * SCOPE_BUFFER_SIZE/2  SCOPE_BUFFER_SIZE-1     adc_ch[1].buffer
- * SCOPE_BUFFER         SCOPE_BUFFER_SIZE*2     us_value
+ * SCOPE_BUFFER         SCOPE_BUFFER_SIZE*3     us_value (PDC banks)
+ * SCOPE_BUFFER_SIZE*3  SCOPE_BUFFER_SIZE*4     avg_acc (averaging, uint32_t)
+ * SCOPE_BUFFER_SIZE*4  SCOPE_BUFFER_SIZE*5     peak_min, peak_max (peak detect, uint32_t)
+ * SCOPE_BUFFER_SIZE*3  SCOPE_BUFFER_SIZE*4     roll_history (roll mode, uint8_t)
+ * SCOPE_BUFFER_SIZE*6  SCOPE_BUFFER_SIZE*7     ets_sum, ets_cnt, ets_value (equivalent-time)
+ * SCOPE_BUFFER_SIZE*5  SCOPE_BUFFER_SIZE*5.5   filter_work (filtering, int16_t)
+ * PERSIST_BUFFER_SIZE/2 PERSIST_BUFFER_SIZE    persist_counters (uint8_t)
  */
 
 
 static uint16_t * const us_value = &buffer.u16[SCOPE_BUFFER_SIZE];
+static uint32_t * const avg_acc = &buffer.u32[SCOPE_BUFFER_SIZE * 3 / 2];
+static uint32_t * const peak_min = &buffer.u32[SCOPE_BUFFER_SIZE * 2];
+static uint32_t * const peak_max = &buffer.u32[SCOPE_BUFFER_SIZE * 2 + LCD_WIDTH];
+static uint8_t * const roll_history = &buffer.u8[SCOPE_BUFFER_SIZE * 6];
+static uint8_t * const persist_counters = &buffer.u8[PERSIST_BUFFER_SIZE];
+static int16_t * const filter_work = (int16_t*) &buffer.u16[SCOPE_BUFFER_SIZE * 5];
+
+/** PDC banks (ping-pong) */
+#define SCOPE_BANKS     2
+static adcc_buffer_t scope_banks[SCOPE_BANKS];
 
 /** number of lcd pages for a channel*/
 static uint32_t adc_pages_per_channel;
@@ -50,51 +77,55 @@ static uint32_t adc_buffer_size;
 
 static struct adc_ch adc_channels[2];
 
-/**
- * \brief Read converted data through PDC channel.
- *
- * \param p_adc The pointer of adc peripheral.
- * \param p_s_buffer The destination buffer.
- * \param ul_size The size of the buffer.
- */
-static uint32_t adc_read_buffer(Adc * p_adc, uint16_t * p_s_buffer, uint32_t ul_size)
-{
-	/* Check if the first PDC bank is free. */
-	if ((p_adc->ADC_RCR == 0) && (p_adc->ADC_RNCR == 0)) {
-		p_adc->ADC_RPR = (uint32_t) p_s_buffer;
-		p_adc->ADC_RCR = ul_size;
-		p_adc->ADC_PTCR = ADC_PTCR_RXTEN;
-
-		return 1;
-	} else { /* Check if the second PDC bank is free. */
-		if (p_adc->ADC_RNCR == 0) {
-			p_adc->ADC_RNPR = (uint32_t) p_s_buffer;
-			p_adc->ADC_RNCR = ul_size;
-
-			return 1;
-		} else {
-			return 0;
-		}
-	}
-}
+/** Measurement results (updated with every acquired bank) */
+static int meas_enabled;
+static scope_meas_t scope_meas[NUM_CHANNELS];
+
+/** Filters applied to the acquired samples (one per channel) */
+static filter_type_t filter_type;
+static int filter_enabled;
+/* the selected filter is not available at the sampling frequency */
+static int filter_unavailable;
+static filter_t scope_filters[NUM_CHANNELS];
+
+/** Persistence mode: the display is refreshed continuously, the measurement
+ * results are copied when a new frame arrives */
+static int persist_enabled;
+static scope_meas_t persist_meas[NUM_CHANNELS];
+
+/** Acquisition modes */
+enum scope_acq_mode {
+	ACQ_NORMAL,
+	ACQ_PEAK,       /* min/max of every acq_factor samples makes a column */
+	ACQ_AVERAGE     /* average of acq_factor frames */
+};
+
+static enum scope_acq_mode acq_mode;
+static uint32_t acq_factor;
+
+/** Peak detect state: min/max of both halfwords (channels or sample pairs) */
+static uint32_t peak_words_per_col;
+static uint32_t peak_words;
+static uint32_t peak_col;
+static uint32_t peak_cur_min;
+static uint32_t peak_cur_max;
+
+/** Number of frames accumulated for averaging */
+static uint32_t avg_frames;
+
+static int scope_acq_finished(int buf_idx);
 
 /**
  * \brief configures ADC, interrupts and PDC transfer.
  *
  * \param adc_ch The pointer of channels names array.
  * \param ul_size Number of channels.
+ * \param fsampling Sampling frequency (all channels together).
  */
 void scope_configure(enum adc_channel_num_t *adc_ch, uint32_t ul_size, uint32_t fsampling)
 {
 	if (ul_size > NUM_CHANNELS) return;
 
-	pmc_enable_periph_clk(ID_ADC);
-	pio_configure(PIOA, PIO_INPUT, (PIO_PA20X1_AD3 | PIO_PA22X1_AD9), PIO_DEFAULT);
-
-	/* Disable PDC channel interrupt. */
-	adc_disable_interrupt(ADC, 0xFFFFFFFF);
-	adc_disable_all_channel(ADC);
-
 	/* Initialize variables according to number of channels used */
 	if(ul_size == 1)
 	{
@@ -131,39 +162,154 @@ void scope_configure(enum adc_channel_num_t *adc_ch, uint32_t ul_size, uint32_t
                 adc_channels[1].threshold = 32;   /* middle of ADC range */
 	}
 
-        /* one sample takes 20 ADC clock periods */
-	adc_init(ADC, sysclk_get_cpu_hz(), fsampling * 20, ADC_STARTUP_TIME_4);
+	memset(scope_meas, 0, sizeof(scope_meas));
+
+	/* peak detect acquires as fast as possible, a single channel needs
+	 * an even number of samples per column (two samples per word) */
+	if (acq_mode == ACQ_PEAK)
+	{
+		acq_factor = ADCC_MAX_RATE / fsampling;
+
+		if (ul_size == 1)
+			acq_factor &= ~1;
+
+		if (acq_factor < 2)
+			acq_mode = ACQ_NORMAL;
+	}
+
+	if (acq_mode == ACQ_PEAK)
+	{
+		peak_words_per_col = acq_factor * ul_size / 2;
+		peak_words = 0;
+		peak_col = 0;
+		peak_cur_min = 0x0fff0fff;
+		peak_cur_max = 0;
+		fsampling *= acq_factor;
+	}
+	else if (acq_mode == ACQ_AVERAGE)
+	{
+		avg_frames = 0;
+		memset(avg_acc, 0, NUM_CHANNELS * LCD_WIDTH * sizeof(*avg_acc));
+	}
+
+	/* every timer tick converts all channels, keep the total conversion rate */
+	if (!adcc_configure(adc_ch, ul_size, fsampling / ul_size)) return;
+
+	/* filters depend on the actual sampling frequency */
+	filter_enabled = (filter_type != FILTER_NONE);
+	filter_unavailable = 0;
+
+	for (uint32_t i = 0; i < ul_size; i++)
+	{
+		if (!filter_init(&scope_filters[i], filter_type, adcc_get_rate()))
+		{
+			filter_enabled = 0;
+			filter_unavailable = 1;
+		}
+	}
+
+	/* PDC ping-pong: one bank is processed while the other one is filled */
+	for (int i = 0; i < SCOPE_BANKS; i++)
+	{
+		scope_banks[i].addr = us_value + i * adc_buffer_size;
+		scope_banks[i].size = adc_buffer_size;
+		scope_banks[i].last = 0;
+	}
+
+	adcc_set_handler(scope_acq_finished);
+	adcc_start(scope_banks, SCOPE_BANKS);
+}
+
+
+/* Formats a voltage [mV] as volts with two decimal places */
+static int scope_format_volts(char *text, uint16_t mv)
+{
+	return sprintf(text, "%u.%02uV", mv / 1000, (mv % 1000) / 10);
+}
+
+
+/**
+ * \brief Draws the measurement results in the top two rows of a channel.
+ */
+static void scope_draw_meas(uint32_t chan_cnt, const scope_meas_t *meas)
+{
+	uint8_t page = adc_channels[chan_cnt].offset_pages;
+	char text[24];
+	int len;
+
+	len = sprintf(text, "Vpp ");
+	len += scope_format_volts(text + len, meas->vpp);
+	len += sprintf(text + len, " Avg ");
+	len += scope_format_volts(text + len, meas->mean);
+	SSD1306_setString(0, page, text, len, WHITE);
+
+	len = sprintf(text, "RMS ");
+	len += scope_format_volts(text + len, meas->rms);
+
+	if (meas->freq == 0)
+		len += sprintf(text + len, " ---");
+	else if (meas->freq < 1000)
+		len += sprintf(text + len, " %luHz", meas->freq);
+	else
+		len += sprintf(text + len, " %lu.%02lukHz", meas->freq / 1000,
+				(meas->freq % 1000) / 10);
+
+	SSD1306_setString(0, page + 1, text, len, WHITE);
+}
+
+
+/**
+ * \brief Tells that the selected filter is off (notch filters work only
+ * at low sampling frequencies).
+ */
+static void scope_draw_filter_notice(void)
+{
+	char text[24];
+	int len;
 
-	/* Formula:
-	 *     Transfer Time = (TRANSFER * 2 + 3) / ADCClock
-	 *     Tracking Time = (TRACKTIM + 1) / ADCClock
-	 *     Settling Time = settling value / ADCClock
-	 *
-	 *     Transfer Time = (1 * 2 + 3) / 100kHz
-	 *     Tracking Time = (1 + 1) / 100kHz
-	 *     Settling Time = 3 / 100kHz
-	 */
-	adc_configure_timing(ADC, TRACKING_TIME, ADC_SETTLING_TIME_3, TRANSFER_PERIOD);
+	if (!filter_unavailable)
+		return;
 
-	/* Enable channel number tag. */
-	adc_enable_tag(ADC);
+	len = sprintf(text, "Notch off >%dkHz", FILTER_NOTCH_MAX_RATE / 1000);
+	SSD1306_setString(LCD_WIDTH - 6 * len, LCD_PAGES - 1, text, len, BLACK);
+}
 
-	NVIC_EnableIRQ(ADC_IRQn);
 
-	/* Enable channels. */
-	for(uint32_t i = 0; i < ul_size; i++)
+/**
+ * \brief Accumulates new frames in the persistence buffer and renders it.
+ */
+static void scope_draw_persist(void)
+{
+	if (adc_buffers_rdy)
 	{
-		adc_enable_channel(ADC, adc_channels[i].channel);
+		for (uint32_t chan_cnt = 0; chan_cnt < adc_active_channels; chan_cnt++)
+		{
+			const uint16_t *pixels = adc_channels[chan_cnt].draw_buffer;
+
+			for (int i = 0; i < LCD_WIDTH; i++)
+			{
+				if (acq_mode == ACQ_PEAK)
+					persist_vline(i, pixels[i], pixels[LCD_WIDTH + i]);
+				else
+					persist_pixel(i, pixels[i]);
+			}
+		}
+
+		memcpy(persist_meas, scope_meas, sizeof(persist_meas));
+		adc_buffers_rdy = 0;
 	}
 
-	adc_configure_trigger(ADC, ADC_TRIG_SW, 1);
+	/* keep rendering between acquisitions, dithering needs a high frame rate */
+	persist_render();
 
-	adc_start(ADC);
+	if (meas_enabled)
+	{
+		for (uint32_t chan_cnt = 0; chan_cnt < adc_active_channels; chan_cnt++)
+			scope_draw_meas(chan_cnt, &persist_meas[chan_cnt]);
+	}
 
-	/* Enable PDC channel interrupt. */
-	adc_enable_interrupt(ADC, ADC_IER_RXBUFF);
-	/* Start new pdc transfer. */
-	adc_read_buffer(ADC, us_value, adc_buffer_size);
+	scope_draw_filter_notice();
+	SSD1306_drawBufferDMA();
 }
 
 
@@ -172,8 +318,14 @@ void scope_configure(enum adc_channel_num_t *adc_ch, uint32_t ul_size, uint32_t
  */
 void scope_draw(void)
 {
-	/*Checks whether new data ready and that display is not busy*/
-    if(adc_buffers_rdy && !SSD1306_isBusy() )
+	if (persist_enabled)
+	{
+		scope_draw_persist();
+		return;
+	}
+
+	/*Checks whether new data ready*/
+    if(adc_buffers_rdy)
     {
     	for(uint32_t chan_cnt=0; chan_cnt<adc_active_channels; chan_cnt++)
     	{
@@ -182,9 +334,17 @@ void scope_draw(void)
     		SSD1306_clearBuffer(0, adc_channels[chan_cnt].offset_pages, BLACK, adc_pixels_per_channel);
 			for(int i = 0; i<(LCD_WIDTH); i++)
 			{
-				SSD1306_setPixel(i, adc_channels[chan_cnt].draw_buffer[i], 1);
+				if (acq_mode == ACQ_PEAK)
+					SSD1306_setLine(i, adc_channels[chan_cnt].draw_buffer[i],
+							i, adc_channels[chan_cnt].draw_buffer[LCD_WIDTH + i], WHITE);
+				else
+					SSD1306_setPixel(i, adc_channels[chan_cnt].draw_buffer[i], 1);
 			}
+
+			if (meas_enabled)
+				scope_draw_meas(chan_cnt, &scope_meas[chan_cnt]);
     	}
+		scope_draw_filter_notice();
 		SSD1306_drawBufferDMA();
 		adc_buffers_rdy=0;
     }
@@ -192,147 +352,1355 @@ void scope_draw(void)
 
 
 /**
- * \brief Interrupt handler for the ADC.
+ * \brief Extracts the minimum of a channel from packed halfwords. With two
+ * channels, the lower halfword holds the first one; a single channel uses both.
  */
-void ADC_Handler(void)
+static uint32_t scope_unpack_min(uint32_t packed, uint32_t chan_cnt, uint32_t channels)
+{
+	uint32_t lo = packed & 0xffff, hi = packed >> 16;
+
+	if (channels == 2)
+		return chan_cnt ? hi : lo;
+
+	return lo < hi ? lo : hi;
+}
+
+
+static uint32_t scope_unpack_max(uint32_t packed, uint32_t chan_cnt, uint32_t channels)
 {
-	uint32_t i;
-	uint8_t uc_ch_num;
-	uint32_t adc0_counter;
-	uint32_t adc1_counter;
+	uint32_t lo = packed & 0xffff, hi = packed >> 16;
 
-	uint32_t adc0_thr_found;
-	uint32_t adc1_thr_found;
+	if (channels == 2)
+		return chan_cnt ? hi : lo;
+
+	return lo > hi ? lo : hi;
+}
 
-	uint32_t adc0_thr_index;
-	uint32_t adc1_thr_index;
 
-	if ((adc_get_status(ADC) & ADC_ISR_RXBUFF) == ADC_ISR_RXBUFF)
+/**
+ * \brief Converts the peak detect columns to pixels (min in the first half,
+ * max in the second half of a channel buffer).
+ */
+static void scope_peak_frame(void)
+{
+	for (uint32_t chan_cnt = 0; chan_cnt < adc_active_channels; chan_cnt++)
 	{
-		/* If previous buffer not processed yet - leave */
-		if(adc_buffers_rdy)
+		uint16_t *pixels = adc_channels[chan_cnt].buffer;
+
+		for (int i = 0; i < LCD_WIDTH; i++)
 		{
-			/* Start new pdc transfer */
-			adc_read_buffer(ADC, us_value, adc_buffer_size);
-			return;
+			uint32_t min = scope_unpack_min(peak_min[i], chan_cnt, adc_active_channels);
+			uint32_t max = scope_unpack_max(peak_max[i], chan_cnt, adc_active_channels);
+
+			pixels[i] = min*RESOLUTION(adc_pages_per_channel) + adc_channels[chan_cnt].offset_pixels;
+			pixels[LCD_WIDTH + i] = max*RESOLUTION(adc_pages_per_channel) + adc_channels[chan_cnt].offset_pixels;
 		}
 
-		adc0_counter=0;
-		adc1_counter=0;
+		adc_channels[chan_cnt].draw_buffer = pixels;
+	}
+}
 
-		adc0_thr_found=0;
-		adc1_thr_found=0;
 
-		adc0_thr_index=0;
-		adc1_thr_index=0;
+/**
+ * \brief Streaming min/max reduction of an acquired bank (called from the ADC interrupt).
+ *
+ * Columns span across banks, a frame is ready after LCD_WIDTH columns.
+ */
+static void scope_peak_detect(const uint16_t *bank)
+{
+	/* banks are word aligned, samples are processed in pairs */
+	const uint32_t *words = (const void*) bank;
 
-		adc_channels[0].draw_buffer = adc_channels[0].buffer;
-		adc_channels[1].draw_buffer = adc_channels[1].buffer;
+	for (uint32_t i = 0; i < adc_buffer_size / 2; i++)
+	{
+		uint32_t word = ADCC_DATA2(words[i]);     /* strip channel tags */
 
-		for (i = 0; i < adc_buffer_size; i++)
+		/* GE flags select the smaller/larger halfword */
+		__USUB16(word, peak_cur_min);
+		peak_cur_min = __SEL(peak_cur_min, word);
+		__USUB16(word, peak_cur_max);
+		peak_cur_max = __SEL(word, peak_cur_max);
+
+		if (++peak_words < peak_words_per_col)
+			continue;
+
+		peak_min[peak_col] = peak_cur_min;
+		peak_max[peak_col] = peak_cur_max;
+		peak_cur_min = 0x0fff0fff;
+		peak_cur_max = 0;
+		peak_words = 0;
+
+		if (++peak_col == LCD_WIDTH)
 		{
-			/* 4MSB of ADC readout is channel number. Retrieve it */
-			uc_ch_num = (us_value[i] & ADC_LCDR_CHNB_Msk) >> ADC_LCDR_CHNB_Pos;
+			peak_col = 0;
 
-			/* Compare the tag with a channel and put the value to the respective channel buffer*/
-			if (adc_channels[0].channel == uc_ch_num)
-			{
-				/* Check if enough samples to display*/
-				if ((adc0_counter-adc0_thr_index)>=LCD_WIDTH)
-					continue;
-
-				/* Remove the tag from the ADC readout and convert it to number of pixels*/
-				adc_channels[0].buffer[adc0_counter]=(us_value[i] & ADC_LCDR_LDATA_Msk)*RESOLUTION(adc_pages_per_channel) + adc_channels[0].offset_pixels;
-
-				/* Check if sample is above threshold - start to draw from here*/
-				if(!adc0_thr_found && adc_channels[0].buffer[adc0_counter]>= adc_channels[0].threshold)
-				{
-					adc_channels[0].draw_buffer = adc_channels[0].buffer + adc0_counter;
-					adc0_thr_index = adc0_counter;
-					adc0_thr_found = 1;
-				}
-				adc0_counter++;
-				continue;
-			}
-			if (adc_channels[1].channel == uc_ch_num)
+			/* drop the frame if the previous one has not been drawn yet */
+			if (!adc_buffers_rdy)
 			{
-				/* Check if enough samples to display*/
-				 if ((adc1_counter-adc1_thr_index)>=LCD_WIDTH)
-					 continue;
-
-				/*Remove the tag from the ADC readout and convert it to number of pixels*/
-				adc_channels[1].buffer[adc1_counter]=(us_value[i] & ADC_LCDR_LDATA_Msk)*RESOLUTION(adc_pages_per_channel) + adc_channels[1].offset_pixels;
-
-				/* Check if sample is above threshold - start to draw from here*/
-				if(!adc1_thr_found && adc_channels[1].buffer[adc1_counter]>= adc_channels[1].threshold)
-				{
-					adc_channels[1].draw_buffer = adc_channels[1].buffer + adc1_counter;
-					adc1_thr_index = adc1_counter;
-					adc1_thr_found = 1;
-				}
-				adc1_counter++;
-				continue;
+				scope_peak_frame();
+				adc_buffers_rdy = 1;
 			}
-			break;
 		}
+	}
+}
+
+
+/**
+ * \brief Accumulates the triggered samples of a frame (called from the ADC interrupt).
+ *
+ * \param bank The acquired bank.
+ * \param counters Number of samples stored in channel buffers.
+ * \return 1 when the averaged frame is ready.
+ */
+static int scope_average(const uint16_t *bank, const uint32_t *counters)
+{
+	uint32_t start[NUM_CHANNELS];
+
+	for (uint32_t chan_cnt = 0; chan_cnt < adc_active_channels; chan_cnt++)
+	{
+		start[chan_cnt] = adc_channels[chan_cnt].draw_buffer - adc_channels[chan_cnt].buffer;
 
-		adc_buffers_rdy = 1;
+		/* trigger found too late to fill the screen, skip the frame */
+		if (counters[chan_cnt] - start[chan_cnt] < LCD_WIDTH)
+			return 0;
+	}
+
+	/* channel samples are interleaved in the bank, accumulate raw values */
+	for (uint32_t chan_cnt = 0; chan_cnt < adc_active_channels; chan_cnt++)
+	{
+		const uint16_t *samples = bank + start[chan_cnt] * adc_active_channels + chan_cnt;
+		uint32_t *acc = &avg_acc[chan_cnt * LCD_WIDTH];
+
+		for (int i = 0; i < LCD_WIDTH; i++)
+			acc[i] += samples[i * adc_active_channels] & ADC_LCDR_LDATA_Msk;
+	}
+
+	if (++avg_frames < acq_factor)
+		return 0;
+
+	for (uint32_t chan_cnt = 0; chan_cnt < adc_active_channels; chan_cnt++)
+	{
+		uint32_t *acc = &avg_acc[chan_cnt * LCD_WIDTH];
+
+		for (int i = 0; i < LCD_WIDTH; i++)
+		{
+			adc_channels[chan_cnt].buffer[i] = (acc[i] / acq_factor)*RESOLUTION(adc_pages_per_channel)
+				+ adc_channels[chan_cnt].offset_pixels;
+			acc[i] = 0;
+		}
 
-		/* Start new pdc transfer */
-		adc_read_buffer(ADC, us_value, adc_buffer_size);
+		adc_channels[chan_cnt].draw_buffer = adc_channels[chan_cnt].buffer;
 	}
+
+	avg_frames = 0;
+
+	return 1;
 }
 
 
-void app_scope_func(void)
+/**
+ * \brief Filters an acquired bank in place (called from the ADC interrupt).
+ *
+ * Channel samples are de-interleaved to Q15 (with one bit of headroom),
+ * filtered and written back, so the rest of the pipeline does not change.
+ */
+static void scope_filter(uint16_t *bank)
 {
-    int chan_count = 0;
-    enum adc_channel_num_t adc_chans[2];
-    uint32_t fsampling;
+	uint32_t count = adc_buffer_size / adc_active_channels;
 
-    io_configure(IO_ADC);
+	for (uint32_t chan_cnt = 0; chan_cnt < adc_active_channels; chan_cnt++)
+	{
+		uint16_t *samples = bank + chan_cnt;
 
-    switch (menu_scope_channels.val) {
-        case 0: /* channel 1 */
-            chan_count = 1;
-            adc_chans[0] = ADC_CHANNEL_3;
-            break;
-        case 1: /* channel 2 */
-            chan_count = 1;
-            adc_chans[0] = ADC_CHANNEL_9;
-            break;
-        case 2: /* channel 1&2 */
-            chan_count = 2;
-            adc_chans[0] = ADC_CHANNEL_3;
-            adc_chans[1] = ADC_CHANNEL_9;
-            break;
-    }
+		for (uint32_t i = 0; i < count; i++)
+			filter_work[i] = ((int32_t) (samples[i * adc_active_channels] & ADC_LCDR_LDATA_Msk)
+					- (MAX_DIGITAL + 1) / 2) << 3;
 
-    switch (menu_scope_fsampling.val) {
-        default: /* fall-through */
-        case 0: fsampling = 1000000; break;
-        case 1: fsampling = 500000; break;
-        case 2: fsampling = 200000; break;
-        case 3: fsampling = 100000; break;
-        case 4: fsampling = 50000; break;
-    }
+		filter_process(&scope_filters[chan_cnt], filter_work, count);
 
-    scope_configure(adc_chans, chan_count, fsampling);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			int32_t val = (filter_work[i] >> 3) + (MAX_DIGITAL + 1) / 2;
+			uint16_t *sample = &samples[i * adc_active_channels];
 
-#if 0
-    /* for some reason, the code below does not affect the acquired data */
-    for (int i = 0; i < chan_count; ++i) {
-        /* adding 1 to the value selected in the gain menu
-         * corresponds to the selected gain value
-         * (menu 0 => gain x1, menu 1 => gain x2, menu 2 => gain x4) */
-        adc_set_channel_input_gain(ADC, adc_chans[i], menu_scope_gain.val + 1);
-        adc_disable_channel_input_offset(ADC, adc_chans[i]);
-    }
-#endif
+			val = __USAT(val, 12);  /* keep the channel tag */
+			*sample = (*sample & ~ADC_LCDR_LDATA_Msk) | val;
+		}
+	}
+}
 
-    while(btn_state() != BUT_LEFT) {
-        scope_draw();
+
+/**
+ * \brief Unpacks two channels from an acquired bank to the channel buffers.
+ *
+ * The ADC sequencer converts the channels alternately, so every word holds
+ * a sample of the first channel in the lower halfword and a sample of
+ * the second one in the upper halfword.
+ */
+static void scope_deinterleave(const uint16_t *bank)
+{
+	/* the bank and the channel buffers are word aligned */
+	const uint32_t *words = (const void*) bank;
+	uint32_t *ch0 = (void*) adc_channels[0].buffer;
+	uint32_t *ch1 = (void*) adc_channels[1].buffer;
+
+	for (uint32_t i = 0; i < adc_buffer_size / 4; i++)
+	{
+		uint32_t w0 = ADCC_DATA2(words[2 * i]);
+		uint32_t w1 = ADCC_DATA2(words[2 * i + 1]);
+
+		ch0[i] = __PKHBT(w0, w1, 16);
+		ch1[i] = __PKHTB(w1, w0, 16);
+	}
+}
+
+
+/**
+ * \brief Converts channel samples to pixels, starting from the trigger point.
+ *
+ * \param chan_cnt The channel index.
+ * \param samples The channel samples (may be the channel buffer itself).
+ * \param count Number of samples.
+ * \return Number of samples stored in the channel buffer.
+ */
+static uint32_t scope_trigger(uint32_t chan_cnt, const uint16_t *samples, uint32_t count)
+{
+	struct adc_ch *ch = &adc_channels[chan_cnt];
+	uint32_t i, end;
+
+	ch->draw_buffer = ch->buffer;
+
+	/* Check if sample is above threshold - start to draw from here */
+	for (i = 0; i < count; i++)
+	{
+		ch->buffer[i] = ADCC_DATA(samples[i])*RESOLUTION(adc_pages_per_channel) + ch->offset_pixels;
+
+		if (ch->buffer[i] >= ch->threshold)
+			break;
+	}
+
+	if (i == count)
+		return count;
+
+	/* convert only as many samples as can be displayed */
+	ch->draw_buffer = ch->buffer + i;
+	end = (count - i > LCD_WIDTH) ? i + LCD_WIDTH : count;
+
+	for (i++; i < end; i++)
+		ch->buffer[i] = ADCC_DATA(samples[i])*RESOLUTION(adc_pages_per_channel) + ch->offset_pixels;
+
+	return end;
+}
+
+
+/**
+ * \brief Splits an acquired bank into channel buffers (called from the ADC interrupt).
+ */
+static int scope_acq_finished(int buf_idx)
+{
+	uint16_t *bank = scope_banks[buf_idx].addr;
+	uint32_t counters[NUM_CHANNELS] = { 0, 0 };
+
+	/* filters need a continuous stream of samples */
+	if (filter_enabled)
+		scope_filter(bank);
+
+	/* peak detect has to process every bank */
+	if (acq_mode == ACQ_PEAK)
+	{
+		scope_peak_detect(bank);
+
+		if (meas_enabled && !adc_buffers_rdy)
+			scope_measure(bank, adc_buffer_size, adc_active_channels,
+					adcc_get_rate(), scope_meas);
+
+		return 0;
+	}
+
+	/* If previous buffer not processed yet - leave */
+	if(adc_buffers_rdy)
+		return 0;
+
+	if (adc_active_channels == 1)
+	{
+		counters[0] = scope_trigger(0, bank, adc_buffer_size);
+	}
+	else
+	{
+		scope_deinterleave(bank);
+		counters[0] = scope_trigger(0, adc_channels[0].buffer, adc_buffer_size / 2);
+		counters[1] = scope_trigger(1, adc_channels[1].buffer, adc_buffer_size / 2);
+	}
+
+	/* measurements use the complete bank */
+	if (meas_enabled)
+		scope_measure(bank, adc_buffer_size, adc_active_channels,
+				adcc_get_rate(), scope_meas);
+
+	if (acq_mode == ACQ_AVERAGE && !scope_average(bank, counters))
+		return 0;
+
+	adc_buffers_rdy = 1;
+
+	/* keep acquiring samples */
+	return 0;
+}
+
+
+/* Spectrum mode buffers:
+ * start                end                     description
+ * 0                    FFT_MAX_SIZE-1          fft_data (int16_t)
+ * FFT_MAX_SIZE*2       FFT_MAX_SIZE*3-1        fft_power_avg (uint32_t)
+ * FFT_MAX_SIZE*4       FFT_MAX_SIZE*5-1        fft_samples (PDC bank)
+ */
+static int16_t * const fft_data = (int16_t*) &buffer.u16[0];
+static uint32_t * const fft_power_avg = &buffer.u32[FFT_MAX_SIZE];
+static uint16_t * const fft_samples = &buffer.u16[4 * FFT_MAX_SIZE];
+
+/** Displayed dynamic range [dB] */
+#define SPECTRUM_RANGE      80
+/** Number of pixels available for the spectrum (the top page holds the text) */
+#define SPECTRUM_HEIGHT     (LCD_HEIGHT - LCD_PAGE_SIZE)
+
+static adcc_buffer_t spectrum_bank;
+static volatile int spectrum_rdy;
+
+static int spectrum_acq_finished(int buf_idx)
+{
+    spectrum_rdy = 1;
+
+    /* single shot */
+    return 1;
+}
+
+
+/**
+ * \brief Strips the channel tags and converts the acquired samples to Q15,
+ * removing the DC component.
+ */
+static void spectrum_load(unsigned int size)
+{
+    uint32_t sum = 0;
+    int32_t mean;
+
+    for (unsigned int i = 0; i < size; i++)
+        sum += fft_samples[i] & ADC_LCDR_LDATA_Msk;
+
+    mean = sum / size;
+
+    for (unsigned int i = 0; i < size; i++)
+        fft_data[i] = ((int32_t) (fft_samples[i] & ADC_LCDR_LDATA_Msk) - mean) << 4;
+}
+
+
+static void spectrum_draw(unsigned int bins, fft_window_t window,
+        uint32_t fsampling, uint32_t cycles)
+{
+    unsigned int bins_per_col = bins / LCD_WIDTH;
+    unsigned int peak_bin = 1;
+    char text[24];
+
+    SSD1306_clearBufferFull();
+
+    for (unsigned int x = 0; x < LCD_WIDTH; x++)
+    {
+        uint32_t power = 0;
+        int height;
+
+        /* show the strongest bin in the column */
+        for (unsigned int k = x * bins_per_col; k < (x + 1) * bins_per_col; k++)
+        {
+            if (fft_power_avg[k] > power)
+                power = fft_power_avg[k];
+
+            /* skip the DC bin when looking for the peak */
+            if (k > 0 && fft_power_avg[k] > fft_power_avg[peak_bin])
+                peak_bin = k;
+        }
+
+        height = (fft_power_db(power, window) + SPECTRUM_RANGE * FFT_DB_SCALE)
+                * SPECTRUM_HEIGHT / (SPECTRUM_RANGE * FFT_DB_SCALE);
+
+        if (height <= 0)
+            continue;
+
+        if (height > SPECTRUM_HEIGHT)
+            height = SPECTRUM_HEIGHT;
+
+        SSD1306_setLine(x, LCD_HEIGHT - height, x, LCD_HEIGHT - 1, WHITE);
     }
 
-    while(btn_state());    /* wait for the button release */
+    /* peak frequency and processing time */
+    sprintf(text, "%lu Hz %lu cyc", peak_bin * fsampling / (2 * bins), cycles);
+    SSD1306_setString(0, 0, text, strlen(text), WHITE);
+
+    SSD1306_drawBufferDMA();
+}
+
+
+/**
+ * \brief Runs the spectrum analyzer until the left button is pressed.
+ *
+ * \param channel is the analyzed channel.
+ * \param fsampling is the sampling frequency.
+ */
+static void scope_spectrum(enum adc_channel_num_t channel, uint32_t fsampling)
+{
+    const unsigned int avg_shifts[] = { 0, 2, 4 };
+    unsigned int size = 256 << menu_scope_fft_size.val;
+    fft_window_t window = (fft_window_t) menu_scope_fft_window.val;
+    unsigned int avg_shift = avg_shifts[menu_scope_fft_avg.val];
+
+    if (!adcc_configure(&channel, 1, fsampling))
+        return;
+
+    /* the cycle counter measures the processing time */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    spectrum_bank.addr = fft_samples;
+    spectrum_bank.size = size;
+    spectrum_bank.last = 1;
+    adcc_set_handler(spectrum_acq_finished);
+
+    memset(fft_power_avg, 0, size / 2 * sizeof(*fft_power_avg));
+    spectrum_rdy = 0;
+    adcc_start(&spectrum_bank, 1);
+
+    while (btn_state() != BUT_LEFT)
+    {
+        uint32_t start;
+
+        if (!spectrum_rdy)
+            continue;
+
+        start = DWT->CYCCNT;
+        spectrum_load(size);
+
+        /* samples are copied, acquire the next frame during processing */
+        spectrum_rdy = 0;
+        adcc_start(&spectrum_bank, 1);
+
+        fft_window(fft_data, size, window);
+        fft_real(fft_data, size);
+        fft_power(fft_data, fft_power_avg, size / 2, avg_shift);
+
+        spectrum_draw(size / 2, window, adcc_get_rate(), DWT->CYCCNT - start);
+    }
+
+    adcc_stop();
+}
+
+
+/* Roll mode: every PDC bank becomes a display column. The columns are
+ * shifted in the buffer and the screen is redrawn as often as the display
+ * transfers allow. The SSD1306 hardware scrolling is not used, as the display
+ * memory must not be written while scrolling. */
+#define ROLL_SAMPLES_PER_COL    64
+
+static adcc_buffer_t roll_banks[SCOPE_BANKS];
+static volatile uint32_t roll_produced;
+static volatile uint32_t roll_min, roll_max;
+
+static int roll_acq_finished(int buf_idx)
+{
+	/* banks are word aligned, samples are processed in pairs */
+	const uint32_t *words = (const void*) roll_banks[buf_idx].addr;
+	uint32_t min = 0x0fff0fff, max = 0;
+
+	for (uint32_t i = 0; i < roll_banks[buf_idx].size / 2; i++)
+	{
+		uint32_t word = ADCC_DATA2(words[i]);     /* strip channel tags */
+
+		__USUB16(word, min);
+		min = __SEL(min, word);
+		__USUB16(word, max);
+		max = __SEL(word, max);
+	}
+
+	roll_min = min;
+	roll_max = max;
+	++roll_produced;
+
+	/* keep acquiring samples */
+	return 0;
+}
+
+
+/**
+ * \brief Draws min-max lines of the acquired channels in a display column.
+ */
+static void roll_column(uint8_t *column, uint32_t channels)
+{
+	uint32_t min = roll_min, max = roll_max;
+
+	memset(column, 0, LCD_PAGES);
+
+	for (uint32_t chan_cnt = 0; chan_cnt < channels; chan_cnt++)
+	{
+		/* the same layout as in the waveform mode */
+		uint32_t pages = LCD_PAGES / channels;
+		uint32_t offset = (channels == 2 && chan_cnt == 0) ? LCD_HEIGHT / 2 : 0;
+		uint32_t y0 = scope_unpack_min(min, chan_cnt, channels)*RESOLUTION(pages) + offset;
+		uint32_t y1 = scope_unpack_max(max, chan_cnt, channels)*RESOLUTION(pages) + offset;
+
+		for (uint32_t y = y0; y <= y1; y++)
+			column[y / LCD_PAGE_SIZE] |= 1 << (y % LCD_PAGE_SIZE);
+	}
+}
+
+
+/**
+ * \brief Runs the roll mode until the left button is pressed.
+ *
+ * \param adc_ch The pointer of channels names array.
+ * \param ul_size Number of channels.
+ */
+static void scope_roll(enum adc_channel_num_t *adc_ch, uint32_t ul_size)
+{
+	/* a new column every n display frames */
+	static const uint16_t frames[] = { 2, 5, 25, 64, 256 };
+	uint32_t consumed = 0, col = 0, drawn = 0;
+
+	if (!adcc_configure(adc_ch, ul_size,
+				LCD_FRAME_RATE * ROLL_SAMPLES_PER_COL / frames[menu_scope_roll.val]))
+		return;
+
+	for (int i = 0; i < SCOPE_BANKS; i++)
+	{
+		roll_banks[i].addr = us_value + i * ROLL_SAMPLES_PER_COL * ul_size;
+		roll_banks[i].size = ROLL_SAMPLES_PER_COL * ul_size;
+		roll_banks[i].last = 0;
+	}
+
+	memset(roll_history, 0, LCD_WIDTH * LCD_PAGES);
+	SSD1306_clearBufferFull();
+	SSD1306_drawBuffer();
+
+	roll_produced = 0;
+	adcc_set_handler(roll_acq_finished);
+	adcc_start(roll_banks, SCOPE_BANKS);
+
+	while (btn_state() != BUT_LEFT)
+	{
+		/* every bank is a column, the history is drawn oldest first
+		 * whenever the previous frame has been sent */
+		while (consumed != roll_produced)
+		{
+			++consumed;
+			roll_column(&roll_history[(col % LCD_WIDTH) * LCD_PAGES], ul_size);
+			++col;
+		}
+
+		if (drawn == col || SSD1306_isBusy())
+			continue;
+
+		/* columns acquired while drawing are shown in the next frame */
+		drawn = col;
+
+		for (int i = 0; i < LCD_WIDTH; i++)
+			SSD1306_setColumn(i, &roll_history[((col + i) % LCD_WIDTH) * LCD_PAGES]);
+
+		SSD1306_drawBufferDMA();
+	}
+
+	adcc_stop();
+	while (SSD1306_isBusy());
+}
+
+
+/* Equivalent-time sampling: a periodic signal is sampled at the regular rate,
+ * but the edges of its copy connected to the PA26 logic input are timestamped
+ * with the same timer clock. Every sample is then placed in a bin by its
+ * phase within the signal period, and the sampling phase is shifted between
+ * acquisitions, so the bins are filled with a resolution up to one timer tick
+ * (16.7 ns). */
+#define ETS_SAMPLES         256
+/** Number of bins per signal period; the display shows two periods */
+#define ETS_BINS            (LCD_WIDTH / 2)
+/** Number of acquisitions per displayed frame */
+#define ETS_ACQS            16
+/** Sampling phase increment between acquisitions, coprime with the period */
+#define ETS_PHASE_STEP      7
+#define ETS_RATE            1000000
+
+static uint32_t * const ets_sum = &buffer.u32[SCOPE_BUFFER_SIZE * 3];
+static uint32_t * const ets_cnt = &buffer.u32[SCOPE_BUFFER_SIZE * 3 + ETS_BINS];
+static uint16_t * const ets_value = (uint16_t*) &buffer.u32[SCOPE_BUFFER_SIZE * 3 + 2 * ETS_BINS];
+
+static adcc_buffer_t ets_bank;
+
+static int ets_acq_finished(int buf_idx)
+{
+    /* single shot */
+    return 1;
+}
+
+
+/**
+ * \brief Adds samples of an acquisition to the phase bins.
+ *
+ * \param phase is the time of the first sample [ticks].
+ * \param edge is the time of a trigger signal rising edge [ticks].
+ * \param period is the trigger signal period [ticks].
+ */
+static void ets_bin(uint32_t phase, uint32_t edge, uint32_t period)
+{
+    uint32_t sample_period = adcc_get_ets_period();
+    /* shift the time origin to the edge, keeping it non-negative */
+    uint32_t t = phase + period * (edge / period + 1) - edge;
+
+    for (unsigned int i = 0; i < ETS_SAMPLES; i++, t += sample_period)
+    {
+        uint32_t bin = (t % period) * ETS_BINS / period;
+
+        ets_sum[bin] += us_value[i] & ADC_LCDR_LDATA_Msk;
+        ets_cnt[bin]++;
+    }
+}
+
+
+static void ets_draw(uint32_t period)
+{
+    uint32_t clock = adcc_get_ets_clock();
+    uint32_t prev_y = 0;
+    char text[24];
+
+    SSD1306_clearBufferFull();
+
+    if (period == 0)
+    {
+        sprintf(text, "No trigger on PA26");
+        SSD1306_setString(0, 0, text, strlen(text), WHITE);
+        SSD1306_drawBufferDMA();
+        return;
+    }
+
+    for (unsigned int x = 0; x < LCD_WIDTH; x++)
+    {
+        unsigned int bin = x % ETS_BINS;
+        uint32_t y;
+
+        /* empty bins keep the value from the previous frame */
+        if (ets_cnt[bin])
+            ets_value[bin] = ets_sum[bin] / ets_cnt[bin];
+
+        y = ets_value[bin] * RESOLUTION(LCD_PAGES - 1) + LCD_PAGE_SIZE;
+
+        if (x == 0)
+            SSD1306_setPixel(x, y, 1);
+        else
+            SSD1306_setLine(x - 1, prev_y, x, y, WHITE);
+
+        prev_y = y;
+    }
+
+    /* trigger signal frequency and the equivalent sampling rate,
+     * limited by the time base resolution */
+    sprintf(text, "%lu kHz %lu MS/s", clock / period / 1000,
+            (period < ETS_BINS ? clock : clock / period * ETS_BINS) / 1000000);
+    SSD1306_setString(0, 0, text, strlen(text), WHITE);
+
+    SSD1306_drawBufferDMA();
+}
+
+
+/**
+ * \brief Runs the equivalent-time sampling until the left button is pressed.
+ *
+ * \param channel is the sampled channel.
+ */
+static void scope_ets(enum adc_channel_num_t channel)
+{
+    uint32_t phase = 0;
+
+    if (!adcc_configure_ets(channel, ETS_RATE))
+    {
+        /* the signal generator occupies the edge capture timer */
+        SSD1306_clearBufferFull();
+        SSD1306_setString(0, 0, "Stop the generator", 18, WHITE);
+        SSD1306_drawBufferDMA();
+        while (btn_state() != BUT_LEFT);
+        return;
+    }
+
+    ets_bank.addr = us_value;
+    ets_bank.size = ETS_SAMPLES;
+    ets_bank.last = 1;
+    adcc_set_handler(ets_acq_finished);
+
+    memset(ets_value, 0, ETS_BINS * sizeof(*ets_value));
+
+    while (btn_state() != BUT_LEFT)
+    {
+        uint32_t period = 0;
+
+        memset(ets_sum, 0, ETS_BINS * sizeof(*ets_sum));
+        memset(ets_cnt, 0, ETS_BINS * sizeof(*ets_cnt));
+
+        for (int acq = 0; acq < ETS_ACQS; acq++)
+        {
+            uint32_t edge, first = adcc_start_ets(&ets_bank, phase);
+
+            phase += ETS_PHASE_STEP;
+            while (adcc_busy());
+
+            /* signals slower than the acquisition have no two edges captured */
+            if (adcc_get_ets_edges(&edge, &period))
+                ets_bin(first, edge, period);
+        }
+
+        ets_draw(period);
+    }
+
+    adcc_stop();
+}
+
+
+/* High resolution mode: oversampling and decimation of slow signals. Every
+ * PDC bank is reduced in the interrupt handler, only the latest result and
+ * the range since the last display refresh are kept. */
+#define HIRES_RATE              (ADCC_MAX_RATE / 4)
+/** Display refresh rate [Hz] */
+#define HIRES_REFRESH           10
+
+static adcc_buffer_t hires_banks[SCOPE_BANKS];
+static uint32_t hires_bits, hires_channels;
+static volatile uint32_t hires_produced;
+static volatile int hires_reset;
+static volatile uint32_t hires_last[NUM_CHANNELS];
+static volatile uint32_t hires_min[NUM_CHANNELS], hires_max[NUM_CHANNELS];
+
+static int hires_acq_finished(int buf_idx)
+{
+    static uint16_t values[OVS_BANK_SAMPLES / 4];
+    uint32_t count = ovs_reduce(hires_banks[buf_idx].addr, hires_banks[buf_idx].size,
+            hires_channels, hires_bits, values);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t chan = i % hires_channels;
+        uint32_t value = values[i];
+
+        if (hires_reset || value < hires_min[chan])
+            hires_min[chan] = value;
+
+        if (hires_reset || value > hires_max[chan])
+            hires_max[chan] = value;
+
+        hires_last[chan] = value;
+
+        if (chan == hires_channels - 1)
+            hires_reset = 0;
+    }
+
+    ++hires_produced;
+
+    /* keep acquiring samples */
+    return 0;
+}
+
+
+/* Converts a high resolution result to microvolts */
+static uint32_t hires_to_uv(uint32_t value)
+{
+    return (uint64_t) value * VOLT_REF * 1000 / (MAX_DIGITAL << hires_bits);
+}
+
+
+static void hires_draw(void)
+{
+    char text[24];
+    int len;
+
+    SSD1306_clearBufferFull();
+
+    len = sprintf(text, "%lu bit, %lu S/s", 12 + hires_bits,
+            adcc_get_rate() >> (2 * hires_bits));
+    SSD1306_setString(0, 0, text, len, WHITE);
+
+    for (uint32_t chan = 0; chan < hires_channels; chan++)
+    {
+        uint32_t uv = hires_to_uv(hires_last[chan]);
+
+        len = sprintf(text, "%lu.%05lu V", uv / 1000000, (uv % 1000000) / 10);
+        SSD1306_setTextFont(0, (1 + 3 * chan) * LCD_PAGE_SIZE, text, len,
+                &sans16, WHITE);
+        len = sprintf(text, "p-p %lu uV",
+                hires_to_uv(hires_max[chan]) - hires_to_uv(hires_min[chan]));
+        SSD1306_setString(0, 3 + 3 * chan, text, len, WHITE);
+    }
+
+    SSD1306_drawBufferDMA();
+}
+
+
+/**
+ * \brief Runs the high resolution mode until the left button is pressed.
+ *
+ * \param adc_ch The pointer of channels names array.
+ * \param ul_size Number of channels.
+ */
+static void scope_hires(enum adc_channel_num_t *adc_ch, uint32_t ul_size)
+{
+    uint32_t consumed = 0;
+
+    hires_bits = OVS_MIN_BITS + menu_scope_hires.val;
+    hires_channels = ul_size;
+
+    if (!adcc_configure(adc_ch, ul_size, HIRES_RATE / ul_size))
+        return;
+
+    for (int i = 0; i < SCOPE_BANKS; i++)
+    {
+        hires_banks[i].addr = us_value + i * OVS_BANK_SAMPLES;
+        hires_banks[i].size = OVS_BANK_SAMPLES;
+        hires_banks[i].last = 0;
+    }
+
+    hires_produced = 0;
+    hires_reset = 1;
+    adcc_set_handler(hires_acq_finished);
+    adcc_start(hires_banks, SCOPE_BANKS);
+
+    while (btn_state() != BUT_LEFT)
+    {
+        if (hires_produced - consumed < HIRES_RATE / OVS_BANK_SAMPLES / HIRES_REFRESH)
+            continue;
+
+        consumed = hires_produced;
+
+        hires_draw();
+        hires_reset = 1;
+    }
+
+    adcc_stop();
+}
+
+
+void app_scope_func(void)
+{
+    int chan_count = 0;
+    enum adc_channel_num_t adc_chans[2];
+    uint32_t fsampling;
+
+    io_configure(IO_ADC);
+
+    switch (menu_scope_channels.val) {
+        case 0: /* channel 1 */
+            chan_count = 1;
+            adc_chans[0] = ADC_CHANNEL_3;
+            break;
+        case 1: /* channel 2 */
+            chan_count = 1;
+            adc_chans[0] = ADC_CHANNEL_9;
+            break;
+        case 2: /* channel 1&2 */
+            chan_count = 2;
+            adc_chans[0] = ADC_CHANNEL_3;
+            adc_chans[1] = ADC_CHANNEL_9;
+            break;
+    }
+
+    switch (menu_scope_fsampling.val) {
+        default: /* fall-through */
+        case 0: fsampling = 1000000; break;
+        case 1: fsampling = 500000; break;
+        case 2: fsampling = 200000; break;
+        case 3: fsampling = 100000; break;
+        case 4: fsampling = 50000; break;
+        case 5: fsampling = 20000; break;
+        case 6: fsampling = 10000; break;
+        case 7: fsampling = 5000; break;
+        case 8: fsampling = 2000; break;
+        case 9: fsampling = 1000; break;
+    }
+
+    switch (menu_scope_filter.val) {
+        default: /* fall-through */
+        case 0: filter_type = FILTER_NONE; break;
+        case 1: filter_type = FILTER_LOWPASS; break;
+        case 2: filter_type = FILTER_HIGHPASS; break;
+        case 3: filter_type = FILTER_NOTCH_50HZ; break;
+        case 4: filter_type = FILTER_NOTCH_60HZ; break;
+    }
+
+    switch (menu_scope_acq.val) {
+        default: /* fall-through */
+        case 0: acq_mode = ACQ_NORMAL; acq_factor = 1; break;
+        case 1: acq_mode = ACQ_PEAK; break;    /* factor depends on fsampling */
+        case 2: acq_mode = ACQ_AVERAGE; acq_factor = 4; break;
+        case 3: acq_mode = ACQ_AVERAGE; acq_factor = 16; break;
+    }
+
+    if (menu_scope_mode.val == 1) {
+        /* spectrum analyzer shows the first selected channel */
+        scope_spectrum(adc_chans[0], fsampling);
+        while(btn_state());    /* wait for the button release */
+        return;
+    }
+
+    if (menu_scope_mode.val == 2) {
+        /* sampling frequency depends on the roll speed */
+        scope_roll(adc_chans, chan_count);
+        while(btn_state());    /* wait for the button release */
+        return;
+    }
+
+    if (menu_scope_mode.val == 3) {
+        /* equivalent-time sampling uses the first selected channel */
+        scope_ets(adc_chans[0]);
+        while(btn_state());    /* wait for the button release */
+        return;
+    }
+
+    if (menu_scope_mode.val == 4) {
+        /* fixed conversion rate, the resolution is selected in the menu */
+        scope_hires(adc_chans, chan_count);
+        while(btn_state());    /* wait for the button release */
+        return;
+    }
+
+    meas_enabled = menu_scope_meas.val;
+    persist_enabled = menu_scope_persist.val;
+
+    if (persist_enabled) {
+        /* short or long persistence */
+        persist_init(persist_counters, persist_enabled == 1 ? 2 : 5);
+        memset(persist_meas, 0, sizeof(persist_meas));
+    }
+
+    scope_configure(adc_chans, chan_count, fsampling);
+
+#if 0
+    /* for some reason, the code below does not affect the acquired data */
+    for (int i = 0; i < chan_count; ++i) {
+        /* adding 1 to the value selected in the gain menu
+         * corresponds to the selected gain value
+         * (menu 0 => gain x1, menu 1 => gain x2, menu 2 => gain x4) */
+        adc_set_channel_input_gain(ADC, adc_chans[i], menu_scope_gain.val + 1);
+        adc_disable_channel_input_offset(ADC, adc_chans[i]);
+    }
+#endif
+
+    while(btn_state() != BUT_LEFT) {
+        scope_draw();
+    }
+
+    adcc_stop();
+    while(btn_state());    /* wait for the button release */
+}
+
+
+/* Streaming to the host reuses the general buffer as a ring of PDC banks.
+ * Each bank is packed to the staging area placed after the ring, which
+ * starts with a header (sample count, sequence number). The PDC keeps
+ * filling the ring while the staging area is being sent, so a USB stall
+ * cannot corrupt the sent data. */
+#define STREAM_BANKS            7
+#define STREAM_BANK_STRIDE      (BUFFER_SIZE / 2 / (STREAM_BANKS + 1))
+#define STREAM_HEADER           2
+#define STREAM_BANK_SAMPLES     (STREAM_BANK_STRIDE - STREAM_HEADER)
+
+static adcc_buffer_t stream_banks[STREAM_BANKS];
+static volatile uint32_t stream_produced;
+
+static int stream_acq_finished(int buf_idx)
+{
+    ++stream_produced;
+
+    /* keep acquiring samples */
+    return 0;
+}
+
+
+/**
+ * \brief Packs 12-bit samples (2 samples -> 3 bytes) and strips channel tags.
+ *
+ * Packing may be done in place: the output never overtakes the input.
+ * \param samples is the buffer to be packed.
+ * \param count is the number of samples (must be even).
+ * \param dst is the output buffer (might be the samples buffer).
+ * \return Number of bytes after packing.
+ */
+static uint32_t adc_pack12(const uint16_t *samples, uint32_t count, void *dst_buf)
+{
+    /* banks are word aligned, samples are read in pairs */
+    const uint32_t *src = (const void*) samples;
+    uint8_t *dst = (uint8_t*) dst_buf;
+
+    for (uint32_t i = 0; i < count / 2; ++i) {
+        uint32_t word = *src++;     /* the earlier sample in the lower half */
+        uint32_t a = word & ADC_LCDR_LDATA_Msk;
+        uint32_t b = (word >> 16) & ADC_LCDR_LDATA_Msk;
+
+        *dst++ = a;
+        *dst++ = (a >> 8) | (b << 4);
+        *dst++ = b >> 4;
+    }
+
+    return count / 2 * 3;
+}
+
+
+/**
+ * \brief Sends a bank of samples to the host.
+ * \param seq is the bank sequence number.
+ * \return 1 if the bank has been sent, 0 if it has been overwritten by
+ * the PDC while packing (the bank is dropped then).
+ */
+static int adc_stream_send(uint32_t seq)
+{
+    uint16_t *staging = &buffer.u16[STREAM_BANKS * STREAM_BANK_STRIDE];
+    uint32_t len = adc_pack12(stream_banks[seq % STREAM_BANKS].addr,
+            STREAM_BANK_SAMPLES, staging + STREAM_HEADER);
+
+    /* the PDC starts overwriting the bank once it has completed
+     * STREAM_BANKS - 1 banks following it; it moves to the next bank
+     * before the interrupt increments stream_produced, hence one more
+     * bank of margin */
+    if (stream_produced - seq > STREAM_BANKS - 2)
+        return 0;
+
+    staging[0] = STREAM_BANK_SAMPLES;
+    staging[1] = seq;
+    udi_cdc_write_buf(staging, STREAM_HEADER * 2 + len);
+
+    return 1;
+}
+
+
+/* Converts a channel mask (bit 0: channel 1, bit 1: channel 2) to ADC channels */
+static int adc_mask_to_channels(uint8_t mask, enum adc_channel_num_t *chans)
+{
+    int count = 0;
+
+    if (mask & 0x01) chans[count++] = ADC_CHANNEL_3;
+    if (mask & 0x02) chans[count++] = ADC_CHANNEL_9;
+
+    return count;
+}
+
+
+/* Reads a 32-bit command parameter (big endian) */
+static uint32_t cmd_read_u32(const uint8_t *data)
+{
+    return ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16)
+            | ((uint32_t) data[2] << 8) | data[3];
+}
+
+
+static void adc_stream(const uint8_t *data_in)
+{
+    enum adc_channel_num_t chans[NUM_CHANNELS];
+    int chan_count = adc_mask_to_channels(data_in[1], chans);
+    uint32_t rate = cmd_read_u32(&data_in[2]);
+    uint32_t consumed = 0, overruns = 0;
+
+    io_configure(IO_ADC);
+
+    if (chan_count == 0 || !adcc_configure(chans, chan_count, rate)) {
+        cmd_resp_init(CMD_RESP_EXEC_ERR);
+        return;
+    }
+
+    for (int i = 0; i < STREAM_BANKS; ++i) {
+        stream_banks[i].addr = &buffer.u16[i * STREAM_BANK_STRIDE];
+        stream_banks[i].size = STREAM_BANK_SAMPLES;
+        stream_banks[i].last = 0;
+    }
+
+    stream_produced = 0;
+    adcc_set_handler(stream_acq_finished);
+    adcc_start(stream_banks, STREAM_BANKS);
+
+    /* any byte received from the host stops streaming */
+    while (!udi_cdc_is_rx_ready() && btn_state() != BUT_LEFT) {
+        uint32_t produced = stream_produced;
+
+        if (produced == consumed)
+            continue;
+
+        /* two banks are always owned by the PDC, older ones are overwritten */
+        if (produced - consumed > STREAM_BANKS - 2) {
+            overruns += produced - consumed - 1;
+            consumed = produced - 1;
+        }
+
+        if (!adc_stream_send(consumed))
+            ++overruns;
+
+        ++consumed;
+    }
+
+    adcc_stop();
+
+    if (udi_cdc_is_rx_ready()) {
+        udi_cdc_getc();
+    }
+
+    /* empty bank terminates the stream, then comes the usual response */
+    buffer.u16[0] = 0;
+    buffer.u16[1] = consumed;
+    udi_cdc_write_buf(buffer.u16, STREAM_HEADER * 2);
+
+    cmd_resp_init(CMD_RESP_OK);
+    cmd_resp_write_u32(adcc_get_rate());
+    cmd_resp_write_u32(overruns);
+}
+
+
+/** Number of samples (all channels together) acquired for measurements */
+#define MEAS_SAMPLES            4096
+
+static int measure_acq_finished(int buf_idx)
+{
+    /* single shot */
+    return 1;
+}
+
+
+static void adc_measure(const uint8_t *data_in)
+{
+    enum adc_channel_num_t chans[NUM_CHANNELS];
+    int chan_count = adc_mask_to_channels(data_in[1], chans);
+    uint32_t rate = cmd_read_u32(&data_in[2]);
+    adcc_buffer_t bank = { buffer.u16, MEAS_SAMPLES, 1 };
+    scope_meas_t meas[NUM_CHANNELS];
+
+    io_configure(IO_ADC);
+
+    if (chan_count == 0 || !adcc_configure(chans, chan_count, rate)) {
+        cmd_resp_init(CMD_RESP_EXEC_ERR);
+        return;
+    }
+
+    adcc_set_handler(measure_acq_finished);
+    adcc_start(&bank, 1);
+
+    while (adcc_busy()) {
+        if (btn_state() == BUT_LEFT) {
+            adcc_stop();
+            cmd_resp_init(CMD_RESP_EXEC_ERR);
+            return;
+        }
+    }
+
+    /* there is no previous acquisition, the first pass finds the crossing level */
+    memset(meas, 0, sizeof(meas));
+    scope_measure(bank.addr, MEAS_SAMPLES, chan_count, adcc_get_rate(), meas);
+    scope_measure(bank.addr, MEAS_SAMPLES, chan_count, adcc_get_rate(), meas);
+
+    cmd_resp_init(CMD_RESP_OK);
+
+    for (int i = 0; i < chan_count; ++i) {
+        cmd_resp_write(meas[i].vpp >> 8);
+        cmd_resp_write(meas[i].vpp);
+        cmd_resp_write(meas[i].mean >> 8);
+        cmd_resp_write(meas[i].mean);
+        cmd_resp_write(meas[i].rms >> 8);
+        cmd_resp_write(meas[i].rms);
+        cmd_resp_write_u32(meas[i].freq);
+        cmd_resp_write_u32(meas[i].period);
+    }
+}
+
+
+/** Largest block read (all channels together), the bank header comes first */
+#define READ_MAX_SAMPLES        (BUFFER_SIZE / 2 - STREAM_HEADER)
+
+/* Terminates a block read that has not acquired any samples */
+static void adc_read_failed(void)
+{
+    buffer.u16[0] = 0;
+    buffer.u16[1] = 0;
+    udi_cdc_write_buf(buffer.u16, STREAM_HEADER * 2);
+
+    cmd_resp_init(CMD_RESP_EXEC_ERR);
+}
+
+
+static void adc_read(const uint8_t *data_in)
+{
+    enum adc_channel_num_t chans[NUM_CHANNELS];
+    uint32_t chan_count = adc_mask_to_channels(data_in[1], chans);
+    uint32_t rate = cmd_read_u32(&data_in[2]);
+    uint32_t samples = cmd_read_u32(&data_in[6]);
+    adcc_buffer_t bank = { &buffer.u16[STREAM_HEADER], 0, 1 };
+    uint32_t count, len;
+
+    io_configure(IO_ADC);
+
+    if (chan_count == 0 || samples == 0 || samples > READ_MAX_SAMPLES / chan_count
+            || !adcc_configure(chans, chan_count, rate)) {
+        adc_read_failed();
+        return;
+    }
+
+    /* packing takes pairs of samples */
+    count = (samples * chan_count + 1) & ~1;
+    bank.size = count;
+
+    adcc_set_handler(measure_acq_finished);
+    adcc_start(&bank, 1);
+
+    /* any byte received from the host cancels the acquisition */
+    while (adcc_busy()) {
+        if (udi_cdc_is_rx_ready() || btn_state() == BUT_LEFT) {
+            adcc_stop();
+
+            if (udi_cdc_is_rx_ready()) {
+                udi_cdc_getc();
+            }
+
+            adc_read_failed();
+            return;
+        }
+    }
+
+    /* the whole record goes out as a single stream bank */
+    len = adc_pack12(bank.addr, count, bank.addr);
+    buffer.u16[0] = count;
+    buffer.u16[1] = 0;
+    udi_cdc_write_buf(buffer.u16, STREAM_HEADER * 2 + len);
+
+    cmd_resp_init(CMD_RESP_OK);
+    cmd_resp_write_u32(adcc_get_rate());
+}
+
+
+/* Oversampled reads: the PDC banks are placed at the end of the general
+ * buffer and reduced as they arrive, the results are stored in front */
+#define OVS_READ_BANKS          2
+#define OVS_READ_MAX            (BUFFER_SIZE / 2 - STREAM_HEADER - OVS_READ_BANKS * OVS_BANK_SAMPLES)
+
+static adcc_buffer_t ovs_banks[OVS_READ_BANKS];
+static uint32_t ovs_channels, ovs_bits;
+static uint32_t ovs_stored, ovs_requested;
+
+static int ovs_acq_finished(int buf_idx)
+{
+    static uint16_t values[OVS_BANK_SAMPLES / 4];
+    uint32_t count = ovs_reduce(ovs_banks[buf_idx].addr, ovs_banks[buf_idx].size,
+            ovs_channels, ovs_bits, values);
+
+    if (count > ovs_requested - ovs_stored)
+        count = ovs_requested - ovs_stored;
+
+    memcpy(&buffer.u16[STREAM_HEADER + ovs_stored], values, count * sizeof(*values));
+    ovs_stored += count;
+
+    return ovs_stored == ovs_requested;
+}
+
+
+static void adc_oversample(const uint8_t *data_in)
+{
+    enum adc_channel_num_t chans[NUM_CHANNELS];
+    uint32_t chan_count = adc_mask_to_channels(data_in[1], chans);
+    uint32_t rate = cmd_read_u32(&data_in[2]);
+    uint32_t bits = data_in[6];
+    uint32_t samples = cmd_read_u32(&data_in[7]);
+
+    io_configure(IO_ADC);
+
+    /* the output rate is checked first, so the conversion rate cannot overflow */
+    if (chan_count == 0 || bits < OVS_MIN_BITS || bits > OVS_MAX_BITS
+            || rate == 0 || rate > ADCC_MAX_RATE
+            || samples == 0 || samples > OVS_READ_MAX / chan_count
+            || !adcc_configure(chans, chan_count, rate << (2 * bits))) {
+        adc_read_failed();
+        return;
+    }
+
+    for (int i = 0; i < OVS_READ_BANKS; ++i) {
+        ovs_banks[i].addr = &buffer.u16[BUFFER_SIZE / 2 - (i + 1) * OVS_BANK_SAMPLES];
+        ovs_banks[i].size = OVS_BANK_SAMPLES;
+        ovs_banks[i].last = 0;
+    }
+
+    ovs_channels = chan_count;
+    ovs_bits = bits;
+    ovs_stored = 0;
+    ovs_requested = samples * chan_count;
+
+    adcc_set_handler(ovs_acq_finished);
+    adcc_start(ovs_banks, OVS_READ_BANKS);
+
+    /* any byte received from the host cancels the acquisition */
+    while (adcc_busy()) {
+        if (udi_cdc_is_rx_ready() || btn_state() == BUT_LEFT) {
+            adcc_stop();
+
+            if (udi_cdc_is_rx_ready()) {
+                udi_cdc_getc();
+            }
+
+            adc_read_failed();
+            return;
+        }
+    }
+
+    /* the results are not packed, the header carries their resolution */
+    buffer.u16[0] = ovs_requested;
+    buffer.u16[1] = 12 + bits;
+    udi_cdc_write_buf(buffer.u16, (STREAM_HEADER + ovs_requested) * 2);
+
+    cmd_resp_init(CMD_RESP_OK);
+    cmd_resp_write_u32(adcc_get_rate() >> (2 * bits));
+}
+
+
+void cmd_adc(const uint8_t* data_in, unsigned int input_len)
+{
+    switch (data_in[0]) {
+        case CMD_ADC_STREAM:
+            if (input_len < 6) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            adc_stream(data_in);
+            break;
+
+        case CMD_ADC_MEASURE:
+            if (input_len < 6) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            adc_measure(data_in);
+            break;
+
+        case CMD_ADC_MIXED:
+            if (input_len < 12) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            cmd_adc_mixed(data_in);
+            break;
+
+        case CMD_ADC_READ:
+            if (input_len < 10) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            adc_read(data_in);
+            break;
+
+        case CMD_ADC_OVERSAMPLE:
+            if (input_len < 11) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            adc_oversample(data_in);
+            break;
+
+        default:
+            cmd_resp_init(CMD_RESP_INVALID_CMD);
+            return;
+    }
 }
@@ -23,13 +23,6 @@
 #include <stdint.h>
 #include <adc.h>
 
-/** Tracking Time*/
-#define TRACKING_TIME			1
-/** Transfer Period */
-#define TRANSFER_PERIOD			1
-#define STARTUP_TIME			3
-/** Sample & Hold Time */
-#define SAMPLE_HOLD_TIME		6
 /** Total number of ADC channels in use */
 #define NUM_CHANNELS			2
 /** Size of the receive buffer and transmit buffer. */
@@ -38,8 +31,9 @@
 #define VOLT_REF				3300
 /** Maximum number of counts */
 #define MAX_DIGITAL				4095
-/** Number of pixels per count - to convert raw adc to number of pixels on the display*/
-#define RESOLUTION(PAGES)		(PAGES*8-1)/MAX_DIGITAL //optimize the pixels conversion?
+/** Number of pixels per count - to convert raw adc to number of pixels on the display.
+ * Not parenthesized as a whole, so "value * RESOLUTION(pages)" multiplies before dividing */
+#define RESOLUTION(PAGES)		((PAGES)*8-1)/MAX_DIGITAL //optimize the pixels conversion?
 /** Number of mV per count - to convert raw adc to voltage */
 #define V_RESOLUTION			VOLT_REF/MAX_DIGITAL
 
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "scope_meas.h"
+#include "scope.h"
+
+#include <compiler.h>
+
+/** Smallest peak-to-peak amplitude (ADC counts) to measure the frequency */
+#define MEAS_MIN_AMPLITUDE      32
+
+/* Rising edge detector, positions are stored in 1/256 of a sample */
+struct meas_crossing {
+    int32_t prev;
+    int32_t level;
+    int32_t low;
+    int armed;
+    uint32_t count;
+    uint32_t first;
+    uint32_t last;
+};
+
+
+static inline void meas_crossing(struct meas_crossing *c, int32_t sample,
+        uint32_t pos)
+{
+    if (sample < c->low) {
+        c->armed = 1;
+    } else if (c->armed && sample >= c->level) {
+        /* linear interpolation between the previous and the current sample */
+        uint32_t t = ((pos - 1) << 8)
+            + ((c->level - c->prev) << 8) / (sample - c->prev);
+
+        if (c->count++ == 0)
+            c->first = t;
+
+        c->last = t;
+        c->armed = 0;
+    }
+
+    c->prev = sample;
+}
+
+
+static uint32_t meas_isqrt(uint32_t val)
+{
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > val)
+        bit >>= 2;
+
+    while (bit) {
+        if (val >= res + bit) {
+            val -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+
+        bit >>= 2;
+    }
+
+    return res;
+}
+
+
+static void meas_finish(scope_meas_t *meas, struct meas_crossing *c,
+        uint32_t min, uint32_t max, uint32_t sum, uint64_t sum_sq,
+        uint32_t count, uint32_t fsampling)
+{
+    /* 3 fractional bits for the RMS value */
+    uint32_t rms = meas_isqrt(sum_sq * 64 / count);
+
+    meas->vpp = (max - min) * VOLT_REF / MAX_DIGITAL;
+    meas->mean = (uint64_t) sum * VOLT_REF / ((uint64_t) MAX_DIGITAL * count);
+    meas->rms = rms * VOLT_REF / (8 * MAX_DIGITAL);
+
+    if (c->count >= 2 && c->last > c->first) {
+        uint64_t span = c->last - c->first;     /* (count - 1) periods */
+
+        meas->freq = (uint64_t) fsampling * (c->count - 1) * 256 / span;
+        meas->period = span * (uint64_t) 1000000000UL
+            / ((uint64_t) fsampling * (c->count - 1) * 256);
+    } else {
+        meas->freq = 0;
+        meas->period = 0;
+    }
+
+    /* crossing level for the next acquisition */
+    if (max - min >= MEAS_MIN_AMPLITUDE) {
+        meas->level = (min + max) / 2;
+        meas->hyst = (max - min) / 8;
+    } else {
+        meas->level = 0;
+        meas->hyst = 0;
+    }
+}
+
+
+static void meas_crossing_init(struct meas_crossing *c, const scope_meas_t *meas)
+{
+    c->prev = 0;
+    c->level = meas->level;
+    c->low = (int32_t) meas->level - meas->hyst;
+    c->armed = 0;
+    c->count = 0;
+    c->first = 0;
+    c->last = 0;
+}
+
+
+void scope_measure(const uint16_t *samples, unsigned int count,
+        unsigned int channels, uint32_t fsampling, scope_meas_t *meas)
+{
+    /* two samples per word (the buffer is word aligned): lower half is
+     * processed first */
+    const uint32_t *words = (const void*) samples;
+    uint32_t min = 0x0fff0fff, max = 0;
+    uint32_t sum_lo = 0, sum_hi = 0;
+    uint64_t sum_sq_lo = 0, sum_sq_hi = 0;
+    struct meas_crossing cross[2];
+
+    meas_crossing_init(&cross[0], &meas[0]);
+
+    if (channels == 2)
+        meas_crossing_init(&cross[1], &meas[1]);
+
+    for (unsigned int i = 0; i < count / 2; ++i) {
+        uint32_t word = words[i] & 0x0fff0fff;  /* strip channel tags */
+
+        /* GE flags select the smaller/larger halfword */
+        __USUB16(word, min);
+        min = __SEL(min, word);
+        __USUB16(word, max);
+        max = __SEL(word, max);
+
+        sum_lo = __SMLAD(word, 0x00000001, sum_lo);
+        sum_hi = __SMLAD(word, 0x00010000, sum_hi);
+        sum_sq_lo = __SMLALD(word, word & 0x0000ffff, sum_sq_lo);
+        sum_sq_hi = __SMLALD(word, word & 0xffff0000, sum_sq_hi);
+
+        if (channels == 2) {
+            meas_crossing(&cross[0], word & 0xffff, i);
+            meas_crossing(&cross[1], word >> 16, i);
+        } else {
+            meas_crossing(&cross[0], word & 0xffff, 2 * i);
+            meas_crossing(&cross[0], word >> 16, 2 * i + 1);
+        }
+    }
+
+    if (channels == 2) {
+        meas_finish(&meas[0], &cross[0], min & 0xffff, max & 0xffff,
+                sum_lo, sum_sq_lo, count / 2, fsampling);
+        meas_finish(&meas[1], &cross[1], min >> 16, max >> 16,
+                sum_hi, sum_sq_hi, count / 2, fsampling);
+    } else {
+        uint32_t min_all = min & 0xffff, max_all = max & 0xffff;
+
+        if ((min >> 16) < min_all) min_all = min >> 16;
+        if ((max >> 16) > max_all) max_all = max >> 16;
+
+        meas_finish(&meas[0], &cross[0], min_all, max_all, sum_lo + sum_hi,
+                sum_sq_lo + sum_sq_hi, count, fsampling);
+    }
+}
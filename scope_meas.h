@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * Scope measurements (voltage levels, frequency) computed in a single pass
+ * over the acquired samples.
+ */
+
+#ifndef SCOPE_MEAS_H
+#define SCOPE_MEAS_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint16_t vpp;       ///< Peak-to-peak voltage [mV]
+    uint16_t mean;      ///< Average voltage [mV]
+    uint16_t rms;       ///< RMS voltage [mV]
+    uint32_t freq;      ///< Frequency [Hz], 0 if no period has been detected
+    uint32_t period;    ///< Period [ns], 0 if no period has been detected
+
+    /* Frequency is measured using crossings of the level found in the
+     * previous acquisition, so the results are available in one pass. */
+    uint16_t level;     ///< Crossing level (ADC counts), 0 to disable
+    uint16_t hyst;      ///< Crossing hysteresis (ADC counts)
+} scope_meas_t;
+
+/**
+ * Measures the acquired signal(s).
+ *
+ * Samples may contain ADC channel tags, they are masked out. When two channels
+ * are acquired, samples have to be interleaved (channel 1 first).
+ * @param samples is the acquired data (word aligned).
+ * @param count is the number of samples (all channels together, even).
+ * @param channels is the number of interleaved channels (1 or 2).
+ * @param fsampling is the sampling frequency (per channel) [Hz].
+ * @param meas are the results (one per channel). Crossing levels are used
+ * and then updated for the next acquisition.
+ */
+void scope_measure(const uint16_t *samples, unsigned int count,
+        unsigned int channels, uint32_t fsampling, scope_meas_t *meas);
+
+#endif /* SCOPE_MEAS_H */
@@ -0,0 +1,399 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+#
+# This source code is free software; you can redistribute it
+# and/or modify it in source code form under the terms of the GNU
+# General Public License as published by the Free Software
+# Foundation; either version 2 of the License, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+# Converts PBM images to C sources with bitmaps in the SSD1306 layout:
+# a byte holds 8 vertical pixels (LSB at the top), bytes make rows of
+# 8 pixel high pages. Black PBM pixels are off, white ones are lit, so
+# the images look the same as on the display.
+#
+# RLE compressed data is a sequence of blocks starting with a header byte:
+#   0x00-0x7f: (header + 1) literal bytes follow
+#   0x80-0xff: the next byte is repeated (header - 0x80 + 2) times
+#
+# Font sources (.font) are text files with a few directives followed by
+# glyphs ('#' lit pixel, '.' unlit pixel, one line per row):
+#   height <pixels>     glyph height, a multiple of 8
+#   spacing <columns>   gap between glyphs
+#   inverted            emit inverted glyphs as well (for highlighted text)
+#   autokern            find kerning pairs for letters, full stops and commas
+#   kern <a> <b> <n>    adjusts the gap between characters a and b
+#   char <c or 0xNN>    starts a glyph, 'height' rows follow
+# Lines starting with '#' outside glyphs are comments. Glyphs are stored
+# like bitmaps (pages of column bytes), each glyph has its own width.
+
+import argparse
+import os
+import sys
+
+RLE_MAX_LITERAL = 0x80
+RLE_MAX_RUN = 0x81
+
+HEADER = """/*
+ * Generated by scripts/gfx_convert.py from the images and fonts
+ * directories, do not edit.
+ */
+"""
+
+
+def read_pbm(path):
+    """Returns (width, height, rows), rows contain 1 for black pixels."""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    # header tokens, comments start with '#'
+    tokens = []
+    pos = 0
+
+    while len(tokens) < 3:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+
+        if data[pos:pos + 1] == b'#':
+            pos = data.index(b'\n', pos)
+            continue
+
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+
+        tokens.append(data[start:pos].decode('ascii'))
+
+    magic, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+
+    if magic == 'P1':
+        bits = [int(c) for c in data[pos:].decode('ascii') if c in '01']
+        rows = [bits[y * width:(y + 1) * width] for y in range(height)]
+    elif magic == 'P4':
+        # a single whitespace separates the header from the raster
+        pos += 1
+        stride = (width + 7) // 8
+        rows = []
+
+        for y in range(height):
+            line = data[pos + y * stride:pos + (y + 1) * stride]
+            rows.append([(line[x // 8] >> (7 - x % 8)) & 1 for x in range(width)])
+    else:
+        raise ValueError('%s: unsupported format %s (P1 or P4 expected)' % (path, magic))
+
+    if len(rows) != height or any(len(r) != width for r in rows):
+        raise ValueError('%s: truncated image' % path)
+
+    return width, height, rows
+
+
+def to_pages(width, height, rows):
+    """Converts image rows to the display layout."""
+    out = bytearray()
+
+    for page in range((height + 7) // 8):
+        for x in range(width):
+            byte = 0
+
+            for bit in range(8):
+                y = page * 8 + bit
+
+                if y < height and not rows[y][x]:
+                    byte |= 1 << bit
+
+            out.append(byte)
+
+    return bytes(out)
+
+
+def rle_encode(data):
+    out = bytearray()
+    literal = bytearray()
+    i = 0
+
+    def flush():
+        while literal:
+            chunk = literal[:RLE_MAX_LITERAL]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+            del literal[:len(chunk)]
+
+    while i < len(data):
+        run = 1
+
+        while i + run < len(data) and data[i + run] == data[i] and run < RLE_MAX_RUN:
+            run += 1
+
+        # two byte runs cost the same as literals, unless they break one
+        if run >= 3 or (run == 2 and not literal):
+            flush()
+            out.append(0x80 + run - 2)
+            out.append(data[i])
+        else:
+            literal.extend(data[i:i + run])
+
+        i += run
+
+    flush()
+    return bytes(out)
+
+
+def rle_decode(data):
+    out = bytearray()
+    i = 0
+
+    while i < len(data):
+        header = data[i]
+
+        if header < 0x80:
+            out.extend(data[i + 1:i + 2 + header])
+            i += header + 2
+        else:
+            out.extend(bytes([data[i + 1]]) * (header - 0x80 + 2))
+            i += 2
+
+    return bytes(out)
+
+
+def c_array(data, indent='    ', fmt='0x%02x', per_line=16):
+    lines = []
+
+    for i in range(0, len(data), per_line):
+        lines.append(indent + ', '.join(fmt % b for b in data[i:i + per_line]) + ',')
+
+    return '\n'.join(lines)
+
+
+def c_char(chr_code):
+    if chr(chr_code) in '\'\\' or not 0x20 <= chr_code < 0x7f:
+        return '0x%02x' % chr_code
+
+    return "'%c'" % chr_code
+
+
+def parse_char(token, path):
+    if token.startswith('0x') and len(token) > 2:
+        return int(token, 16)
+
+    if len(token) != 1:
+        raise ValueError('%s: invalid character %s' % (path, token))
+
+    return ord(token)
+
+
+def read_font(path):
+    """Returns a dictionary describing a font source file."""
+    font = {'height': 8, 'spacing': 1, 'inverted': False, 'autokern': False,
+            'glyphs': {}, 'kerning': {}}
+
+    with open(path) as f:
+        lines = [l.rstrip('\r\n') for l in f]
+
+    i = 0
+
+    while i < len(lines):
+        words = lines[i].split()
+        i += 1
+
+        if not words or words[0].startswith('#'):
+            continue
+
+        if words[0] in ('height', 'spacing'):
+            font[words[0]] = int(words[1])
+        elif words[0] in ('inverted', 'autokern'):
+            font[words[0]] = True
+        elif words[0] == 'kern':
+            pair = (parse_char(words[1], path), parse_char(words[2], path))
+            font['kerning'][pair] = int(words[3])
+        elif words[0] == 'char':
+            chr_code = parse_char(words[1], path)
+            rows = lines[i:i + font['height']]
+            i += font['height']
+
+            if len(rows) != font['height'] or len(set(len(r) for r in rows)) != 1 \
+                    or any(c not in '#.' for r in rows for c in r):
+                raise ValueError('%s: invalid glyph 0x%02x' % (path, chr_code))
+
+            # same convention as PBM images: 1 for unlit pixels
+            font['glyphs'][chr_code] = [[0 if c == '#' else 1 for c in r] for r in rows]
+        else:
+            raise ValueError('%s: unknown directive %s' % (path, words[0]))
+
+    if font['height'] % 8 or not 8 <= font['height'] <= 64:
+        raise ValueError('%s: height has to be a multiple of 8' % path)
+
+    if not font['glyphs']:
+        raise ValueError('%s: no glyphs' % path)
+
+    return font
+
+
+def autokern(font):
+    """Closes gaps between glyphs whose shapes leave room for it: after
+    kerning there are still 'spacing' unlit columns between the glyphs in
+    every row, and in the neighbouring rows too, so they never touch.
+    Only letters and full stops/commas are kerned, digits are left alone
+    to keep numbers aligned."""
+    spacing = font['spacing']
+    height = font['height']
+    edges = {}
+
+    for chr_code, rows in font['glyphs'].items():
+        if chr(chr_code).isalpha() or chr(chr_code) in '.,':
+            lit = [[x for x, v in enumerate(r) if not v] for r in rows]
+            edges[chr_code] = ([l[0] if l else None for l in lit],
+                               [l[-1] if l else None for l in lit],
+                               len(rows[0]))
+
+    for left, (_, right_edge, width) in edges.items():
+        for right, (left_edge, _, _) in edges.items():
+            if (left, right) in font['kerning'] or (chr(left) in '.,' and chr(right) in '.,'):
+                continue
+
+            kern = -spacing
+
+            for r1 in range(height):
+                if right_edge[r1] is None:
+                    continue
+
+                for r2 in range(max(r1 - 1, 0), min(r1 + 2, height)):
+                    if left_edge[r2] is not None:
+                        kern = max(kern, right_edge[r1] + 1 - width - left_edge[r2])
+
+            if kern < 0:
+                font['kerning'][(left, right)] = kern
+
+
+def font_source(name, font):
+    """Returns (C source, size) for a font."""
+    glyphs = font['glyphs']
+    first, last = min(glyphs), max(glyphs)
+    offsets = [0]
+    data = bytearray()
+
+    for chr_code in range(first, last + 1):
+        # missing characters have no columns
+        if chr_code in glyphs:
+            rows = glyphs[chr_code]
+            data += to_pages(len(rows[0]), len(rows), rows)
+
+        offsets.append(len(data))
+
+    if len(data) > 0xffff:
+        raise ValueError('%s: font too large' % name)
+
+    for (left, right), kern in font['kerning'].items():
+        if not -font['spacing'] <= kern <= 127:
+            raise ValueError('%s: kerning %c%c would overlap glyphs' % (name, left, right))
+
+    kerning = sorted((l, r, k) for (l, r), k in font['kerning'].items()
+                     if l in glyphs and r in glyphs)
+
+    out = ['\nstatic const uint16_t %s_offsets[%d] = {\n%s\n};\n'
+           % (name, len(offsets), c_array(offsets, fmt='%d'))]
+    out.append('\nstatic const uint8_t %s_glyphs[%d] = {\n%s\n};\n'
+               % (name, len(data), c_array(data)))
+    size = 2 * len(offsets) + len(data)
+
+    if font['inverted']:
+        out.append('\nstatic const uint8_t %s_inverted[%d] = {\n%s\n};\n'
+                   % (name, len(data), c_array([b ^ 0xff for b in data])))
+        size += len(data)
+
+    if kerning:
+        pairs = ['{ %s, %s, %d }' % (c_char(l), c_char(r), k) for l, r, k in kerning]
+        out.append('\nstatic const font_kern_t %s_kerning[%d] = {\n%s\n};\n'
+                   % (name, len(kerning), c_array(pairs, fmt='%s', per_line=6)))
+        size += 3 * len(kerning)
+
+    out.append('\nconst font_t %s = {\n'
+               '    %d, %d, %d, %d,\n'
+               '    %s_offsets, %s_glyphs, %s,\n'
+               '    %s, %d\n'
+               '};\n'
+               % (name, font['height'], font['spacing'], first, last, name, name,
+                  name + '_inverted' if font['inverted'] else 'NULL',
+                  name + '_kerning' if kerning else 'NULL', len(kerning)))
+
+    return ''.join(out), size, len(kerning)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Converts PBM images and font '
+            'sources to SSD1306 bitmaps')
+    parser.add_argument('-o', '--output', required=True,
+            help='output file name without extension (.c and .h are created)')
+    parser.add_argument('--rle', action='store_true',
+            help='compress images when it reduces their size')
+    parser.add_argument('files', nargs='+', help='PBM images and .font files')
+    args = parser.parse_args()
+
+    header_name = os.path.basename(args.output) + '.h'
+    guard = header_name.upper().replace('.', '_')
+    source = [HEADER, '#include "%s"\n' % header_name]
+    header = [HEADER, '#ifndef %s\n#define %s\n\n#include "lcd.h"\n' % (guard, guard)]
+    total = 0
+
+    for path in sorted(args.files):
+        name = os.path.splitext(os.path.basename(path))[0]
+
+        if path.endswith('.font'):
+            font = read_font(path)
+
+            if font['autokern']:
+                autokern(font)
+
+            code, size, pairs = font_source(name, font)
+            total += size
+            source.append(code)
+            header.append('\n/* %d px, %d bytes, %d kerning pairs */\nextern const font_t %s;\n'
+                    % (font['height'], size, pairs, name))
+            continue
+
+        width, height, rows = read_pbm(path)
+
+        if width > 255 or height > 255:
+            sys.exit('%s: image too large' % path)
+
+        data = to_pages(width, height, rows)
+        compressed = 0
+
+        if args.rle:
+            rle = rle_encode(data)
+            assert rle_decode(rle) == data
+
+            if len(rle) < len(data):
+                data = rle
+                compressed = 1
+
+        total += len(data)
+        source.append('\nstatic const uint8_t %s_data[%d] = {\n%s\n};\n\n'
+                'const bitmap_t %s = { %d, %d, %d, %s_data };\n'
+                % (name, len(data), c_array(data), name, width, height,
+                   compressed, name))
+        header.append('\n/* %dx%d, %d bytes%s */\nextern const bitmap_t %s;\n'
+                % (width, height, len(data), ', RLE' if compressed else '', name))
+
+    header.append('\n#endif /* %s */\n' % guard)
+
+    with open(args.output + '.c', 'w') as f:
+        f.write(''.join(source))
+
+    with open(args.output + '.h', 'w') as f:
+        f.write(''.join(header))
+
+    print('%s: %d files, %d bytes' % (args.output, len(args.files), total))
+
+
+if __name__ == '__main__':
+    main()
@@ -24,11 +24,84 @@
 #include "apps_list.h"
 #include "settings_list.h"
 #include "io_conf.h"
+#include "buffer.h"
 
 #include <uart.h>
 #include <sysclk.h>
 #include <pio.h>
+#include <pdc.h>
+#include <interrupt.h>
 #include <udi_cdc.h>
+#include <stdio.h>
+
+/* USB-UART bridge (app_uart_func()), the PDC moves the data between UART0
+ * and ring buffers placed in the shared buffer. The ring indices are
+ * free-running byte counters, the ring sizes have to be powers of two. */
+#define BRIDGE_RX_SIZE      (32 * 1024)
+#define BRIDGE_TX_SIZE      (16 * 1024)
+/* PDC receive block, takes ~3.4 ms to fill at the highest baud rate */
+#define BRIDGE_RX_BLOCK     512
+#define BRIDGE_IRQ_PRI      6
+
+static uint8_t * const rx_ring = &buffer.u8[0];
+static uint8_t * const tx_ring = &buffer.u8[BRIDGE_RX_SIZE];
+/* receives the data that does not fit in the ring */
+static uint8_t * const rx_discard = &buffer.u8[BRIDGE_RX_SIZE + BRIDGE_TX_SIZE];
+
+static Pdc *uart_pdc;
+
+/* Receive ring: rx_head counts the bytes in completely filled blocks,
+ * rx_tail the bytes forwarded to USB and rx_fill the bytes in blocks
+ * handed to the PDC. The PDC current/next buffers are either ring blocks
+ * or the discard block, so unread data is never overwritten. */
+static volatile uint32_t rx_head, rx_tail;
+static uint32_t rx_fill;
+static volatile int rx_cur_ring, rx_next_ring;
+
+/* Transmit ring: tx_head counts the bytes received from USB, tx_tail
+ * the sent ones and tx_len the bytes being sent by the PDC */
+static volatile uint32_t tx_head, tx_tail, tx_len;
+
+static volatile uint32_t rx_lost;       /* bytes dropped, USB did not keep up */
+static uint32_t rx_overruns;            /* UART overrun errors */
+
+/* baud rates, follow the menu_uart_baud settings */
+static const uint32_t bridge_bauds[] = {
+    1500000, 921600, 460800, 230400, 115200, 57600, 38400, 9600
+};
+
+/* Terminal showing the bridged traffic (app_uart_func()) */
+
+/* characters in a terminal line (6x8 font) */
+#define TERM_COLS           (LCD_WIDTH / 6)
+/* bytes in a terminal line in the hex mode ("XX " per byte) */
+#define TERM_HEX_BYTES      (TERM_COLS / 3)
+
+/* Ring buffer decoupling the bridge from the display, entries hold
+ * the transferred bytes and flags. The indices wrap with the buffer size,
+ * the buffer is empty when head == tail. */
+#define TERM_RING_SIZE      256
+#define TERM_TX             0x100   /* sent to the serial port */
+#define TERM_GAP            0x200   /* preceded by bytes that did not fit */
+
+/* terminal modes, follow the menu_uart_view settings */
+typedef enum { TERM_ASCII, TERM_HEX, TERM_OFF } term_mode_t;
+
+static uint16_t term_ring[TERM_RING_SIZE];
+static uint8_t term_head, term_tail;
+
+static term_mode_t term_mode;
+static unsigned int term_lost;  /* bytes skipped since the last gap line */
+static int term_gap;            /* bytes have been skipped */
+
+static char term_line[TERM_COLS + 1];
+static int term_len;
+static int term_tx;             /* direction of the line contents */
+static int term_done;           /* line is finished */
+static int term_shown;          /* line is at the bottom of the screen */
+static int term_dirty;          /* line has been modified since shown */
+
+static uint32_t shown_lost, shown_overruns;    /* bridge counters last shown */
 
 void serial_init(unsigned int baud) {
     sam_uart_opt_t uart_settings;
@@ -81,34 +154,368 @@ void cmd_uart(const uint8_t* data_in, unsigned int input_len) {
 }
 
 
-void app_uart_func(void) {
-    uint8_t c;
+/*
+ * Formats the bridge error counters, returns the text length
+ */
+static int bridge_status(char *text) {
+    int len = snprintf(text, TERM_COLS + 1, "! lost %lu ovr %lu",
+            rx_lost, rx_overruns);
+
+    return len > TERM_COLS ? TERM_COLS : len;
+}
+
+
+/*
+ * Queues a byte to be shown in the terminal, bytes are skipped when
+ * the display cannot keep up
+ */
+static void term_push(uint8_t c, int tx) {
+    if (term_mode == TERM_OFF) return;
+
+    if ((uint8_t)(term_tail + 1) == term_head) {
+        term_gap = 1;
+        ++term_lost;
+        return;
+    }
+
+    term_ring[term_tail++] = c | (tx ? TERM_TX : 0) | (term_gap ? TERM_GAP : 0);
+    term_gap = 0;
+}
+
+
+static void term_new_line(void) {
+    term_len = 0;
+    term_done = 0;
+    term_shown = 0;
+    term_dirty = 0;
+}
+
+
+static void term_draw(void) {
+    // data sent to the serial port is shown inverted
+    SSD1306_scrollText(term_line, term_len, term_tx ? BLACK : WHITE, !term_shown);
+    term_shown = 1;
+    term_dirty = 0;
+}
+
+
+/*
+ * Appends a byte to the current line
+ */
+static void term_add(uint8_t c) {
+    static const char hex[] = "0123456789ABCDEF";
+
+    if (term_mode == TERM_HEX) {
+        term_line[term_len++] = hex[c >> 4];
+        term_line[term_len++] = hex[c & 0x0f];
+        term_line[term_len++] = ' ';
+        term_done = term_len >= TERM_HEX_BYTES * 3;
+    } else if (c == '\n') {
+        term_done = 1;
+    } else if (c != '\r') {
+        term_line[term_len++] = (c >= ' ' && c < 0x7f) ? c : '.';
+        term_done = term_len >= TERM_COLS;
+    }
+
+    term_dirty = 1;
+}
+
+
+/*
+ * Moves the queued bytes to the terminal lines, as long as the display
+ * is not busy, so the bridge never waits for the display
+ */
+static void term_update(void) {
+    while (!SSD1306_isBusy()) {
+        uint16_t item;
+        int tx;
+
+        if (term_done) {
+            if (term_dirty || !term_shown) term_draw();
+
+            term_new_line();
+            continue;
+        }
+
+        // changed error counters are reported in a line of their own
+        if (rx_lost != shown_lost || rx_overruns != shown_overruns) {
+            if (term_len > 0) {
+                term_done = 1;
+                continue;
+            }
+
+            shown_lost = rx_lost;
+            shown_overruns = rx_overruns;
+            term_len = bridge_status(term_line);
+            term_tx = 0;
+            term_done = 1;
+            term_dirty = 1;
+            continue;
+        }
+
+        if (term_head == term_tail) {
+            // show the incomplete line too
+            if (term_dirty) term_draw();
+
+            return;
+        }
+
+        item = term_ring[term_head];
+        tx = (item & TERM_TX) ? 1 : 0;
+
+        // direction changes and skipped bytes start a new line
+        if (term_len > 0 && (tx != term_tx || (item & TERM_GAP))) {
+            term_done = 1;
+            continue;
+        }
+
+        if (item & TERM_GAP) {
+            term_len = sprintf(term_line, "~ %u skipped", term_lost);
+            term_lost = 0;
+            term_tx = 0;
+            term_done = 1;
+            term_dirty = 1;
+            term_ring[term_head] &= ~TERM_GAP;
+            continue;
+        }
+
+        ++term_head;
+        term_tx = tx;
+        term_add(item & 0xff);
+    }
+}
+
+
+/*
+ * Shows the changed error counters when the terminal is off
+ */
+static void bridge_show_status(void) {
+    char text[TERM_COLS + 1];
+    int len;
+
+    if (SSD1306_isBusy()
+            || (rx_lost == shown_lost && rx_overruns == shown_overruns))
+        return;
+
+    shown_lost = rx_lost;
+    shown_overruns = rx_overruns;
+    len = bridge_status(text);
+    SSD1306_clearBuffer(0, 6, BLACK, LCD_WIDTH);
+    SSD1306_setString(0, 6, text, len, WHITE);
+    SSD1306_drawBufferDMA();
+}
+
+
+/*
+ * Hands the next receive block to the PDC, the discard block is used
+ * when the ring is full
+ */
+static void bridge_rx_queue(void) {
+    if (rx_fill + BRIDGE_RX_BLOCK - rx_tail <= BRIDGE_RX_SIZE) {
+        uart_pdc->PERIPH_RNPR = (uint32_t) &rx_ring[rx_fill & (BRIDGE_RX_SIZE - 1)];
+        rx_fill += BRIDGE_RX_BLOCK;
+        rx_next_ring = 1;
+    } else {
+        uart_pdc->PERIPH_RNPR = (uint32_t) rx_discard;
+        rx_next_ring = 0;
+    }
+
+    uart_pdc->PERIPH_RNCR = BRIDGE_RX_BLOCK;
+}
+
+
+/*
+ * Returns the number of bytes received to the ring so far
+ */
+static uint32_t bridge_rx_received(void) {
+    irqflags_t flags = cpu_irq_save();
+    uint32_t head = rx_head;
+
+    if (rx_cur_ring) {
+        uint32_t rpr = uart_pdc->PERIPH_RPR;
+
+        // ENDRX stays set until the interrupt handler queues another block,
+        // then the PDC pointer refers to the next block already
+        if (uart_get_status(UART0) & UART_SR_ENDRX)
+            head += BRIDGE_RX_BLOCK;
+        else
+            head += rpr - (uint32_t) &rx_ring[head & (BRIDGE_RX_SIZE - 1)];
+    }
+
+    cpu_irq_restore(flags);
+
+    return head;
+}
+
+
+/*
+ * Sends the next contiguous part of the transmit ring, has to be called
+ * with the UART interrupt disabled
+ */
+static void bridge_tx_start(void) {
+    uint32_t pos = tx_tail & (BRIDGE_TX_SIZE - 1);
+    uint32_t count = tx_head - tx_tail;
+
+    if (count > BRIDGE_TX_SIZE - pos)
+        count = BRIDGE_TX_SIZE - pos;
+
+    tx_len = count;
+
+    if (count == 0) {
+        uart_disable_interrupt(UART0, UART_IDR_ENDTX);
+        return;
+    }
+
+    uart_pdc->PERIPH_TPR = (uint32_t) &tx_ring[pos];
+    uart_pdc->PERIPH_TCR = count;
+    uart_enable_interrupt(UART0, UART_IER_ENDTX);
+}
+
+
+static void bridge_start(void) {
+    uart_pdc = uart_get_pdc_base(UART0);
+
+    rx_head = rx_tail = 0;
+    rx_lost = rx_overruns = 0;
+    tx_head = tx_tail = tx_len = 0;
+
+    uart_pdc->PERIPH_RPR = (uint32_t) rx_ring;
+    uart_pdc->PERIPH_RCR = BRIDGE_RX_BLOCK;
+    rx_fill = BRIDGE_RX_BLOCK;
+    rx_cur_ring = 1;
+    bridge_rx_queue();
+
+    uart_enable_interrupt(UART0, UART_IER_ENDRX);
+    NVIC_SetPriority(UART0_IRQn, BRIDGE_IRQ_PRI);
+    NVIC_EnableIRQ(UART0_IRQn);
+    pdc_enable_transfer(uart_pdc, PERIPH_PTCR_RXTEN | PERIPH_PTCR_TXTEN);
+}
+
+
+static void bridge_stop(void) {
+    NVIC_DisableIRQ(UART0_IRQn);
+    uart_disable_interrupt(UART0, UART_IDR_ENDRX | UART_IDR_ENDTX);
+    pdc_disable_transfer(uart_pdc, PERIPH_PTCR_RXTDIS | PERIPH_PTCR_TXTDIS);
+}
+
+
+/*
+ * Forwards the received data to USB, as much as the CDC buffer accepts
+ */
+static void bridge_rx_to_usb(void) {
+    uint32_t pos = rx_tail & (BRIDGE_RX_SIZE - 1);
+    uint32_t count = bridge_rx_received() - rx_tail;
+    uint32_t free = udi_cdc_get_free_tx_buffer();
 
-    while(SSD1306_isBusy());
+    if (count > BRIDGE_RX_SIZE - pos)
+        count = BRIDGE_RX_SIZE - pos;
+
+    if (count > free)
+        count = free;
+
+    if (count == 0)
+        return;
+
+    udi_cdc_write_buf(&rx_ring[pos], count);
+
+    for (uint32_t i = 0; i < count; ++i)
+        term_push(rx_ring[pos + i], 0);
+
+    // release the space only after the data has been copied
+    rx_tail += count;
+}
+
+
+/*
+ * Moves the data received over USB to the transmit ring, as much as fits
+ * (USB transfers are held back otherwise)
+ */
+static void bridge_usb_to_tx(void) {
+    uint32_t pos = tx_head & (BRIDGE_TX_SIZE - 1);
+    uint32_t count = BRIDGE_TX_SIZE - (tx_head - tx_tail);
+    uint32_t received = udi_cdc_get_nb_received_data();
+    irqflags_t flags;
+
+    if (count > BRIDGE_TX_SIZE - pos)
+        count = BRIDGE_TX_SIZE - pos;
+
+    if (count > received)
+        count = received;
+
+    if (count == 0)
+        return;
+
+    udi_cdc_read_buf(&tx_ring[pos], count);
+
+    for (uint32_t i = 0; i < count; ++i)
+        term_push(tx_ring[pos + i], 1);
+
+    flags = cpu_irq_save();
+    tx_head += count;
+
+    if (tx_len == 0)
+        bridge_tx_start();
+
+    cpu_irq_restore(flags);
+}
+
+
+/**
+ * \brief Interrupt handler for UART0 (USB-UART bridge).
+ */
+void UART0_Handler(void) {
+    uint32_t status = uart_get_status(UART0) & uart_get_interrupt_mask(UART0);
+
+    if (status & UART_SR_ENDRX) {
+        // the PDC has moved on to the next block
+        if (rx_cur_ring)
+            rx_head += BRIDGE_RX_BLOCK;
+        else
+            rx_lost += BRIDGE_RX_BLOCK;
+
+        rx_cur_ring = rx_next_ring;
+        bridge_rx_queue();
+    }
+
+    if (status & UART_SR_ENDTX) {
+        tx_tail += tx_len;
+        bridge_tx_start();
+    }
+}
+
+
+void app_uart_func(void) {
     SSD1306_clearBufferFull();
     SSD1306_setString(15, 3, "USB-UART adapter", 16, WHITE);
     SSD1306_drawBufferDMA();
 
-    io_configure(IO_UART);
+    term_mode = (term_mode_t) menu_uart_view.val;
+    term_head = term_tail = 0;
+    term_lost = 0;
+    term_gap = 0;
+    term_new_line();
+    shown_lost = shown_overruns = 0;
 
-    switch (menu_uart_baud.val) {
-        case 0: serial_init(115200); break;
-        case 1: serial_init(57600); break;
-        case 2: serial_init(38400); break;
-        case 3: serial_init(9600); break;
-    }
+    io_configure(IO_UART);
+    serial_init(bridge_bauds[menu_uart_baud.val]);
+    bridge_start();
 
     while (btn_state() != BUT_LEFT) {
-        // USB -> serial
-        if (udi_cdc_is_rx_ready()) {
-            serial_putc(udi_cdc_getc());
-        }
+        bridge_usb_to_tx();
+        bridge_rx_to_usb();
 
-        // serial -> USB
-        if (!uart_read(UART0, &c)) {
-            udi_cdc_putc(c);
+        if (uart_get_status(UART0) & UART_SR_OVRE) {
+            ++rx_overruns;
+            uart_reset_status(UART0);
         }
+
+        if (term_mode == TERM_OFF)
+            bridge_show_status();
+        else
+            term_update();
     }
 
+    bridge_stop();
+
     while (btn_state());    // wait for the button release
 }
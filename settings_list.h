@@ -28,7 +28,26 @@ extern menu_list_t menu_la_lcd_trigger_input;
 extern menu_list_t menu_la_lcd_trigger_level;
 extern menu_list_t menu_scope_channels;
 extern menu_list_t menu_scope_fsampling;
+extern menu_list_t menu_scope_acq;
+extern menu_list_t menu_scope_filter;
+extern menu_list_t menu_scope_persist;
+extern menu_list_t menu_scope_meas;
+extern menu_list_t menu_scope_mode;
+extern menu_list_t menu_scope_roll;
+extern menu_list_t menu_scope_hires;
+extern menu_list_t menu_scope_fft_size;
+extern menu_list_t menu_scope_fft_window;
+extern menu_list_t menu_scope_fft_avg;
 /*extern menu_list_t menu_scope_gain;*/
+extern menu_list_t menu_mixed_fsampling;
+extern menu_list_t menu_mixed_channels;
+extern menu_list_t menu_mixed_trigger;
+extern menu_list_t menu_mixed_trigger_level;
+
+extern menu_list_t menu_siggen_wave;
+extern menu_list_t menu_siggen_freq;
+extern menu_list_t menu_siggen_mode;
 extern menu_list_t menu_uart_baud;
+extern menu_list_t menu_uart_view;
 
 #endif /* SETTINGS_LIST_H */
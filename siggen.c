@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+
+#include "dac_gen.h"
+#include "apps_list.h"
+#include "buttons.h"
+#include "command_handlers.h"
+#include "gfx.h"
+#include "io_conf.h"
+#include "lcd.h"
+#include "settings_list.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Sweep span and duration in the menu-driven mode */
+#define SIGGEN_SWEEP_RATIO      10
+#define SIGGEN_SWEEP_TIME       1000
+
+/* Burst settings in the menu-driven mode [periods] */
+#define SIGGEN_BURST_CYCLES     5
+#define SIGGEN_BURST_IDLE       15
+
+static const char * const siggen_names[] = { "Sine", "Square", "Triangle", "Arbitrary" };
+
+
+static int siggen_start(void)
+{
+    static const uint32_t freqs[] = { 10, 100, 1000, 10000, 100000 };
+    dacg_wave_t wave = (dacg_wave_t) menu_siggen_wave.val;
+    uint32_t freq = freqs[menu_siggen_freq.val];
+    int ret;
+
+    io_configure(IO_DAC);
+    dacg_set_burst(0, 0);
+
+    switch (menu_siggen_mode.val) {
+        case 1: /* sweep */
+            ret = dacg_configure_sweep(wave, freq / SIGGEN_SWEEP_RATIO, freq,
+                    SIGGEN_SWEEP_TIME, DACG_MAX_CODE, (DACG_MAX_CODE + 1) / 2);
+            break;
+
+        case 2: /* burst */
+            dacg_set_burst(SIGGEN_BURST_CYCLES, SIGGEN_BURST_IDLE);
+            /* fall through */
+
+        default: /* continuous */
+            ret = dacg_configure(wave, freq, DACG_MAX_CODE, (DACG_MAX_CODE + 1) / 2);
+            break;
+    }
+
+    if (ret)
+        dacg_start();
+
+    return ret;
+}
+
+
+static void siggen_draw(int ok)
+{
+    char text[24];
+
+    SSD1306_clearBufferFull();
+    SSD1306_setString(0, 0, "Signal generator", 16, WHITE);
+
+    if (!ok) {
+        SSD1306_setString(0, 2, "Invalid settings", 16, WHITE);
+    } else {
+        int x;
+
+        /* large digits, readable from a distance */
+        sprintf(text, "%lu", dacg_get_freq());
+        x = SSD1306_setTextFont(0, LCD_PAGE_SIZE, text, strlen(text), &digits24, WHITE);
+        SSD1306_setString(x + 2, 3, "Hz", 2, WHITE);
+        SSD1306_setString(0, 4, siggen_names[menu_siggen_wave.val],
+                strlen(siggen_names[menu_siggen_wave.val]), WHITE);
+        sprintf(text, "%lu samples/period", dacg_get_samples());
+        SSD1306_setString(0, 5, text, strlen(text), WHITE);
+        sprintf(text, "Output %s (PB13)", dacg_busy() ? "on" : "off");
+        SSD1306_setString(0, 6, text, strlen(text), WHITE);
+    }
+
+    SSD1306_setString(0, 7, "RIGHT: on/off", 13, WHITE);
+    SSD1306_drawBufferDMA();
+}
+
+
+void app_siggen_func(void)
+{
+    int ok = siggen_start();
+
+    /* the generator keeps running after leaving the application,
+     * so it can drive the other instruments */
+    siggen_draw(ok);
+
+    while (btn_state() != BUT_LEFT) {
+        if (btn_state() != BUT_RIGHT)
+            continue;
+
+        if (dacg_busy())
+            dacg_stop();
+        else
+            ok = siggen_start();
+
+        siggen_draw(ok);
+        while (btn_state());    /* wait for the button release */
+    }
+
+    while (btn_state());    /* wait for the button release */
+}
+
+
+static uint16_t siggen_u16(const uint8_t *data)
+{
+    return (data[0] << 8) | data[1];
+}
+
+
+static uint32_t siggen_u32(const uint8_t *data)
+{
+    return (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+
+static void siggen_resp_started(void)
+{
+    uint32_t freq = dacg_get_freq();
+    uint16_t samples = dacg_get_samples();
+
+    cmd_resp_init(CMD_RESP_OK);
+    cmd_resp_write_u32(freq);
+    cmd_resp_write((samples >> 8) & 0xff);
+    cmd_resp_write(samples & 0xff);
+}
+
+
+void cmd_dac(const uint8_t* data_in, unsigned int input_len)
+{
+    switch (data_in[0]) {
+        case CMD_DAC_START:
+            if (input_len < 14) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            io_configure(IO_DAC);
+            dacg_set_burst(siggen_u16(&data_in[10]), siggen_u16(&data_in[12]));
+
+            if (!dacg_configure((dacg_wave_t) data_in[1], siggen_u32(&data_in[2]),
+                        siggen_u16(&data_in[6]), siggen_u16(&data_in[8]))) {
+                cmd_resp_init(CMD_RESP_EXEC_ERR);
+                return;
+            }
+
+            dacg_start();
+            siggen_resp_started();
+            break;
+
+        case CMD_DAC_SWEEP:
+            if (input_len < 18) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            io_configure(IO_DAC);
+
+            if (!dacg_configure_sweep((dacg_wave_t) data_in[1], siggen_u32(&data_in[2]),
+                        siggen_u32(&data_in[6]), siggen_u32(&data_in[10]),
+                        siggen_u16(&data_in[14]), siggen_u16(&data_in[16]))) {
+                cmd_resp_init(CMD_RESP_EXEC_ERR);
+                return;
+            }
+
+            dacg_start();
+            siggen_resp_started();
+            break;
+
+        case CMD_DAC_STOP:
+            dacg_stop();
+            cmd_resp_init(CMD_RESP_OK);
+            break;
+
+        case CMD_DAC_LOAD:
+        {
+            uint16_t first;
+
+            if (input_len < 5) {
+                cmd_resp_init(CMD_RESP_INVALID_CMD);
+                return;
+            }
+
+            first = siggen_u16(&data_in[1]);
+
+            if (!dacg_set_arbitrary_size(siggen_u16(&data_in[3]))) {
+                cmd_resp_init(CMD_RESP_EXEC_ERR);
+                return;
+            }
+
+            for (unsigned int i = 5; i + 1 < input_len; i += 2) {
+                dacg_set_arbitrary(first++, (int16_t) siggen_u16(&data_in[i]));
+            }
+
+            cmd_resp_init(CMD_RESP_OK);
+            break;
+        }
+
+        default:
+            cmd_resp_init(CMD_RESP_INVALID_CMD);
+            return;
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Host replacement for the ASF compiler.h, used by the tests: plain C
+ * versions of the Cortex-M4 SIMD intrinsics used by the tested modules.
+ */
+
+#ifndef TESTS_COMPILER_H
+#define TESTS_COMPILER_H
+
+#include <stdint.h>
+
+static inline int32_t __lo16(uint32_t x) { return (int16_t) (x & 0xffff); }
+static inline int32_t __hi16(uint32_t x) { return (int16_t) (x >> 16); }
+
+static inline uint32_t __pack16(int32_t lo, int32_t hi)
+{
+    return ((uint32_t) lo & 0xffff) | ((uint32_t) hi << 16);
+}
+
+static inline int32_t __sat(int64_t val, unsigned int bits)
+{
+    int64_t max = ((int64_t) 1 << (bits - 1)) - 1;
+
+    return val > max ? max : (val < -max - 1 ? -max - 1 : val);
+}
+
+#define __SSAT(val, bits)   __sat((val), (bits))
+
+#define __PKHBT(a, b, s)    ((((uint32_t) (a)) & 0x0000ffff) \
+                            | ((((uint32_t) (b)) << (s)) & 0xffff0000))
+#define __PKHTB(a, b, s)    ((((uint32_t) (a)) & 0xffff0000) \
+                            | ((((uint32_t) (b)) >> (s)) & 0x0000ffff))
+
+static inline uint32_t __QADD16(uint32_t a, uint32_t b)
+{
+    return __pack16(__sat(__lo16(a) + __lo16(b), 16), __sat(__hi16(a) + __hi16(b), 16));
+}
+
+static inline uint32_t __QSUB16(uint32_t a, uint32_t b)
+{
+    return __pack16(__sat(__lo16(a) - __lo16(b), 16), __sat(__hi16(a) - __hi16(b), 16));
+}
+
+static inline uint32_t __SHADD16(uint32_t a, uint32_t b)
+{
+    return __pack16((__lo16(a) + __lo16(b)) >> 1, (__hi16(a) + __hi16(b)) >> 1);
+}
+
+static inline uint32_t __SHSUB16(uint32_t a, uint32_t b)
+{
+    return __pack16((__lo16(a) - __lo16(b)) >> 1, (__hi16(a) - __hi16(b)) >> 1);
+}
+
+static inline uint32_t __SMUAD(uint32_t a, uint32_t b)
+{
+    return __lo16(a) * __lo16(b) + __hi16(a) * __hi16(b);
+}
+
+static inline uint32_t __SMUSDX(uint32_t a, uint32_t b)
+{
+    return __lo16(a) * __hi16(b) - __hi16(a) * __lo16(b);
+}
+
+static inline uint32_t __SMLAD(uint32_t a, uint32_t b, uint32_t acc)
+{
+    return __lo16(a) * __lo16(b) + __hi16(a) * __hi16(b) + (int32_t) acc;
+}
+
+static inline uint32_t __RBIT(uint32_t val)
+{
+    uint32_t res = 0;
+
+    for (int i = 0; i < 32; ++i, val >>= 1)
+        res = (res << 1) | (val & 1);
+
+    return res;
+}
+
+static inline uint8_t __CLZ(uint32_t val)
+{
+    return val ? __builtin_clz(val) : 32;
+}
+
+#endif /* TESTS_COMPILER_H */
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Host replacement for the ASF interrupt.h, used by the tests (no interrupts).
+ */
+
+#ifndef TESTS_INTERRUPT_H
+#define TESTS_INTERRUPT_H
+
+#include <stdint.h>
+
+typedef uint32_t irqflags_t;
+
+static inline irqflags_t cpu_irq_save(void)
+{
+    return 0;
+}
+
+static inline void cpu_irq_restore(irqflags_t flags)
+{
+    (void) flags;
+}
+
+#endif /* TESTS_INTERRUPT_H */
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Host replacement for the ASF sysclk.h, used by the tests. It also provides
+ * the DWT cycle counter registers, which come from the device header on the
+ * target (the registers are defined by the tests).
+ */
+
+#ifndef TESTS_SYSCLK_H
+#define TESTS_SYSCLK_H
+
+#include <stdint.h>
+
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type tests_dwt;
+extern CoreDebug_Type tests_core_debug;
+
+#define DWT         (&tests_dwt)
+#define CoreDebug   (&tests_core_debug)
+
+static inline uint32_t sysclk_get_cpu_hz(void)
+{
+    return 120000000;
+}
+
+#endif /* TESTS_SYSCLK_H */
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Host replacement for the ASF twi.h, used by the tests: status codes only,
+ * the transactions are emulated by the tests (see i2c.h).
+ */
+
+#ifndef TESTS_TWI_H
+#define TESTS_TWI_H
+
+#define TWI_SUCCESS             0
+#define TWI_INVALID_ARGUMENT    1
+#define TWI_SEND_NACK           7
+#define TWI_BUSY                8
+#define TWI_ERROR_TIMEOUT       9
+
+#endif /* TESTS_TWI_H */
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Accuracy of the Q15 FFT (fft.c) against a double precision DFT.
+ */
+
+#include "fft.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Limits for the output error, in Q15 LSBs of the 1/size scaled spectrum */
+#define MAX_ERROR       8
+#define MIN_SNR         45.0
+/* Tolerance of the reported level of a sine wave, fft_power_db() uses
+ * a linear approximation of log2 with 4 fractional bits (~0.45 dB) */
+#define MAX_DB_ERROR    0.5
+
+static int16_t data[FFT_MAX_SIZE] __attribute__((aligned(4)));
+static double ref_re[FFT_MAX_SIZE / 2], ref_im[FFT_MAX_SIZE / 2];
+static int failures;
+
+static const char *window_names[] = { "rect", "hann", "blackman" };
+
+
+static double window_value(fft_window_t window, unsigned int i, unsigned int size)
+{
+    double x = 2 * M_PI * i / size;
+
+    switch (window) {
+        case FFT_WINDOW_HANN:     return 0.5 - 0.5 * cos(x);
+        case FFT_WINDOW_BLACKMAN: return 0.42 - 0.5 * cos(x) + 0.08 * cos(2 * x);
+        default:                  return 1.0;
+    }
+}
+
+
+/* Spectrum of the windowed samples, scaled by 1/size as fft_real() does */
+static void reference_dft(const int16_t *samples, unsigned int size,
+        fft_window_t window)
+{
+    for (unsigned int k = 0; k < size / 2; ++k) {
+        double re = 0, im = 0;
+
+        for (unsigned int n = 0; n < size; ++n) {
+            double x = samples[n] * window_value(window, n, size);
+            double phase = 2 * M_PI * (double) k * n / size;
+
+            re += x * cos(phase);
+            im -= x * sin(phase);
+        }
+
+        ref_re[k] = re / size;
+        ref_im[k] = im / size;
+    }
+}
+
+
+static void check(const char *name, int ok)
+{
+    if (!ok) {
+        printf("FAIL: %s\n", name);
+        ++failures;
+    }
+}
+
+
+/* Compares fft_real() output with the reference for a set of samples */
+static void test_accuracy(const char *signal, const int16_t *samples,
+        unsigned int size, fft_window_t window)
+{
+    double max_err = 0, err_power = 0, sig_power = 0, snr;
+    char name[64];
+
+    reference_dft(samples, size, window);
+
+    for (unsigned int i = 0; i < size; ++i)
+        data[i] = samples[i];
+
+    fft_window(data, size, window);
+    fft_real(data, size);
+
+    for (unsigned int k = 0; k < size / 2; ++k) {
+        double dre = data[2 * k] - ref_re[k];
+        double dim = data[2 * k + 1] - ref_im[k];
+        double err = sqrt(dre * dre + dim * dim);
+
+        if (err > max_err)
+            max_err = err;
+
+        err_power += dre * dre + dim * dim;
+        sig_power += ref_re[k] * ref_re[k] + ref_im[k] * ref_im[k];
+    }
+
+    snr = 10 * log10(sig_power / err_power);
+    printf("%4u %-8s %-5s max error %5.2f LSB, SNR %5.1f dB\n",
+            size, window_names[window], signal, max_err, snr);
+
+    snprintf(name, sizeof(name), "accuracy %u %s %s", size, window_names[window], signal);
+    check(name, max_err <= MAX_ERROR && snr >= MIN_SNR);
+}
+
+
+/* A half scale sine wave placed exactly on a bin should be reported at -6.02 dB
+ * with every window */
+static void test_level(unsigned int size, fft_window_t window)
+{
+    static uint32_t power[FFT_MAX_SIZE / 2];
+    unsigned int bin = size / 8;
+    double level;
+    char name[64];
+
+    for (unsigned int i = 0; i < size; ++i)
+        data[i] = lround(16384 * sin(2 * M_PI * bin * i / size));
+
+    fft_window(data, size, window);
+    fft_real(data, size);
+    fft_power(data, power, size / 2, 0);
+    level = (double) fft_power_db(power[bin], window) / FFT_DB_SCALE;
+
+    snprintf(name, sizeof(name), "level %u %s (%.2f dB)", size, window_names[window], level);
+    check(name, fabs(level - 20 * log10(0.5)) <= MAX_DB_ERROR);
+}
+
+
+static void test_sin(void)
+{
+    int max_err = 0;
+
+    for (uint32_t i = 0; i < 4096; ++i) {
+        uint32_t phase = i * 1048573u;      /* odd step, covers all quadrants */
+        int expected = lround(32767 * sin(2 * M_PI * phase / 4294967296.0));
+        int err = abs(fft_sin_q15(phase) - expected);
+
+        if (err > max_err)
+            max_err = err;
+    }
+
+    printf("fft_sin_q15 max error %d LSB\n", max_err);
+    check("fft_sin_q15", max_err <= 2);
+}
+
+
+int main(void)
+{
+    static int16_t sine[FFT_MAX_SIZE], noise[FFT_MAX_SIZE];
+    uint32_t seed = 1;
+
+    for (unsigned int size = 256; size <= FFT_MAX_SIZE; size *= 2) {
+        for (unsigned int i = 0; i < size; ++i) {
+            /* 0.9 of the full scale, between bins */
+            sine[i] = lround(0.9 * 32767 * sin(2 * M_PI * 37.3 * i / size));
+
+            seed = seed * 1103515245 + 12345;
+            noise[i] = seed >> 16;
+        }
+
+        for (int window = FFT_WINDOW_RECT; window <= FFT_WINDOW_BLACKMAN; ++window) {
+            test_accuracy("sine", sine, size, window);
+            test_accuracy("noise", noise, size, window);
+            test_level(size, window);
+        }
+    }
+
+    test_sin();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Q15 filters (filter.c) against double precision reference filters.
+ */
+
+#include "filter.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLES         4096
+#define BLOCK           256
+
+/* Limits for the output error against the reference filters [LSB] */
+#define LP_MAX_ERROR    3.0
+#define HP_MAX_ERROR    8.0
+#define HP_RMS_ERROR    1.5
+/* Notch: rejection at the notch frequency and gain error elsewhere [dB] */
+#define NOTCH_MIN_ATTEN 40.0
+#define NOTCH_MAX_GAIN  0.1
+
+static filter_t filter;
+static int16_t data[SAMPLES] __attribute__((aligned(4)));
+static int16_t input[SAMPLES];
+static double ref[SAMPLES];
+static int failures;
+
+
+static void check(const char *name, int ok)
+{
+    if (!ok) {
+        printf("FAIL: %s\n", name);
+        ++failures;
+    }
+}
+
+
+/* Filters the input with the tested filter, in blocks of the given size */
+static int run(filter_type_t type, uint32_t fsampling, unsigned int block)
+{
+    if (!filter_init(&filter, type, fsampling))
+        return 0;
+
+    memcpy(data, input, sizeof(data));
+
+    for (unsigned int i = 0; i < SAMPLES; i += block)
+        filter_process(&filter, &data[i], block);
+
+    return 1;
+}
+
+
+/* Direct form biquad in double precision */
+static void reference_biquad(const double b[3], const double a[3])
+{
+    double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+    for (unsigned int i = 0; i < SAMPLES; ++i) {
+        double y = b[0] * input[i] + b[1] * x1 + b[2] * x2 - a[1] * y1 - a[2] * y2;
+
+        x2 = x1;
+        x1 = input[i];
+        y2 = y1;
+        y1 = y;
+        ref[i] = y;
+    }
+}
+
+
+static void compare(const char *name, double max_limit, double rms_limit)
+{
+    double max_err = 0, err_power = 0, rms;
+
+    for (unsigned int i = 0; i < SAMPLES; ++i) {
+        double err = fabs(data[i] - ref[i]);
+
+        if (err > max_err)
+            max_err = err;
+
+        err_power += err * err;
+    }
+
+    rms = sqrt(err_power / SAMPLES);
+    printf("%-9s max error %5.2f LSB, rms error %4.2f LSB\n", name, max_err, rms);
+    check(name, max_err <= max_limit && rms <= rms_limit);
+}
+
+
+static void make_noise(void)
+{
+    uint32_t seed = 1;
+
+    /* sum of uniform values (~3000 rms), leaves room for the biquad gain */
+    for (unsigned int i = 0; i < SAMPLES; ++i) {
+        int32_t sum = 0;
+
+        for (int j = 0; j < 4; ++j) {
+            seed = seed * 1103515245 + 12345;
+            sum += (int32_t) (seed >> 16) - 32768;
+        }
+
+        input[i] = sum / 22;
+    }
+}
+
+
+/* Hamming windowed sinc, cut-off at 0.1 fs, normalized to unity DC gain */
+static void test_lowpass(void)
+{
+    double h[FILTER_FIR_TAPS], sum = 0;
+
+    for (int i = 0; i < FILTER_FIR_TAPS; ++i) {
+        double n = i - (FILTER_FIR_TAPS - 1) / 2.0;
+        double sinc = 0.2 * sin(M_PI * 0.2 * n) / (M_PI * 0.2 * n);
+
+        h[i] = sinc * (0.54 - 0.46 * cos(2 * M_PI * i / (FILTER_FIR_TAPS - 1)));
+        sum += h[i];
+    }
+
+    for (unsigned int n = 0; n < SAMPLES; ++n) {
+        ref[n] = 0;
+
+        for (int i = 0; i < FILTER_FIR_TAPS && i <= (int) n; ++i)
+            ref[n] += h[i] / sum * input[n - i];
+    }
+
+    run(FILTER_LOWPASS, 1000000, BLOCK);
+    compare("low-pass", LP_MAX_ERROR, LP_MAX_ERROR);
+}
+
+
+/* 2nd order Butterworth, cut-off at 0.01 fs (bilinear transform) */
+static void test_highpass(void)
+{
+    double w = tan(M_PI * 0.01), k = w * w, a0 = 1 + sqrt(2) * w + k;
+    double b[3] = { 1 / a0, -2 / a0, 1 / a0 };
+    double a[3] = { 1, 2 * (k - 1) / a0, (1 - sqrt(2) * w + k) / a0 };
+
+    reference_biquad(b, a);
+    run(FILTER_HIGHPASS, 1000000, BLOCK);
+    compare("high-pass", HP_MAX_ERROR, HP_RMS_ERROR);
+}
+
+
+/* Amplitude of a frequency in the second half of the output (settled) */
+static double amplitude(double freq, uint32_t fsampling)
+{
+    double re = 0, im = 0;
+
+    for (unsigned int i = SAMPLES / 2; i < SAMPLES; ++i) {
+        double phase = 2 * M_PI * freq * i / fsampling;
+
+        re += data[i] * cos(phase);
+        im -= data[i] * sin(phase);
+    }
+
+    return 2 * sqrt(re * re + im * im) / (SAMPLES / 2);
+}
+
+
+/* The notch frequency is removed, other frequencies pass unchanged */
+static void test_notch(filter_type_t type, uint32_t fsampling)
+{
+    double f0 = (type == FILTER_NOTCH_50HZ ? 50 : 60), f1 = 3.3 * f0;
+    double atten, gain;
+    char name[64];
+
+    for (unsigned int i = 0; i < SAMPLES; ++i) {
+        input[i] = lround(8000 * sin(2 * M_PI * f0 * i / fsampling)
+                + 4000 * sin(2 * M_PI * f1 * i / fsampling));
+    }
+
+    snprintf(name, sizeof(name), "notch %.0f Hz at %u Hz", f0, fsampling);
+
+    if (!run(type, fsampling, BLOCK)) {
+        check(name, 0);
+        return;
+    }
+
+    atten = -20 * log10(amplitude(f0, fsampling) / 8000);
+    gain = 20 * log10(amplitude(f1, fsampling) / 4000);
+    printf("%-22s rejection %4.1f dB, gain error %5.2f dB\n", name, atten, gain);
+    check(name, atten >= NOTCH_MIN_ATTEN && fabs(gain) <= NOTCH_MAX_GAIN);
+}
+
+
+/* Coefficients are too coarse at higher sampling frequencies */
+static void test_notch_rate(void)
+{
+    int ok = filter_init(&filter, FILTER_NOTCH_50HZ, FILTER_NOTCH_MAX_RATE + 1);
+
+    check("notch rejected above FILTER_NOTCH_MAX_RATE",
+            !ok && filter.type == FILTER_NONE);
+    check("notch rejected at 0 Hz", !filter_init(&filter, FILTER_NOTCH_60HZ, 0));
+}
+
+
+/* The output must not depend on how the stream is split into blocks */
+static void test_blocks(filter_type_t type, const char *name)
+{
+    static int16_t whole[SAMPLES];
+
+    make_noise();
+    run(type, FILTER_NOTCH_MAX_RATE, FILTER_MAX_BLOCK);
+    memcpy(whole, data, sizeof(whole));
+    run(type, FILTER_NOTCH_MAX_RATE, 2);
+
+    check(name, memcmp(whole, data, sizeof(whole)) == 0);
+}
+
+
+int main(void)
+{
+    make_noise();
+    test_lowpass();
+    test_highpass();
+
+    for (uint32_t fsampling = 500; fsampling <= FILTER_NOTCH_MAX_RATE; fsampling *= 2) {
+        test_notch(FILTER_NOTCH_50HZ, fsampling);
+        test_notch(FILTER_NOTCH_60HZ, fsampling);
+    }
+
+    test_notch_rate();
+
+    test_blocks(FILTER_LOWPASS, "low-pass blocks");
+    test_blocks(FILTER_HIGHPASS, "high-pass blocks");
+    test_blocks(FILTER_NOTCH_50HZ, "notch blocks");
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
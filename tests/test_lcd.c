@@ -0,0 +1,589 @@
+/*
+ * Copyright (c) 2019 Maciej Suminski <orson@orson.net.pl>
+ *
+ * This source code is free software; you can redistribute it
+ * and/or modify it in source code form under the terms of the GNU
+ * General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Pixel exact tests of the display drawing primitives (lcd.c).
+ *
+ * Every scene is drawn to the buffer and presented on an emulated display
+ * controller, whose memory is compared with a golden image (golden/, PBM).
+ * The scenes are presented with partial refreshes one after another, so the
+ * dirty area tracking is checked as well. Run "test_lcd -w" to rewrite the
+ * golden images after an intended change and review them before committing.
+ *
+ * "test_lcd -b" compares the speed of the primitives with drawing the same
+ * shapes pixel by pixel, as the former implementations did.
+ */
+
+#include "lcd.h"
+#include "gfx.h"
+#include "i2c.h"
+#include "command_handlers.h"
+#include "SSD1306_commands.h"
+
+#include <sysclk.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef LCD_SH1106
+#define PANEL_WIDTH     132
+#define PANEL_OFFSET    2
+#else
+#define PANEL_WIDTH     128
+#define PANEL_OFFSET    0
+#endif
+
+/* 6x8 font, defined in fonts.h included by lcd.c */
+extern const uint8_t SSD1306_font6x8[];
+
+DWT_Type tests_dwt;
+CoreDebug_Type tests_core_debug;
+
+static int failures;
+static int write_golden;
+
+/* data of the last command response */
+static uint8_t resp[LCD_WIDTH];
+static unsigned int resp_len;
+
+
+/* Emulated display controller memory and addressing */
+static struct {
+    uint8_t ram[LCD_PAGES][PANEL_WIDTH];
+    int mode;               /* 0 horizontal, 1 vertical, 2 page addressing */
+    int page, column;
+    int col_start, col_end, page_start, page_end;
+    int cmd, args_left, argc;
+    uint8_t args[6];
+} panel = { .mode = 2, .col_end = PANEL_WIDTH - 1, .page_end = LCD_PAGES - 1 };
+
+
+static void panel_command(uint8_t cmd)
+{
+    if (panel.args_left) {
+        panel.args[panel.argc++] = cmd;
+
+        if (--panel.args_left)
+            return;
+
+        switch (panel.cmd) {
+            case SSD1306_MEMORYMODE:
+                panel.mode = panel.args[0];
+                break;
+
+            case SSD1306_COLUMNADDR:
+                panel.col_start = panel.column = panel.args[0];
+                panel.col_end = panel.args[1];
+                break;
+
+            case SSD1306_PAGEADDR:
+                panel.page_start = panel.page = panel.args[0];
+                panel.page_end = panel.args[1];
+                break;
+        }
+
+        return;
+    }
+
+    panel.cmd = cmd;
+    panel.argc = 0;
+
+    if (cmd <= 0x0f)
+        panel.column = (panel.column & 0xf0) | cmd;
+    else if (cmd <= 0x1f)
+        panel.column = (panel.column & 0x0f) | ((cmd & 0x0f) << 4);
+    else if (cmd >= 0xb0 && cmd <= 0xb7)
+        panel.page = cmd & 0x07;
+    else if (cmd == SSD1306_MEMORYMODE || cmd == SSD1306_SETMULTIPLEX
+            || cmd == SSD1306_SETDISPLAYOFFSET || cmd == SSD1306_SETCOMPINS
+            || cmd == SSD1306_SETCONTRAST || cmd == SSD1306_SETDISPLAYCLOCKDIV
+            || cmd == SSD1306_CHARGEPUMP || cmd == SSD1306_SETPRECHARGE
+            || cmd == SSD1306_SETVCOMDETECT)
+        panel.args_left = 1;
+    else if (cmd == SSD1306_COLUMNADDR || cmd == SSD1306_PAGEADDR)
+        panel.args_left = 2;
+    else if (cmd == SSD1306_LEFT_HORIZONTAL_SCROLL || cmd == SSD1306_RIGHT_HORIZONTAL_SCROLL)
+        panel.args_left = 6;
+}
+
+
+static void panel_data(uint8_t data)
+{
+    if (panel.column < PANEL_WIDTH)
+        panel.ram[panel.page][panel.column] = data;
+
+    if (panel.mode == 2) {
+        ++panel.column;
+    } else if (panel.mode == 0) {
+        if (panel.column++ == panel.col_end) {
+            panel.column = panel.col_start;
+            panel.page = (panel.page == panel.page_end) ? panel.page_start : panel.page + 1;
+        }
+    } else {
+        if (panel.page++ == panel.page_end) {
+            panel.page = panel.page_start;
+            panel.column = (panel.column == panel.col_end) ? panel.col_start : panel.column + 1;
+        }
+    }
+}
+
+
+/* Control byte: bit 7 - a single byte follows, then another control byte,
+ * bit 6 - data (otherwise commands) */
+static void panel_transaction(const twi_xfer_t *xfer)
+{
+    const uint8_t *parts[3] = { xfer->addr, xfer->prefix, xfer->buffer };
+    const int lengths[3] = { xfer->addr_length, xfer->prefix_length, xfer->length };
+    int control = 0, expect_control = 1;
+
+    for (int part = 0; part < 3; part++) {
+        for (int i = 0; i < lengths[part]; i++) {
+            uint8_t byte = parts[part][i];
+
+            if (expect_control) {
+                control = byte;
+                expect_control = 0;
+                continue;
+            }
+
+            if (control & 0x40)
+                panel_data(byte);
+            else
+                panel_command(byte);
+
+            expect_control = (control & 0x80);
+        }
+    }
+}
+
+
+void twi_init(void)
+{
+}
+
+
+uint32_t twi_submit(twi_xfer_t *xfer)
+{
+    panel_transaction(xfer);
+    xfer->status = TWI_SUCCESS;
+
+    if (xfer->done)
+        xfer->done(xfer);
+
+    return TWI_SUCCESS;
+}
+
+
+uint32_t twi_transfer(twi_xfer_t *xfer)
+{
+    xfer->done = NULL;
+    return twi_submit(xfer);
+}
+
+
+void cmd_resp_init(cmd_resp_t status)
+{
+    (void) status;
+    resp_len = 0;
+}
+
+
+void cmd_resp_write(uint8_t data)
+{
+    (void) data;
+}
+
+
+void cmd_resp_writen(const uint8_t *data, unsigned int len)
+{
+    if (len > sizeof(resp) - resp_len)
+        len = sizeof(resp) - resp_len;
+
+    memcpy(&resp[resp_len], data, len);
+    resp_len += len;
+}
+
+
+void cmd_resp_write_u32(uint32_t data)
+{
+    (void) data;
+}
+
+
+static int panel_pixel(int x, int y)
+{
+    return (panel.ram[y / 8][x + PANEL_OFFSET] >> (y % 8)) & 1;
+}
+
+
+/* Plain PBM: "P1", width and height, then 0/1 for every pixel */
+static int golden_read(const char *path, uint8_t image[LCD_HEIGHT][LCD_WIDTH])
+{
+    FILE *file = fopen(path, "r");
+    int width, height, ok;
+
+    if (!file)
+        return 0;
+
+    ok = (fscanf(file, "P1 %d %d", &width, &height) == 2
+            && width == LCD_WIDTH && height == LCD_HEIGHT);
+
+    for (int y = 0; ok && y < LCD_HEIGHT; y++) {
+        for (int x = 0; ok && x < LCD_WIDTH; x++) {
+            int pixel;
+
+            ok = (fscanf(file, " %1d", &pixel) == 1);
+            image[y][x] = pixel;
+        }
+    }
+
+    fclose(file);
+    return ok;
+}
+
+
+static void golden_write(const char *path)
+{
+    FILE *file = fopen(path, "w");
+
+    if (!file) {
+        printf("cannot write %s\n", path);
+        ++failures;
+        return;
+    }
+
+    fprintf(file, "P1\n%d %d\n", LCD_WIDTH, LCD_HEIGHT);
+
+    for (int y = 0; y < LCD_HEIGHT; y++) {
+        for (int x = 0; x < LCD_WIDTH; x++)
+            fputc('0' + panel_pixel(x, y), file);
+
+        fputc('\n', file);
+    }
+
+    fclose(file);
+}
+
+
+/* Presents the buffer and compares the display with the golden image */
+static void check_scene(const char *name)
+{
+    static uint8_t golden[LCD_HEIGHT][LCD_WIDTH];
+    char path[64];
+    int diff = 0;
+
+    SSD1306_drawBufferDMA();
+
+    if (SSD1306_isBusy()) {
+        printf("FAIL: %s: transfer not finished\n", name);
+        ++failures;
+    }
+
+    snprintf(path, sizeof(path), "golden/%s.pbm", name);
+
+    if (write_golden) {
+        golden_write(path);
+        return;
+    }
+
+    if (!golden_read(path, golden)) {
+        printf("FAIL: %s: cannot read %s\n", name, path);
+        ++failures;
+        return;
+    }
+
+    for (int y = 0; y < LCD_HEIGHT; y++) {
+        for (int x = 0; x < LCD_WIDTH; x++) {
+            if (panel_pixel(x, y) != golden[y][x]) {
+                if (!diff)
+                    printf("FAIL: %s: first difference at %d,%d\n", name, x, y);
+
+                ++diff;
+            }
+        }
+    }
+
+    printf("%-8s %s", name, diff ? "" : "ok\n");
+
+    if (diff) {
+        printf("%d pixels differ\n", diff);
+        ++failures;
+    }
+}
+
+
+/* All slopes in both directions, lines crossing pages and the edges */
+static void scene_lines(void)
+{
+    SSD1306_clearBufferFull();
+
+    for (int i = 0; i < LCD_WIDTH; i += 9) {
+        SSD1306_setLine(63, 31, i, 0, WHITE);
+        SSD1306_setLine(i, LCD_HEIGHT - 1, 63, 31, WHITE);
+    }
+
+    for (int i = 0; i < LCD_HEIGHT; i += 7) {
+        SSD1306_setLine(0, i, 63, 31, WHITE);
+        SSD1306_setLine(63, 31, LCD_WIDTH - 1, i, WHITE);
+    }
+
+    SSD1306_setLine(0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1, INVERSE);
+    SSD1306_setLine(0, LCD_HEIGHT - 1, LCD_WIDTH - 1, 0, INVERSE);
+    SSD1306_setLine(10, 31, 117, 31, BLACK);
+    SSD1306_setLine(63, 5, 63, 58, BLACK);
+}
+
+
+/* Spans starting and ending at every bit of a page */
+static void scene_spans(void)
+{
+    SSD1306_clearBufferFull();
+
+    for (int i = 0; i < 16; i++) {
+        SSD1306_setVLine(2 + 3 * i, i, 17 + 3 * i, WHITE);
+        SSD1306_setVLine(50 + 2 * i, 62 - 3 * i, 40 - i, WHITE);
+    }
+
+    for (int i = 0; i < 20; i++)
+        SSD1306_setHLine(84 + i, 127 - i, 3 * i, WHITE);
+
+    SSD1306_fillRect(84, 20, 44, 20, WHITE);
+    SSD1306_setHLine(80, 127, 30, BLACK);
+    SSD1306_setVLine(106, 0, 63, INVERSE);
+    SSD1306_setVLine(0, 63, 0, INVERSE);
+    SSD1306_setHLine(127, 0, 63, INVERSE);
+}
+
+
+/* Outlines and fills, clipped at the edges and inverted over each other */
+static void scene_rects(void)
+{
+    SSD1306_clearBufferFull();
+
+    for (int i = 0; i < 6; i++)
+        SSD1306_setRect(2 * i, 3 * i, 60 - 4 * i, 58 - 6 * i, WHITE);
+
+    SSD1306_fillRect(20, 19, 17, 13, WHITE);
+    SSD1306_fillRect(26, 22, 30, 30, INVERSE);
+    SSD1306_setRect(26, 22, 30, 30, INVERSE);
+
+    SSD1306_fillRect(70, 5, 40, 40, WHITE);
+    SSD1306_fillRect(75, 9, 30, 3, BLACK);
+    SSD1306_setRect(80, 15, 20, 20, BLACK);
+    SSD1306_setRect(85, 20, 1, 10, BLACK);
+    SSD1306_setRect(90, 24, 10, 1, BLACK);
+
+    SSD1306_fillRect(118, 50, 30, 30, INVERSE);
+    SSD1306_setRect(100, 55, 40, 20, WHITE);
+    SSD1306_fillRect(64, 60, 0, 4, WHITE);
+}
+
+
+/* 6x8 font at every vertical offset, proportional fonts */
+static void scene_text(void)
+{
+    SSD1306_clearBufferFull();
+    SSD1306_fillRect(0, 0, 64, 64, WHITE);
+
+    for (int i = 0; i < 8; i++) {
+        char text[8];
+        int len = sprintf(text, "y+%d", i);
+
+        SSD1306_setText(3 + (i % 2) * 30, 4 + 7 * i + i % 8, text, len,
+                (i & 2) ? WHITE : BLACK);
+    }
+
+    SSD1306_setString(70, 0, "page 0", 6, WHITE);
+    SSD1306_setString(100, 1, "clipped", 7, BLACK);
+    SSD1306_setTextFont(66, 13, "Sans 16", 7, &sans16, WHITE);
+    SSD1306_setTextFont(66, 33, "AV Ty 8", 7, &sans8, WHITE);
+    SSD1306_setTextFont(66, 42, "42", 2, &digits24, INVERSE);
+}
+
+
+/* Bitmaps aligned to pages, shifted and clipped */
+static void scene_blit(void)
+{
+    static uint8_t pattern[3 * 24];
+
+    for (unsigned int i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (i * 37) ^ (i >> 2);
+
+    SSD1306_clearBufferFull();
+    SSD1306_drawImage(0, 0, &kicon_logo);
+    SSD1306_blit(0, 32, pattern, 24, 24);
+    SSD1306_blit(30, 35, pattern, 24, 20);
+    SSD1306_blit(60, 40, pattern, 24, 9);
+    SSD1306_blit(115, 45, pattern, 24, 24);
+    SSD1306_blit(90, 61, pattern, 24, 5);
+}
+
+
+static void scene_image(void)
+{
+    SSD1306_clearBufferFull();
+    SSD1306_drawImage(16, 0, &gfx_test);
+    SSD1306_drawImage(100, 3, &gfx_test);
+}
+
+
+/* The frame rate overlay is shown on the panel only: the buffer read by
+ * the host keeps the drawn contents and hiding the overlay restores them */
+static void test_overlay(void)
+{
+    const uint8_t show[2] = { CMD_LCD_STATS, CMD_LCD_STATS_OVERLAY };
+    const uint8_t hide[2] = { CMD_LCD_STATS, 0 };
+    const uint8_t read[2] = { CMD_LCD_READ, 0 };
+    uint8_t page[LCD_WIDTH];
+
+    scene_text();
+    SSD1306_drawBufferDMA();
+    cmd_lcd(read, sizeof(read));
+    memcpy(page, resp, sizeof(page));
+
+    cmd_lcd(show, sizeof(show));
+    SSD1306_drawBufferDMA();
+
+    if (memcmp(page, &panel.ram[0][PANEL_OFFSET], sizeof(page)) == 0) {
+        printf("FAIL: overlay: not shown\n");
+        ++failures;
+    }
+
+    cmd_lcd(read, sizeof(read));
+
+    if (resp_len != sizeof(page) || memcmp(page, resp, sizeof(page)) != 0) {
+        printf("FAIL: overlay: drawn in the buffer\n");
+        ++failures;
+    }
+
+    cmd_lcd(hide, sizeof(hide));
+    check_scene("text");
+}
+
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+#define BENCH(name, reps, pixels, primitive) do {                           \
+        double start = bench_now(), per_pixel, fast;                        \
+        for (int rep = 0; rep < (reps); rep++) { pixels; }                  \
+        per_pixel = (bench_now() - start) / (reps);                         \
+        start = bench_now();                                                \
+        for (int rep = 0; rep < (reps); rep++) { primitive; }               \
+        fast = (bench_now() - start) / (reps);                              \
+        printf("%-26s %9.1f ns %9.1f ns %6.1fx\n", name, per_pixel, fast,    \
+                per_pixel / fast);                                          \
+    } while (0)
+
+
+static void bench(void)
+{
+    static uint8_t bitmap[LCD_WIDTH * 4];
+    const char *text = "Vpp 3.30V Avg 1.65V";
+    const int len = strlen(text);
+
+    for (unsigned int i = 0; i < sizeof(bitmap); i++)
+        bitmap[i] = i * 37;
+
+    printf("%-26s %12s %12s %7s\n", "", "per pixel", "primitive", "speedup");
+
+    BENCH("vertical line 64 px", 100000,
+        for (int y = 0; y < LCD_HEIGHT; y++)
+            SSD1306_setPixel(rep & 0x7f, y, WHITE),
+        SSD1306_setVLine(rep & 0x7f, 0, LCD_HEIGHT - 1, WHITE));
+
+    BENCH("horizontal line 128 px", 100000,
+        for (int x = 0; x < LCD_WIDTH; x++)
+            SSD1306_setPixel(x, rep & 0x3f, WHITE),
+        SSD1306_setHLine(0, LCD_WIDTH - 1, rep & 0x3f, WHITE));
+
+    BENCH("line 128x64", 100000,
+        for (int x = 0; x < LCD_WIDTH; x++)
+            SSD1306_setPixel(x, x / 2, WHITE),
+        SSD1306_setLine(0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1, WHITE));
+
+    BENCH("filled rectangle 64x32", 10000,
+        for (int y = 13; y < 45; y++)
+            for (int x = 32; x < 96; x++)
+                SSD1306_setPixel(x, y, WHITE),
+        SSD1306_fillRect(32, 13, 64, 32, WHITE));
+
+    BENCH("bitmap 128x32 (aligned)", 10000,
+        for (int y = 0; y < 32; y++)
+            for (int x = 0; x < LCD_WIDTH; x++)
+                SSD1306_setPixel(x, y, (bitmap[(y / 8) * LCD_WIDTH + x] >> (y % 8)) & 1),
+        SSD1306_blit(0, 0, bitmap, LCD_WIDTH, 32));
+
+    BENCH("bitmap 128x32 (y + 3)", 10000,
+        for (int y = 0; y < 32; y++)
+            for (int x = 0; x < LCD_WIDTH; x++)
+                SSD1306_setPixel(x, y + 3, (bitmap[(y / 8) * LCD_WIDTH + x] >> (y % 8)) & 1),
+        SSD1306_blit(0, 3, bitmap, LCD_WIDTH, 32));
+
+    BENCH("text 19 chars (y + 3)", 10000,
+        for (int i = 0; i < len; i++)
+            for (int col = 0; col < 6; col++)
+                for (int y = 0; y < 8; y++)
+                    SSD1306_setPixel(6 * i + col, 3 + y,
+                            (SSD1306_font6x8[(text[i] - ' ') * 6 + col] >> y) & 1),
+        SSD1306_setText(0, 3, text, len, WHITE));
+}
+
+
+int main(int argc, char *argv[])
+{
+    write_golden = (argc > 1 && strcmp(argv[1], "-w") == 0);
+
+    SSD1306_init();
+
+    if (argc > 1 && strcmp(argv[1], "-b") == 0) {
+        bench();
+        return 0;
+    }
+
+    scene_lines();
+    check_scene("lines");
+    scene_spans();
+    check_scene("spans");
+    scene_rects();
+    check_scene("rects");
+    scene_text();
+    check_scene("text");
+    scene_blit();
+    check_scene("blit");
+    scene_image();
+    check_scene("image");
+
+    /* the partial refreshes must result in the same image as a full one */
+    scene_lines();
+    SSD1306_drawBuffer();
+    check_scene("lines");
+
+    test_overlay();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}